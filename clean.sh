@@ -9,6 +9,12 @@ echo "rm -f $OUTPUT/AutoBSP.log"
 rm -f $OUTPUT/AutoBSP.log
 echo ""
 
+# Delete the regeneration cache (AutoBSP.cache) if it exists
+echo "Deleting AutoBSP.cache..."
+echo "rm -f $OUTPUT/AutoBSP.cache"
+rm -f $OUTPUT/AutoBSP.cache
+echo ""
+
 # Execute 'make clean' in ./generator
 echo "Running 'make clean' in ./generator..."
 make -C ./generator clean
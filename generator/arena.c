@@ -0,0 +1,200 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "logging.h"
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT          (_Alignof(max_align_t))
+
+static arena_block_t* arena_new_block(arena_t *arena, size_t min_size);
+
+
+/* -------------------------------------------- */
+/*          Initialization and release          */
+/* -------------------------------------------- */
+
+/**
+ * @brief Initializes an empty arena.
+ * 
+ * @param arena Pointer to the arena.
+ * @param block_size Default size of the blocks (0 = default of 64 KiB). Larger allocations get their own block.
+ * 
+ * @note No memory is allocated until the first allocation.
+ */
+void arena_init(arena_t *arena, size_t block_size){
+  if(arena == NULL)
+    log_error("arena_init", 0, "Arena is NULL.");
+  
+  arena->blocks              = NULL;
+  arena->block_size          = (block_size == 0) ? ARENA_DEFAULT_BLOCK_SIZE : block_size;
+  arena->allocation_count    = 0;
+  arena->bytes_allocated     = 0;
+  arena->bytes_reserved      = 0;
+  arena->peak_bytes_reserved = 0;
+  arena->block_count         = 0;
+}
+
+/**
+ * @brief Releases all memory handed out by the arena at once.
+ * 
+ * @param arena Pointer to the arena.
+ * 
+ * @note Keeps the first (default sized) block for reuse, all other blocks are freed.
+ * @note All pointers returned by the arena before the reset become invalid.
+ */
+void arena_reset(arena_t *arena){
+  if(arena == NULL)
+    log_error("arena_reset", 0, "Arena is NULL.");
+  
+  arena_block_t *keep = NULL;
+  arena_block_t *block = arena->blocks;
+  while(block != NULL){
+    arena_block_t *next = block->next;
+    if(keep == NULL && block->size == arena->block_size){
+      keep = block;
+    } else{
+      arena->bytes_reserved -= block->size;
+      arena->block_count--;
+      free(block);
+    }
+    block = next;
+  }
+  
+  if(keep != NULL){
+    keep->next = NULL;
+    keep->used = 0;
+  }
+  arena->blocks = keep;
+}
+
+/**
+ * @brief Frees all blocks of the arena.
+ * 
+ * @param arena Pointer to the arena.
+ * 
+ * @note The arena can be used again afterwards (like after arena_init, but the statistics are kept).
+ */
+void arena_free(arena_t *arena){
+  if(arena == NULL)
+    return;
+  
+  arena_block_t *block = arena->blocks;
+  while(block != NULL){
+    arena_block_t *next = block->next;
+    free(block);
+    block = next;
+  }
+  
+  arena->blocks         = NULL;
+  arena->bytes_reserved = 0;
+  arena->block_count    = 0;
+}
+
+
+/* -------------------------------------------- */
+/*                  Allocation                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Allocates zero initialized memory from the arena.
+ * 
+ * @param arena Pointer to the arena.
+ * @param size Number of bytes to allocate.
+ * @return Pointer to the memory, aligned for any type.
+ * 
+ * @note Logs an error and exits if no memory could be allocated.
+ * @note The memory is released only by arena_reset() or arena_free().
+ */
+void* arena_alloc(arena_t *arena, size_t size){
+  if(arena == NULL)
+    log_error("arena_alloc", 0, "Arena is NULL.");
+  
+  // Round up, so the next allocation is aligned as well
+  size_t aligned_size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+  if(aligned_size < size)
+    log_error("arena_alloc", 0, "Allocation of %zu bytes is too large.", size);
+  
+  arena_block_t *block = arena->blocks;
+  if(block == NULL || block->size - block->used < aligned_size)
+    block = arena_new_block(arena, aligned_size);
+  
+  void *memory = block->data + block->used;
+  block->used += aligned_size;
+  memset(memory, 0, aligned_size);
+  
+  arena->allocation_count++;
+  arena->bytes_allocated += size;
+  return memory;
+}
+
+/**
+ * @brief Duplicates a string into the arena.
+ * 
+ * @param arena Pointer to the arena.
+ * @param string String to duplicate.
+ * @return Pointer to the copy in the arena.
+ */
+char* arena_strdup(arena_t *arena, const char *string){
+  if(string == NULL)
+    log_error("arena_strdup", 0, "String is NULL.");
+  
+  return arena_strndup(arena, string, strlen(string));
+}
+
+/**
+ * @brief Duplicates the first length characters of a string into the arena and null-terminates the copy.
+ * 
+ * @param arena Pointer to the arena.
+ * @param string String to duplicate (does not need to be null-terminated).
+ * @param length Number of characters to copy.
+ * @return Pointer to the copy in the arena.
+ */
+char* arena_strndup(arena_t *arena, const char *string, size_t length){
+  if(string == NULL)
+    log_error("arena_strndup", 0, "String is NULL.");
+  
+  char *copy = (char*)arena_alloc(arena, length + 1);
+  memcpy(copy, string, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+/**
+ * @brief Allocates a new block that can hold at least min_size bytes and puts it in front of the block list.
+ * 
+ * @param arena Pointer to the arena.
+ * @param min_size Minimal number of usable bytes.
+ * @return Pointer to the new block.
+ * 
+ * @note Allocations larger than the default block size get a block of their own, which is put behind the current
+ *       block, so the free space of the current block can still be used.
+ */
+static arena_block_t* arena_new_block(arena_t *arena, size_t min_size){
+  size_t size = (min_size > arena->block_size) ? min_size : arena->block_size;
+  if(size > SIZE_MAX - sizeof(arena_block_t))
+    log_error("arena_new_block", 0, "Arena block of %zu bytes is too large.", size);
+  
+  arena_block_t *block = (arena_block_t*)malloc(sizeof(arena_block_t) + size);
+  if(block == NULL)
+    log_error("arena_new_block", 0, "Could not allocate memory for arena block of %zu bytes.", size);
+  
+  block->size = size;
+  block->used = 0;
+  
+  if(size > arena->block_size && arena->blocks != NULL){
+    block->next = arena->blocks->next;
+    arena->blocks->next = block;
+  } else{
+    block->next = arena->blocks;
+    arena->blocks = block;
+  }
+  
+  arena->block_count++;
+  arena->bytes_reserved += size;
+  if(arena->bytes_reserved > arena->peak_bytes_reserved)
+    arena->peak_bytes_reserved = arena->bytes_reserved;
+  return block;
+}
@@ -0,0 +1,41 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+
+/**
+ * @brief Block of memory of an arena, blocks are chained in a singly linked list.
+ */
+typedef struct arena_block_s{
+  struct arena_block_s *next;
+  size_t size;               // Usable bytes in data
+  size_t used;               // Bytes already handed out
+  _Alignas(max_align_t) unsigned char data[];
+} arena_block_t;
+
+/**
+ * @brief Region allocator: hands out memory from large blocks and releases everything at once.
+ * 
+ * Consists of the list of blocks (newest first), the default block size, and statistics about the allocations.
+ */
+typedef struct{
+  arena_block_t *blocks;
+  size_t block_size;
+  
+  /* statistics (since initialization, not cleared by reset) */
+  size_t allocation_count;   // Number of arena_alloc() calls
+  size_t bytes_allocated;    // Sum of all requested bytes
+  size_t bytes_reserved;     // Current size of all blocks (without headers)
+  size_t peak_bytes_reserved;
+  size_t block_count;        // Current number of blocks
+} arena_t;
+
+void arena_init(arena_t *arena, size_t block_size);
+void arena_reset(arena_t *arena);
+void arena_free(arena_t *arena);
+
+void* arena_alloc(arena_t *arena, size_t size);
+char* arena_strdup(arena_t *arena, const char *string);
+char* arena_strndup(arena_t *arena, const char *string, size_t length);
+
+#endif //__ARENA_H__
@@ -7,8 +7,6 @@
 #include "astCheck.h"
 #include "astEnums2Str.h"
 
-unsigned int global_ast_node_counter = 0;
-
 static void ast_dsl_node_append_module_node(ast_dsl_node_t* dsl_node, ast_module_node_t* module_node);
 
 static void ast_initialize_module(ast_module_node_t* module);
@@ -21,29 +19,29 @@ static void ast_initialize_module(ast_module_node_t* module);
 /**
  * @brief Creates a new AST DSL builder and initializes its fields.
  * 
+ * @param arena Arena of the run the builder is allocated from.
  * @return Pointer to the newly created AST DSL builder.
  */
-ast_dsl_builder_t* ast_new_dsl_builder(){
-  ast_dsl_builder_t* dsl_builder = (ast_dsl_builder_t*)calloc(1, sizeof(ast_dsl_builder_t));
-  if(dsl_builder == NULL)
-    log_error("ast_new_dsl_builder", 0, "Could not allocate memory for new DSL builder.");
+ast_dsl_builder_t* ast_new_dsl_builder(arena_t *arena){
+  ast_dsl_builder_t* dsl_builder = (ast_dsl_builder_t*)arena_alloc(arena, sizeof(ast_dsl_builder_t));
   
   // Explicitly initialize fields
   dsl_builder->controller_set = false;
   dsl_builder->module_builders_root   = NULL;
+  dsl_builder->module_builders_tail   = NULL;
   return dsl_builder;
 }
 
 /**
  * @brief Creates a new AST module builder and initializes its fields.
  * 
+ * @param arena Arena of the run the builder and its module node are allocated from.
  * @param lineNr Line number where the module is defined.
+ * @param node_id Unique ID of the module node (counted by the caller, e.g. per parser context).
  * @return Pointer to the newly created AST module builder.
  */
-ast_module_builder_t* ast_new_module_builder(int line_nr){
-  ast_module_builder_t *module_builder = (ast_module_builder_t*)calloc(1, sizeof(ast_module_builder_t));
-  if(module_builder == NULL)
-    log_error("ast_new_module_builder", 0, "Could not allocate memory for new AST module builder.");
+ast_module_builder_t* ast_new_module_builder(arena_t *arena, int line_nr, unsigned int node_id){
+  ast_module_builder_t *module_builder = (ast_module_builder_t*)arena_alloc(arena, sizeof(ast_module_builder_t));
   
   // Explicitly initialize all fields of builder to default values
   module_builder->name_set         = false;
@@ -65,12 +63,10 @@ ast_module_builder_t* ast_new_module_builder(int line_nr){
   module_builder->next             = NULL;
   
   
-  module_builder->module = (ast_module_node_t*)calloc(1, sizeof(ast_module_node_t));
-  if(module_builder->module == NULL)
-    log_error("ast_new_module_builder", 0, "Could not allocate memory for new AST module node.");
+  module_builder->module = (ast_module_node_t*)arena_alloc(arena, sizeof(ast_module_node_t));
   
   // Explicitly initialize fields of the current module node
-  module_builder->module->node_id = global_ast_node_counter++;
+  module_builder->module->node_id = node_id;
   module_builder->module->line_nr = line_nr;
   module_builder->module->name  = NULL;
   module_builder->module->next  = NULL;
@@ -85,43 +81,39 @@ ast_module_builder_t* ast_new_module_builder(int line_nr){
 /**
  * @brief Converts the AST DSL builder to an AST DSL node and all its modules.
  * 
+ * @param arena Arena of the run the DSL node is allocated from.
  * @param dsl_builder Pointer to the AST DSL builder to convert.
  * @return Pointer to the newly created AST DSL node.
  * 
- * @note Frees the DSL builder and its module builders after conversion.
+ * @note The module nodes are moved from the builders into the DSL node. The builders stay in the arena
+ *       until it is reset, but must not be used anymore.
  */
-ast_dsl_node_t *ast_convert_dsl_builder_to_dsl_node(ast_dsl_builder_t* dsl_builder){
+ast_dsl_node_t *ast_convert_dsl_builder_to_dsl_node(arena_t *arena, ast_dsl_builder_t* dsl_builder){
   if(dsl_builder == NULL)
     log_error("ast_convert_dsl_builder_to_dsl_node", 0, "DSL builder is NULL.");
   
   // Create DSL node
-  ast_dsl_node_t* dsl_node = (ast_dsl_node_t*)calloc(1, sizeof(ast_dsl_node_t));
-  if(dsl_node == NULL)
-    log_error("ast_convert_dsl_builder_to_dsl_node", 0, "Could not allocate memory for DSL node.");
+  ast_dsl_node_t* dsl_node = (ast_dsl_node_t*)arena_alloc(arena, sizeof(ast_dsl_node_t));
   
   // Set DSL node fields from builder
   dsl_node->controller = dsl_builder->controller;
   dsl_node->modules_root = NULL;
+  dsl_node->modules_tail = NULL;
+  dsl_node->modules_indexed = false;
   
-  // Convert each module builder to module node and append to DSL node
-  ast_module_builder_t *current_builder, *next_builder;
-  ast_module_node_t *current_module;
-  
-  current_builder = dsl_builder->module_builders_root;
+  // Move each module node of the builders to the DSL node
+  ast_module_builder_t *current_builder = dsl_builder->module_builders_root;
   while(current_builder != NULL){
-    current_module = current_builder->module;
-    current_builder->module = NULL; // Prevent double free
+    ast_module_node_t *current_module = current_builder->module;
+    current_builder->module = NULL;
     
+    ast_module_builder_t *next_builder = current_builder->next;
     ast_dsl_node_append_module_node(dsl_node, current_module);
-    
-    next_builder = current_builder->next;
-    free(current_builder);
     current_builder = next_builder;
   }
   
-  // Free the DSL builder itself
-  free(dsl_builder);
-  
+  dsl_builder->module_builders_root = NULL;
+  dsl_builder->module_builders_tail = NULL;
   return dsl_node;
 }
 
@@ -132,40 +124,66 @@ static void ast_dsl_node_append_module_node(ast_dsl_node_t* dsl_node, ast_module
     log_error("ast_dsl_node_append_module_node", 0, "Module node is NULL.");
   
   // Append module to the end of the linked list
-  if(dsl_node->modules_root == NULL){
+  module_node->next = NULL;
+  if(dsl_node->modules_root == NULL)
     dsl_node->modules_root = module_node;
-  } else{
-    ast_module_node_t* current = dsl_node->modules_root;
-    while(current->next != NULL){
-      current = current->next;
-    }
-    current->next = module_node;
-  }
+  else
+    dsl_node->modules_tail->next = module_node;
+  dsl_node->modules_tail = module_node;
+  dsl_node->modules_indexed = false;
 }
 
-void ast_free_dsl_node(ast_dsl_node_t* dsl_node){
+/**
+ * @brief Builds the index of the enabled modules of the DSL node used by the code generators.
+ * 
+ * Fills one array with all enabled modules in list order and one array with the enabled modules grouped by kind
+ * (list order within each kind), so the generators iterate only over the modules they need.
+ * 
+ * @param arena Arena of the run the index arrays are allocated from.
+ * @param dsl_node Pointer to the DSL node.
+ * 
+ * @note Has to be called again if the module list is changed or reordered afterwards (e.g. by sorting).
+ * @note Logs an error and exits if an enabled module has an unsupported kind.
+ */
+void ast_index_enabled_modules(arena_t *arena, ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
-    log_error("ast_free_dsl_node", 0, "DSL node is NULL.");
+    log_error("ast_index_enabled_modules", 0, "DSL node is NULL.");
+  
+  // Count enabled modules per kind
+  uint32_t kind_counts[MODULE_KIND_COUNT] = {0};
+  uint32_t enabled_count = 0;
+  for(ast_module_node_t *current = dsl_node->modules_root; current != NULL; current = current->next){
+    if(!current->enable)
+      continue;
+    if((unsigned int)current->kind >= MODULE_KIND_COUNT)
+      log_error("ast_index_enabled_modules", current->line_nr, "Unsupported module kind enum value '%d' for module '%s'", current->kind, current->name);
+    kind_counts[current->kind]++;
+    enabled_count++;
+  }
   
-  // Free all module nodes
-  ast_module_node_t* current_module = dsl_node->modules_root;
-  ast_module_node_t* next_module;
+  // One allocation: all enabled modules followed by the modules grouped by kind
+  ast_module_node_t **items = (ast_module_node_t**)arena_alloc(arena, 2 * (size_t)enabled_count * sizeof(ast_module_node_t*));
   
-  while(current_module != NULL){
-    next_module = current_module->next;
-    
-    // Free module name
-    if(current_module->name != NULL)
-      free(current_module->name);
-    
-    // Free the module node itself
-    free(current_module);
-    
-    current_module = next_module;
+  dsl_node->enabled_modules.items = items;
+  dsl_node->enabled_modules.count = 0;
+  
+  ast_module_node_t **kind_items = items + enabled_count;
+  for(unsigned int kind = 0; kind < MODULE_KIND_COUNT; kind++){
+    dsl_node->enabled_by_kind[kind].items = kind_items;
+    dsl_node->enabled_by_kind[kind].count = 0;
+    kind_items += kind_counts[kind];
   }
   
-  // Free the DSL node itself
-  free(dsl_node);
+  // Fill both arrays in list order
+  for(ast_module_node_t *current = dsl_node->modules_root; current != NULL; current = current->next){
+    if(!current->enable)
+      continue;
+    dsl_node->enabled_modules.items[dsl_node->enabled_modules.count++] = current;
+    ast_module_span_t *kind_span = &dsl_node->enabled_by_kind[current->kind];
+    kind_span->items[kind_span->count++] = current;
+  }
+  
+  dsl_node->modules_indexed = true;
 }
 
 
@@ -211,15 +229,12 @@ void ast_dsl_builder_append_module_builder( int line_nr, ast_dsl_builder_t* dsl_
     log_error("ast_dsl_builder_append_module_builder", line_nr, "Module builder is NULL.");
   
   // Append module builder to the end of the linked list
-  if(dsl_builder->module_builders_root == NULL){
+  module_builder->next = NULL;
+  if(dsl_builder->module_builders_root == NULL)
     dsl_builder->module_builders_root = module_builder;
-  } else{
-    ast_module_builder_t* current = dsl_builder->module_builders_root;
-    while(current->next != NULL){
-      current = current->next;
-    }
-    current->next = module_builder;
-  }
+  else
+    dsl_builder->module_builders_tail->next = module_builder;
+  dsl_builder->module_builders_tail = module_builder;
 }
 
 
@@ -235,9 +250,9 @@ void ast_dsl_builder_append_module_builder( int line_nr, ast_dsl_builder_t* dsl_
  * @param name Name to set for the module.
  * 
  * @note Logs an error and exits if the name has already been set or if any parameter is NULL.
- * @note The name is duplicated to ensure it is stored correctly in the module node.
+ * @note The name is not duplicated, it has to live as long as the AST (e.g. allocated from the arena of the run).
  */
-void ast_module_builder_set_name(int line_nr, ast_module_builder_t* module_builder, const char* name){
+void ast_module_builder_set_name(int line_nr, ast_module_builder_t* module_builder, char* name){
   if(module_builder == NULL)
     log_error("ast_module_builder_set_name", 0, "AST module builder is NULL.");
   if(name == NULL)
@@ -249,9 +264,7 @@ void ast_module_builder_set_name(int line_nr, ast_module_builder_t* module_build
               name,
               module_builder->module->name == NULL ? "<NULL>" : module_builder->module->name);
   
-  module_builder->module->name = strdup(name);
-  if(module_builder->module->name == NULL)
-    log_error("ast_module_builder_set_name", 0, "Could not allocate memory for module name.");
+  module_builder->module->name = name;
   module_builder->name_set = true;
 }
 
@@ -374,6 +387,7 @@ static void ast_initialize_module(ast_module_node_t* module){
                         module->data.uart.usart_number = 0;
                         module->data.uart.is_uart      = false;
                         module->data.uart.gpio_af      = 0;
+                        module->data.uart.oversampling = 16;
                         break;
     default:
       log_error("ast_initialize_module", 0, "Unknown module kind for module '%s'.", 
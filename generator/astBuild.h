@@ -2,21 +2,22 @@
 #define __AST_BUILD_H__
 
 #include "astEnums.h"
+#include "arena.h"
 
 // Constructors of builder
-ast_dsl_builder_t* ast_new_dsl_builder();
-ast_module_builder_t* ast_new_module_builder(int line_nr);
+ast_dsl_builder_t* ast_new_dsl_builder(arena_t *arena);
+ast_module_builder_t* ast_new_module_builder(arena_t *arena, int line_nr, unsigned int node_id);
 
 // DSL node functions
-ast_dsl_node_t *ast_convert_dsl_builder_to_dsl_node(ast_dsl_builder_t* dsl_builder);
-void ast_free_dsl_node(ast_dsl_node_t* dsl_node);
+ast_dsl_node_t *ast_convert_dsl_builder_to_dsl_node(arena_t *arena, ast_dsl_builder_t* dsl_builder);
+void ast_index_enabled_modules(arena_t *arena, ast_dsl_node_t* dsl_node);
 
 // DSL builder functions
 void ast_dsl_builder_set_controller(int line_nr, ast_dsl_builder_t* dsl_builder, controller_t controller);
 void ast_dsl_builder_append_module_builder( int line_nr, ast_dsl_builder_t* dsl_builder, ast_module_builder_t* module_builder);
 
 // Module builder common setters
-void ast_module_builder_set_name(  int line_nr, ast_module_builder_t* module_builder, const char* name);
+void ast_module_builder_set_name(  int line_nr, ast_module_builder_t* module_builder, char* name);
 void ast_module_builder_set_pin(   int line_nr, ast_module_builder_t* module_builder, pin_t pin);
 void ast_module_builder_set_enable(int line_nr, ast_module_builder_t* module_builder, bool enable);
 void ast_module_builder_set_kind(  int line_nr, ast_module_builder_t* module_builder, ast_module_kind_t kind);
@@ -8,17 +8,23 @@
 #include "astCheckESP32.h"
 #include "astEnums2Str.h"
 
+// Number of pin slots of the largest supported controller (STM32F446RE: 8 ports * 16 pins, ESP32: 40 GPIOs)
+#define PIN_SLOT_COUNT ((STM32F446RE_PORT_COUNT * STM32F446RE_PINS_PER_PORT) > ESP32_GPIO_COUNT ? \
+                        (STM32F446RE_PORT_COUNT * STM32F446RE_PINS_PER_PORT) : ESP32_GPIO_COUNT)
+
 static void ast_check_required_dsl_params(ast_dsl_builder_t* dsl_builder);
 static void ast_check_required_module_params(ast_module_builder_t* module_builder);
 
 void ast_check_unique_enabled_names(ast_dsl_node_t* dsl_node);
 void ast_check_unique_enabled_pins(ast_dsl_node_t* dsl_node);
 
-static void check_pin_conflict(const ast_module_node_t* module1, const pin_t* pin1, const ast_module_node_t* module2, const pin_t* pin2);
+static int  get_pin_slot(controller_t controller, pin_t pin);
+static void occupy_pin(uint64_t* occupied, const ast_module_node_t** owners, controller_t controller, const ast_module_node_t* module, pin_t pin);
 static bool is_c_keyword(const char* name);
-static int get_line_nr_of_module(ast_dsl_node_t* dsl_node, const char* module_name);
+static uint32_t hash_module_name(const char* name);
 
 static int compare_modules_by_pin(const ast_module_node_t *a, const ast_module_node_t *b);
+static ast_module_node_t* merge_sorted_module_lists(ast_module_node_t *left, ast_module_node_t *right, ast_module_node_t **tail);
 
 /* -------------------------------------------- */
 /*           Required parameter checks          */
@@ -116,8 +122,9 @@ void ast_check_required_module_params(ast_module_builder_t* module_builder){
     ast_module_uart_t* uart_data = &module->data.uart;
     if(uart_data->baudrate == 0)
       log_error("ast_check_required_module_params", module->line_nr, "UART module '%s' has invalid baudrate '0'.", module->name);
-    if(uart_data->baudrate < 1200 || uart_data->baudrate > 1000000)
-      log_error("ast_check_required_module_params", module->line_nr, "UART module '%s' has unsupported baudrate '%u'. Supported range is 1200 to 1,000,000.",
+    // The upper limit depends on the clock of the UART and is checked when binding the UART (see the controller checks)
+    if(uart_data->baudrate < 1200)
+      log_error("ast_check_required_module_params", module->line_nr, "UART module '%s' has unsupported baudrate '%u'. Supported range starts at 1200.",
                 module->name, uart_data->baudrate);
     if(uart_data->databits < 5 || uart_data->databits > 9)
       log_error("ast_check_required_module_params", module->line_nr, "UART module '%s' has unsupported databits '%u'. Supported range is 5 to 9.",
@@ -157,6 +164,8 @@ void ast_check_all_enabled_modules(ast_dsl_node_t* dsl_node){
  * @param dsl_node Pointer to the DSL node.
  * 
  * @note Logs an error and exits if duplicate names or C keywords are found.
+ * @note Uses a hash set of the enabled modules (open addressing, linear probing) that points to the module nodes,
+ *       so the names are not copied and the line number of the first definition is available directly.
  */
 void ast_check_unique_enabled_names(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
@@ -164,47 +173,51 @@ void ast_check_unique_enabled_names(ast_dsl_node_t* dsl_node){
   if(dsl_node->modules_root == NULL)
     log_error("ast_check_unique_enabled_names", 0, "DSL node has no modules.");
   
-  char** existing_names = NULL;
-  unsigned int existing_names_count = 0;
+  // Size the hash set to a power of two with at most 50% load
+  uint32_t enabled_count = 0;
+  for(ast_module_node_t* current = dsl_node->modules_root; current != NULL; current = current->next)
+    if(current->enable)
+      enabled_count++;
+  
+  uint32_t capacity = 16;
+  while(capacity < 2 * enabled_count)
+    capacity *= 2;
+  
+  const ast_module_node_t** name_set = (const ast_module_node_t**)calloc(capacity, sizeof(ast_module_node_t*));
+  if(name_set == NULL)
+    log_error("ast_check_unique_enabled_names", 0, "Could not allocate memory for module name set.");
+  
   ast_module_node_t* current = dsl_node->modules_root;
   while(current != NULL){
     if(current->enable){
       // Check if name is a C keyword
-      if(is_c_keyword(current->name))
+      if(is_c_keyword(current->name)){
+        free(name_set); // The error does not return
         log_error("ast_check_unique_enabled_names", current->line_nr, "Module name '%s' is a C keyword.", current->name);
+      }
       
-      // Check for duplicate names
-      for(unsigned int i = 0; i < existing_names_count; i++){
-        if(existing_names == NULL)
-          log_error("ast_check_unique_enabled_names", 0, "INTERNAL ERROR: existing names list is NULL.");
-        if(strcmp(existing_names[i], current->name) == 0)
-          log_error("ast_check_unique_enabled_names", 0,
+      // Check for duplicate names: probe until the name or a free slot is found
+      uint32_t slot = hash_module_name(current->name) & (capacity - 1);
+      while(name_set[slot] != NULL){
+        if(strcmp(name_set[slot]->name, current->name) == 0){
+          int first_line_nr = name_set[slot]->line_nr;
+          free(name_set); // The error does not return
+          log_error("ast_check_unique_enabled_names", current->line_nr,
                     "Duplicate enabled module name '%s' found.\n"
                     "                           Module with that name was already defined at line %d.",
                     current->name,
-                    get_line_nr_of_module(dsl_node, current->name));
+                    first_line_nr);
+        }
+        slot = (slot + 1) & (capacity - 1);
       }
       
-      // Add name to existing names list
-      existing_names = (char**)realloc(existing_names, (existing_names_count + 1) * sizeof(char*));
-      if(existing_names == NULL)
-        log_error("ast_check_unique_enabled_names", 0, "Could not allocate memory for existing module names.");
-      existing_names[existing_names_count] = strdup(current->name);
-      if(existing_names[existing_names_count] == NULL)
-        log_error("ast_check_unique_enabled_names", 0, "Could not allocate memory for existing module name.");
-      existing_names_count++;
+      // Add module to the name set
+      name_set[slot] = current;
     }
     current = current->next;
   }
   
-  // Free existing names list
-  for(unsigned int i = 0; i < existing_names_count; i++){
-    if(existing_names[i] == NULL)
-      log_error("ast_check_unique_enabled_names", 0, "INTERNAL ERROR: existing name at index %u is NULL.", i);
-    free(existing_names[i]);
-    existing_names[i] = NULL;
-  }
-  free(existing_names);
+  free(name_set);
 }
 
 /**
@@ -215,6 +228,8 @@ void ast_check_unique_enabled_names(ast_dsl_node_t* dsl_node){
  * @note Logs an error and exits if duplicate pins are found.
  * @note Supports both regular modules (single pin) and UART modules (tx_pin and rx_pin).
  * @note For UART modules, checks that tx_pin and rx_pin are different.
+ * @note Uses one pass over all modules with a pin occupancy bitmap that records the owning module of each pin.
+ *       Pins that do not exist on the controller are skipped here and reported by the controller specific checks.
  */
 void ast_check_unique_enabled_pins(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
@@ -222,71 +237,79 @@ void ast_check_unique_enabled_pins(ast_dsl_node_t* dsl_node){
   if(dsl_node->modules_root == NULL)
     log_error("ast_check_unique_enabled_pins", 0, "DSL node has no modules.");
   
+  uint64_t occupied[(PIN_SLOT_COUNT + 63) / 64] = {0};
+  const ast_module_node_t* owners[PIN_SLOT_COUNT] = {NULL};
+  
   ast_module_node_t* current = dsl_node->modules_root;
   while(current != NULL){
     if(current->enable){
-      // For UART modules, check that tx_pin and rx_pin are different
-      if(current->kind == MODULE_UART){
-        if(current->pin.port == current->data.uart.rx_pin.port &&
-            current->pin.pin_number == current->data.uart.rx_pin.pin_number){
-          log_error("ast_check_unique_enabled_pins", current->line_nr,
-                    "UART module '%s' has the same pin for tx_pin and rx_pin (Port %c Pin %d).",
-                    current->name, current->pin.port, current->pin.pin_number);
-        }
-      }
+      occupy_pin(occupied, owners, dsl_node->controller, current, current->pin);
       
-      // Check for duplicate pins with other enabled modules
-      ast_module_node_t* checker = current->next;
-      while(checker != NULL){
-        if(checker->enable){
-          // Check pins based on module type
-          if(current->kind == MODULE_UART && checker->kind == MODULE_UART){
-            // Both are UART modules -> check all combinations
-            check_pin_conflict(current, &current->pin, checker, &checker->pin);
-            check_pin_conflict(current, &current->pin, checker, &checker->data.uart.rx_pin);
-            check_pin_conflict(current, &current->data.uart.rx_pin, checker, &checker->pin);
-            check_pin_conflict(current, &current->data.uart.rx_pin, checker, &checker->data.uart.rx_pin);
-          } else if(current->kind == MODULE_UART && checker->kind != MODULE_UART){
-            // Current is UART, checker is regular module
-            check_pin_conflict(current, &current->pin, checker, &checker->pin);
-            check_pin_conflict(current, &current->data.uart.rx_pin, checker, &checker->pin);
-          } else if(current->kind != MODULE_UART && checker->kind == MODULE_UART){
-            // Current is regular module, checker is UART
-            check_pin_conflict(current, &current->pin, checker, &checker->pin);
-            check_pin_conflict(current, &current->pin, checker, &checker->data.uart.rx_pin);
-          } else {
-            // Both are regular modules
-            check_pin_conflict(current, &current->pin, checker, &checker->pin);
-          }
-        }
-        checker = checker->next;
-      }
+      // For UART modules also occupy rx_pin (conflict with own tx_pin is reported separately)
+      if(current->kind == MODULE_UART)
+        occupy_pin(occupied, owners, dsl_node->controller, current, current->data.uart.rx_pin);
     }
     current = current->next;
   }
 }
 
 /**
- * @brief Helper function to check if two pins conflict.
+ * @brief Helper function to mark a pin as occupied by a module and report a conflict if it is already occupied.
+ * 
+ * @param occupied Pin occupancy bitmap (one bit per pin slot).
+ * @param owners Owning module of each occupied pin slot.
+ * @param controller Controller type (defines the pin slot numbering).
+ * @param module Pointer to the module node using the pin.
+ * @param pin Pin used by the module.
+ */
+static void occupy_pin(uint64_t* occupied, const ast_module_node_t** owners, controller_t controller, const ast_module_node_t* module, pin_t pin){
+  int slot = get_pin_slot(controller, pin);
+  if(slot < 0)
+    return; // Pin does not exist on this controller, reported by the controller specific checks
+  
+  uint64_t mask = (uint64_t)1 << (slot % 64);
+  if((occupied[slot / 64] & mask) == 0){
+    occupied[slot / 64] |= mask;
+    owners[slot] = module;
+    return;
+  }
+  
+  const ast_module_node_t* owner = owners[slot];
+  if(owner == module)
+    log_error("ast_check_unique_enabled_pins", module->line_nr,
+              "UART module '%s' has the same pin '%s' for tx_pin and rx_pin.",
+              module->name, pin_to_string(pin));
+  
+  log_error("ast_check_unique_enabled_pins", module->line_nr,
+            "Duplicate enabled module pin found: Pin '%s' is used by both module '%s' (line %d) and module '%s' (line %d).",
+            pin_to_string(pin),
+            owner->name,
+            owner->line_nr,
+            module->name,
+            module->line_nr);
+}
+
+/**
+ * @brief Helper function to map a pin to its slot in the pin occupancy bitmap.
  * 
- * @param module1 Pointer to the first module node for error reporting.
- * @param pin1 Pointer to the first pin.
- * @param module2 Pointer to the second module node for error reporting.
- * @param pin2 Pointer to the second pin.
+ * @param controller Controller type.
+ * @param pin Pin to map.
+ * @return Slot of the pin ((port - 'A') * 16 + number for STM32F446RE, number for ESP32), or -1 if the pin does not exist.
  */
-static void check_pin_conflict(const ast_module_node_t* module1, const pin_t* pin1, const ast_module_node_t* module2, const pin_t* pin2){
-  if(pin1->port == pin2->port && pin1->pin_number == pin2->pin_number){
-    log_error("ast_check_unique_enabled_pins", 0,
-              "Duplicate enabled module pin found: Port %c Pin %d is used by both module '%s' (line %d) and module '%s' (line %d).",
-              pin1->port,
-              pin1->pin_number,
-              module1->name,
-              module1->line_nr,
-              module2->name,
-              module2->line_nr);
+static int get_pin_slot(controller_t controller, pin_t pin){
+  switch(controller){
+    case STM32F446RE: if(pin.identifier != PXn || pin.port < 'A' || pin.port >= 'A' + STM32F446RE_PORT_COUNT || pin.pin_number >= STM32F446RE_PINS_PER_PORT)
+                        return -1;
+                      return (pin.port - 'A') * STM32F446RE_PINS_PER_PORT + (int)pin.pin_number;
+    case ESP32:       if(pin.identifier != GPIOn || pin.pin_number >= ESP32_GPIO_COUNT)
+                        return -1;
+                      return (int)pin.pin_number;
+    default:          log_error("get_pin_slot", 0, "Unsupported controller '%s' for pin slots.", controller_to_string(controller));
   }
+  return -1; // This line will never be reached due to log_error exiting the program
 }
 
+
 /**
  * @brief Checks if the given name is a C language keyword.
  * 
@@ -317,31 +340,21 @@ static bool is_c_keyword(const char* name){
 }
 
 /**
- * @brief Retrieves the line number of the module with the given name from the DSL node.
- * 
- * @param dsl_node Pointer to the DSL node.
- * @param module_name Name of the module to search for.
- * @return Line number of the module if found.
+ * @brief Computes the hash of a module name (32 bit FNV-1a).
  * 
- * @note Logs an error and exits if the module name is not found.
+ * @param name Name to hash.
+ * @return Hash value of the name.
  */
-static int get_line_nr_of_module(ast_dsl_node_t* dsl_node, const char* module_name){
-  if(module_name == NULL)
-    log_error("get_line_nr_of_module", 0, "Module name is NULL.");
-  if(dsl_node == NULL)
-    log_error("get_line_nr_of_module", 0, "AST root is NULL.");
-  if(dsl_node->modules_root == NULL)
-    log_error("get_line_nr_of_module", 0, "AST root has no modules.");
+static uint32_t hash_module_name(const char* name){
+  if(name == NULL)
+    log_error("hash_module_name", 0, "Module name is NULL.");
   
-  ast_module_node_t* current = dsl_node->modules_root;
-  while(current != NULL){
-    if(strcmp(current->name, module_name) == 0)
-      return current->line_nr;
-    current = current->next;
+  uint32_t hash = 2166136261u;
+  for(const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++){
+    hash ^= *c;
+    hash *= 16777619u;
   }
-  
-  log_error("get_line_nr_of_module", 0, "Module name '%s' not found in AST.", module_name);
-  return -1; // This line will never be reached due to log_error exiting the program
+  return hash;
 }
 
 
@@ -353,7 +366,8 @@ static int get_line_nr_of_module(ast_dsl_node_t* dsl_node, const char* module_na
  * @brief Sorts the modules in the DSL node by their pin (port and pin number).
  * 
  * @param dsl_node Pointer to the DSL node.
- * @note Uses insertion sort algorithm for simplicity.
+ * @note Uses a stable bottom-up merge sort of the linked list (O(n log n), no extra memory):
+ *       modules with the same pin keep their order of definition.
  */
 void ast_sort_modules_by_pin(ast_dsl_node_t *dsl_node){
   if(dsl_node == NULL)
@@ -362,44 +376,97 @@ void ast_sort_modules_by_pin(ast_dsl_node_t *dsl_node){
   if(dsl_node->modules_root == NULL)
     log_error("ast_sort_modules_by_pin", 0, "DSL node has no modules.");
   
-  if(dsl_node->modules_root->next == NULL)
+  if(dsl_node->modules_root->next == NULL){
+    dsl_node->modules_tail = dsl_node->modules_root;
     return; // Single element, already sorted
+  }
   
-  ast_module_node_t *sorted = NULL;
-  ast_module_node_t *current = dsl_node->modules_root;
+  ast_module_node_t *list = dsl_node->modules_root;
+  ast_module_node_t *tail = NULL;
   
-  while(current != NULL){
-    ast_module_node_t *next = current->next;
-    
-    // If sorted list is empty put current element as first 
-    if(sorted == NULL){
-      current->next = NULL;
-      sorted = current;
-      current = next;
-      continue;
-    }
+  // Merge sorted runs of length 1, 2, 4, ... until one run covers the whole list
+  for(unsigned int run_length = 1; ; run_length *= 2){
+    ast_module_node_t *remaining = list;
+    ast_module_node_t *merged_head = NULL;
+    ast_module_node_t *merged_tail = NULL;
+    unsigned int merge_count = 0;
     
-    // If smaller than first element, insert at beginning
-    if(compare_modules_by_pin(current, sorted) < 0){
-      current->next = sorted;
-      sorted = current;
-      current = next;
-      continue;
+    while(remaining != NULL){
+      merge_count++;
+      
+      // Cut the left run
+      ast_module_node_t *left = remaining;
+      ast_module_node_t *left_last = left;
+      for(unsigned int i = 1; i < run_length && left_last->next != NULL; i++)
+        left_last = left_last->next;
+      
+      // Cut the right run
+      ast_module_node_t *right = left_last->next;
+      left_last->next = NULL;
+      ast_module_node_t *right_last = right;
+      for(unsigned int i = 1; i < run_length && right_last != NULL && right_last->next != NULL; i++)
+        right_last = right_last->next;
+      
+      if(right_last != NULL){
+        remaining = right_last->next;
+        right_last->next = NULL;
+      } else{
+        remaining = NULL;
+      }
+      
+      // Merge both runs and append them to the merged list
+      ast_module_node_t *run_tail;
+      ast_module_node_t *run_head = merge_sorted_module_lists(left, right, &run_tail);
+      if(merged_head == NULL)
+        merged_head = run_head;
+      else
+        merged_tail->next = run_head;
+      merged_tail = run_tail;
     }
     
-    // Else, find correct position in sorted list
-    ast_module_node_t *search = sorted;
-    while(search->next != NULL && compare_modules_by_pin(search->next, current) < 0)
-      search = search->next;
-    
-    // Insert current after last smaller element found
-    current->next = search->next;
-    search->next = current;
+    list = merged_head;
+    tail = merged_tail;
     
-    current = next;
+    if(merge_count <= 1)
+      break;
   }
   
-  dsl_node->modules_root = sorted;
+  dsl_node->modules_root = list;
+  dsl_node->modules_tail = tail;
+  dsl_node->modules_indexed = false; // Order changed, index has to be rebuilt
+}
+
+/**
+ * @brief Merges two sorted module lists into one sorted list.
+ * 
+ * @param left First sorted list (modules defined earlier).
+ * @param right Second sorted list (modules defined later).
+ * @param tail Returns the last module of the merged list.
+ * @return First module of the merged list.
+ * 
+ * @note Stable: on equal pins the module of the left list comes first.
+ */
+static ast_module_node_t* merge_sorted_module_lists(ast_module_node_t *left, ast_module_node_t *right, ast_module_node_t **tail){
+  ast_module_node_t head;
+  ast_module_node_t *last = &head;
+  
+  while(left != NULL && right != NULL){
+    if(compare_modules_by_pin(right, left) < 0){
+      last->next = right;
+      right = right->next;
+    } else{
+      last->next = left;
+      left = left->next;
+    }
+    last = last->next;
+  }
+  
+  last->next = (left != NULL) ? left : right;
+  while(last->next != NULL)
+    last = last->next;
+  
+  *tail = last;
+  return head.next;
 }
 
 /**
@@ -444,4 +511,27 @@ void ast_bind_backend_specific_params(ast_dsl_node_t* dsl_node){
                       break;
     default:          log_error("ast_bind_backend_specific_params", 0, "Unsupported controller '%s' for backend specific parameter bindings.", controller_to_string(dsl_node->controller));
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Determines the PWM signal a bound PWM module generates with the parameters selected by the generator.
+ * 
+ * @param dsl_node Pointer to the DSL node.
+ * @param module Pointer to the bound PWM module.
+ * @param timing Pointer to store the achieved frequency, its error and the duty resolution in.
+ * @return true if the timing was determined, false if the controller does not provide it.
+ */
+bool ast_pwm_timing(const ast_dsl_node_t* dsl_node, const ast_module_node_t* module, ast_pwm_timing_t* timing){
+  if(dsl_node == NULL || module == NULL || timing == NULL)
+    log_error("ast_pwm_timing", 0, "DSL node, module or timing is NULL.");
+  if(module->kind != MODULE_PWM_OUTPUT)
+    log_error("ast_pwm_timing", module->line_nr, "Module '%s' is not a PWM module.", module->name);
+  
+  switch(dsl_node->controller){
+    case STM32F446RE: ast_check_stm32f446re_pwm_timing(module, timing);
+                      return true;
+    case ESP32:       ast_check_esp32_pwm_timing(module, timing);
+                      return true;
+    default:          return false;
+  }
+}
@@ -14,5 +14,6 @@ void ast_sort_modules_by_pin(ast_dsl_node_t *dsl_node);
 
 // Bind backend specific parameters
 void ast_bind_backend_specific_params(ast_dsl_node_t* dsl_node);
+bool ast_pwm_timing(const ast_dsl_node_t* dsl_node, const ast_module_node_t* module, ast_pwm_timing_t* timing);
 
 #endif //__AST_CHECK_H__
\ No newline at end of file
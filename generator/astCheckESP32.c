@@ -1,16 +1,31 @@
 #include "astCheckESP32.h"
 
 #include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "ESP32.h"
 #include "logging.h"
 #include "astEnums2Str.h"
+#include "astHelper.h"
 
+#define LEDC_MAX_PWM_MODULES (2 * ESP32_LEDC_CHANNELS_PER_MODE)  // One channel per PWM module in both speed modes
+#define UART_MAX_BAUDRATE    5000000u                            // APB clock (80 MHz) / 16 times oversampling
+
+static void pincap_build_index_esp32();
 static const pin_cap_t* pincap_find_esp32(uint8_t num);
 static void is_valid_esp32_pin(const char *module_name, int line_nr, pin_t pin);
 static void bind_pwm_pins_esp32(ast_dsl_node_t* dsl_node);
+static bool bind_ledc_split_groups(const uint32_t *group_size, uint32_t group_count, uint32_t group, uint32_t timers_high, uint32_t timers_low,
+                                   uint32_t channels_high, uint32_t channels_low, uint32_t *high_count);
+static uint32_t ledc_duty_resolution(uint32_t frequency);
 static void bind_uart_pins_esp32(ast_dsl_node_t* dsl_node);
 
+// Direct index into PINCAP_ESP32: [num] (NULL = pin does not exist), built once
+static const pin_cap_t* pincap_index_esp32[ESP32_GPIO_COUNT];
+static pthread_once_t pincap_index_once_esp32 = PTHREAD_ONCE_INIT;
+static const pin_key_t* pincap_index_invalid_esp32 = NULL;  // Table entry outside of the index (reported after pthread_once)
+
 
 /* -------------------------------------------- */
 /*      Required parameter checks for ESP32     */
@@ -218,36 +233,167 @@ void ast_check_esp32_bind_pins(ast_dsl_node_t* dsl_node){
 /**
  * @brief Binds PWM pins for ESP32.
  * 
- * @param dsl_node Pointer to the DSL node.
+ * @param dsl_node Pointer to the DSL node (enabled modules indexed).
+ * 
+ * Assigns LEDC timers and channels to PWM output modules. Modules with the same frequency share a timer, each module
+ * gets its own channel (the GPIO matrix routes every channel to every output pin). Both speed modes are used,
+ * so up to 16 PWM modules with up to 8 different frequencies are possible. The period is set to the largest duty value
+ * of the timer (2^resolution - 1), with the largest duty resolution the LEDC clock allows for the frequency.
  * 
- * Assigns timer numbers and channels to PWM output modules by iteration.
+ * @note The modules of a frequency are kept in one speed mode (one timer) whenever possible, and in the high speed mode
+ *       if it has room (see bind_ledc_split_groups).
+ * @note Logs an error and exits if the timers or channels do not suffice for all PWM modules.
  */
 static void bind_pwm_pins_esp32(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("bind_pwm_pins_esp32", 0, "DSL node is NULL.");
   
-  const uint8_t MAX_TIMERS = 4; // ESP32 has 4 LEDC timers (0-3)
-  uint8_t nr_tim_used = 0;
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  if(pwm_modules.count == 0)
+    return;
+  if(pwm_modules.count > LEDC_MAX_PWM_MODULES)
+    log_error("bind_pwm_pins_esp32", pwm_modules.items[LEDC_MAX_PWM_MODULES]->line_nr, "Too many PWM modules (%u), ESP32 has %u LEDC channels.",
+              pwm_modules.count,
+              LEDC_MAX_PWM_MODULES);
   
-  ast_module_node_t* current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && (current_module->kind == MODULE_PWM_OUTPUT)){
-      // Pick the first PWM option whose timer is still free
-      if(nr_tim_used >= MAX_TIMERS)
-        log_error("bind_pwm_pins_esp32", current_module->line_nr, "All available PWM timers are already assigned. Cannot assign PWM module '%s' on pin '%s'.",
+  // Group the modules by frequency (groups in order of their first module), each group needs its own timer
+  uint8_t group_of[LEDC_MAX_PWM_MODULES];
+  uint32_t group_size[LEDC_MAX_PWM_MODULES] = {0};
+  uint32_t group_count = 0;
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    if(current_module->data.pwm.frequency == 0)
+      log_error("bind_pwm_pins_esp32", current_module->line_nr, "PWM frequency cannot be zero for module '%s'.", current_module->name);
+    if(ledc_duty_resolution(current_module->data.pwm.frequency) == 0)
+      log_error("bind_pwm_pins_esp32", current_module->line_nr, "Target frequency %u Hz too high for PWM module '%s' (at most %u Hz).",
+                current_module->data.pwm.frequency,
+                current_module->name,
+                ESP32_LEDC_CLOCK_HZ / 2u);
+    
+    group_of[i] = (uint8_t)group_count;
+    for(uint32_t k = 0; k < i; k++){
+      if(pwm_modules.items[k]->data.pwm.frequency == current_module->data.pwm.frequency){
+        group_of[i] = group_of[k];
+        break;
+      }
+    }
+    if(group_of[i] == group_count){
+      if(group_count == 2 * ESP32_LEDC_TIMERS_PER_MODE)
+        log_error("bind_pwm_pins_esp32", current_module->line_nr, "Too many different PWM frequencies, ESP32 has %u LEDC timers. Cannot assign PWM module '%s' (%u Hz).",
+                  2 * ESP32_LEDC_TIMERS_PER_MODE,
                   current_module->name,
-                  pin_to_string(current_module->pin));
-      
-      current_module->data.pwm.tim_number = nr_tim_used; // Assign next free timer number
-      current_module->data.pwm.tim_channel = nr_tim_used; // For simplicity, use same number for channel (channels are shared between timers on ESP32)
-      current_module->data.pwm.gpio_af   = 0; // Not used on ESP32
-      current_module->data.pwm.prescaler = 0; // Not used on ESP32
-      current_module->data.pwm.period    = 0; // Not used on ESP32
-      
-      nr_tim_used++;
+                  current_module->data.pwm.frequency);
+      group_count++;
     }
-    current_module = current_module->next;
+    group_size[group_of[i]]++;
+  }
+  
+  // Number of modules of each group in the high speed mode (the others use the low speed mode)
+  uint32_t high_count[LEDC_MAX_PWM_MODULES];
+  if(!bind_ledc_split_groups(group_size, group_count, 0, 0, 0, 0, 0, high_count))
+    log_error("bind_pwm_pins_esp32", pwm_modules.items[0]->line_nr, "The %u PWM modules with %u different frequencies do not fit into the LEDC timers and channels of ESP32.",
+              pwm_modules.count,
+              group_count);
+  
+  // Number the timers of each mode in group order and the channels in module order
+  uint8_t timer_high[LEDC_MAX_PWM_MODULES], timer_low[LEDC_MAX_PWM_MODULES];
+  uint32_t timers_used[2] = {0, 0};
+  for(uint32_t g = 0; g < group_count; g++){
+    if(high_count[g] > 0)
+      timer_high[g] = (uint8_t)(timers_used[0]++);
+    if(high_count[g] < group_size[g])
+      timer_low[g] = (uint8_t)(ESP32_LEDC_TIMERS_PER_MODE + timers_used[1]++);
   }
+  
+  uint32_t channels_used[2] = {0, 0};
+  uint32_t group_assigned[LEDC_MAX_PWM_MODULES] = {0};
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    uint32_t g = group_of[i];
+    bool high_speed = (group_assigned[g]++ < high_count[g]);
+    uint32_t resolution = ledc_duty_resolution(current_module->data.pwm.frequency);
+    
+    current_module->data.pwm.tim_number  = high_speed ? timer_high[g] : timer_low[g];
+    current_module->data.pwm.tim_channel = high_speed ? (uint8_t)(channels_used[0]++) : (uint8_t)(ESP32_LEDC_CHANNELS_PER_MODE + channels_used[1]++);
+    current_module->data.pwm.gpio_af     = 0; // Not used on ESP32
+    current_module->data.pwm.prescaler   = 0; // Not used on ESP32 (the LEDC driver calculates the clock divider)
+    current_module->data.pwm.period      = (1u << resolution) - 1u;
+    
+    ast_pwm_timing_t timing;
+    ast_check_esp32_pwm_timing(current_module, &timing);
+    log_info("bind_pwm_pins_esp32", LOG_OTHER, 0, "Assigned LEDC timer %u and channel %u (%s speed, %u bit) to PWM module '%s': %.3f Hz (requested %u Hz, error %+.1f ppm).",
+              current_module->data.pwm.tim_number % ESP32_LEDC_TIMERS_PER_MODE,
+              current_module->data.pwm.tim_channel % ESP32_LEDC_CHANNELS_PER_MODE,
+              high_speed ? "high" : "low",
+              resolution,
+              current_module->name,
+              timing.achieved_frequency,
+              current_module->data.pwm.frequency,
+              timing.error_ppm);
+  }
+}
+
+/**
+ * @brief Splits the PWM frequency groups from group on between the two speed modes of the LEDC.
+ * 
+ * @param group_size Number of modules of each group.
+ * @param group_count Number of groups.
+ * @param group First group without split.
+ * @param timers_high Timers used in the high speed mode by the groups before group.
+ * @param timers_low Timers used in the low speed mode by the groups before group.
+ * @param channels_high Channels used in the high speed mode by the groups before group.
+ * @param channels_low Channels used in the low speed mode by the groups before group.
+ * @param high_count Array to store the number of modules of each group in the high speed mode in.
+ * @return true if all groups from group on fit into the remaining timers and channels, false otherwise.
+ * 
+ * @note A group uses one timer in each mode it has modules in. Each group tries all of its modules in the high speed
+ *       mode first, then all in the low speed mode, then splits with as many modules as possible in the high speed mode.
+ *       At most 8 groups with 16 modules exist, so the backtracking stays small.
+ */
+static bool bind_ledc_split_groups(const uint32_t *group_size, uint32_t group_count, uint32_t group, uint32_t timers_high, uint32_t timers_low,
+                                   uint32_t channels_high, uint32_t channels_low, uint32_t *high_count){
+  if(group == group_count)
+    return true;
+  
+  uint32_t size = group_size[group];
+  for(uint32_t attempt = 0; attempt <= size; attempt++){
+    // attempt 0: all high speed, attempt 1: all low speed, then size - 1 ... 1 modules in high speed
+    uint32_t high = (attempt == 0) ? size : ((attempt == 1) ? 0 : size + 1 - attempt);
+    uint32_t low = size - high;
+    uint32_t new_timers_high = timers_high + ((high > 0) ? 1u : 0u);
+    uint32_t new_timers_low  = timers_low + ((low > 0) ? 1u : 0u);
+    if((new_timers_high > ESP32_LEDC_TIMERS_PER_MODE) || (new_timers_low > ESP32_LEDC_TIMERS_PER_MODE) ||
+       (channels_high + high > ESP32_LEDC_CHANNELS_PER_MODE) || (channels_low + low > ESP32_LEDC_CHANNELS_PER_MODE))
+      continue;
+    
+    high_count[group] = high;
+    if(bind_ledc_split_groups(group_size, group_count, group + 1, new_timers_high, new_timers_low,
+                              channels_high + high, channels_low + low, high_count))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Determines the PWM signal of a bound ESP32 PWM module (see ast_pwm_timing).
+ * 
+ * @param module Pointer to the PWM module (period bound to the largest duty value).
+ * @param timing Pointer to store the achieved frequency, its error and the duty resolution in.
+ * 
+ * @note The LEDC divides its clock by a fixed point divider with 8 fractional bits, calculated like the
+ *       ESP-IDF driver does (truncated). The achieved frequency is the average over the divider cycles.
+ */
+void ast_check_esp32_pwm_timing(const ast_module_node_t* module, ast_pwm_timing_t* timing){
+  if(module == NULL || timing == NULL)
+    log_error("ast_check_esp32_pwm_timing", 0, "Module or timing is NULL.");
+  
+  uint64_t duty_steps = (uint64_t)module->data.pwm.period + 1u;
+  uint64_t divider = (module->data.pwm.frequency == 0) ? 0 : (((uint64_t)ESP32_LEDC_CLOCK_HZ << 8) / module->data.pwm.frequency / duty_steps);
+  timing->achieved_frequency = (divider == 0) ? 0.0 : ((double)ESP32_LEDC_CLOCK_HZ * 256.0) / ((double)divider * (double)duty_steps);
+  timing->error_ppm = (module->data.pwm.frequency == 0) ? 0.0 :
+                      (timing->achieved_frequency - module->data.pwm.frequency) / module->data.pwm.frequency * 1e6;
+  timing->duty_steps = (uint32_t)duty_steps;
+  timing->resolution_bits = log2((double)duty_steps);
 }
 
 /**
@@ -256,6 +402,8 @@ static void bind_pwm_pins_esp32(ast_dsl_node_t* dsl_node){
  * @param dsl_node Pointer to the DSL node.
  * 
  * Assigns USART numbers and GPIO alternate function numbers to UART modules based on available options and usage.
+ * 
+ * @note Logs an error and exits if the baud rate of a module exceeds the UART_MAX_BAUDRATE of the UART controllers.
  */
 static void bind_uart_pins_esp32(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
@@ -273,10 +421,16 @@ static void bind_uart_pins_esp32(ast_dsl_node_t* dsl_node){
                   current_module->name,
                   pin_to_string(current_module->pin),
                   pin_to_string(current_module->data.uart.rx_pin));
+      if(current_module->data.uart.baudrate > UART_MAX_BAUDRATE)
+        log_error("bind_uart_pins_esp32", current_module->line_nr, "Baud rate %u of UART module '%s' is too high for ESP32 (at most %u).",
+                  current_module->data.uart.baudrate,
+                  current_module->name,
+                  UART_MAX_BAUDRATE);
       
       current_module->data.uart.usart_number = nr_uart_used;
       current_module->data.uart.is_uart      = true; // Not used on ESP32, all are UART
       current_module->data.uart.gpio_af      = 0;    // Not used on ESP32
+      current_module->data.uart.oversampling = 16;   // Fixed on ESP32
       nr_uart_used++;
     }
     current_module = current_module->next;
@@ -288,17 +442,56 @@ static void bind_uart_pins_esp32(ast_dsl_node_t* dsl_node){
 /*               Helper functions               */
 /* -------------------------------------------- */
 
+/**
+ * @brief Fills the direct pin index from the PINCAP_ESP32 table.
+ * 
+ * @note Called exactly once (via pthread_once) before the first lookup. Must return normally (no log_error, which
+ *       would leave the once control in progress), so an entry outside of the index is only recorded and reported
+ *       by pincap_find_esp32.
+ */
+static void pincap_build_index_esp32(){
+  for(uint16_t i = 0; i < PINCAP_ESP32_LEN; i++){
+    const pin_key_t *key = &PINCAP_ESP32[i].pin;
+    if(key->num >= ESP32_GPIO_COUNT){
+      pincap_index_invalid_esp32 = key;
+      return;
+    }
+    pincap_index_esp32[key->num] = &PINCAP_ESP32[i];
+  }
+}
+
 /**
  * @brief Finds the pin capabilities for a given port and pin number on the ESP32.
  * 
  * @param num The pin number (0-35).
  * @return const pin_cap_t* Pointer to the pin capabilities structure.
+ * 
+ * @note Constant time lookup in the direct pin index.
  */
 static const pin_cap_t* pincap_find_esp32(uint8_t num){
-  for(uint16_t i = 0; i < PINCAP_ESP32_LEN; i++){
-    if(PINCAP_ESP32[i].pin.num == num)
-      return &PINCAP_ESP32[i];
-  }
+  pthread_once(&pincap_index_once_esp32, pincap_build_index_esp32);
+  if(pincap_index_invalid_esp32 != NULL)
+    log_error("pincap_find_esp32", 0, "INTERNAL ERROR: Pin 'GPIO%d' of the ESP32 pin capabilities is outside of the pin index.",
+              pincap_index_invalid_esp32->num);
+  
+  if(num < ESP32_GPIO_COUNT && pincap_index_esp32[num] != NULL)
+    return pincap_index_esp32[num];
+  
   log_error("pincap_find_esp32", 0, "Pin 'GPIO%d' not found in ESP32 pin capabilities.", num);
   return NULL; // This line will never be reached due to log_error exiting the program
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Determines the largest LEDC duty resolution for a PWM frequency.
+ * 
+ * @param frequency PWM frequency in Hz (not 0).
+ * @return Duty resolution in bits (at most ESP32_LEDC_MAX_RESOLUTION), 0 if the frequency is too high for 1 bit.
+ * 
+ * @note The timer counts 2^resolution clock cycles per period, so the clock divider is at least 1.
+ */
+static uint32_t ledc_duty_resolution(uint32_t frequency){
+  uint32_t resolution = 0;
+  while((resolution < ESP32_LEDC_MAX_RESOLUTION) && ((uint64_t)frequency << (resolution + 1)) <= ESP32_LEDC_CLOCK_HZ)
+    resolution++;
+  return resolution;
+}
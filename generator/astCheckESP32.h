@@ -3,6 +3,16 @@
 
 #include "astEnums.h"
 
+// Pin numbering of ESP32: GPIO0...GPIO39 (index [num])
+#define ESP32_GPIO_COUNT 40
+
+// LEDC of ESP32: 4 timers and 8 channels in each speed mode. Bound PWM modules number them across both modes,
+// high speed first (timer 0...7, channel 0...15, e.g. timer 5 = LEDC_TIMER_1 in LEDC_LOW_SPEED_MODE).
+#define ESP32_LEDC_TIMERS_PER_MODE   4
+#define ESP32_LEDC_CHANNELS_PER_MODE 8
+#define ESP32_LEDC_CLOCK_HZ          80000000u  // APB clock, source of the LEDC timers
+#define ESP32_LEDC_MAX_RESOLUTION    20         // Duty resolution in bits
+
 // Required parameter checks for ESP32
 void ast_check_esp32_required_params(ast_dsl_builder_t* dsl_builder);
 
@@ -11,5 +21,6 @@ void ast_check_esp32_valid_pins(ast_dsl_node_t* dsl_node);
 
 // Backend specific parameter bindings for ESP32
 void ast_check_esp32_bind_pins(ast_dsl_node_t* dsl_node);
+void ast_check_esp32_pwm_timing(const ast_module_node_t* module, ast_pwm_timing_t* timing);
 
 #endif // __AST_CHECK_ESP32_H__
\ No newline at end of file
@@ -1,16 +1,96 @@
 #include "astCheckSTM32F446RE.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "STM32F446RE.h"
 #include "logging.h"
 #include "astEnums2Str.h"
+#include "astHelper.h"
 
+#define BIND_MAX_OPTIONS     MAX_PWM_OPT  // Options of one module (PWM options of its pin, or USARTs common to its TX and RX pin)
+#define BIND_RESOURCE_LIMIT  16           // Resource numbers (TIM1...TIM14, USART1...USART6) are below this limit (one bit each)
+#define BIND_TIMER_CHANNELS  4            // Channels of a timer (TIMx_CH1...TIMx_CH4)
+#define BIND_MAX_PWM_MODULES 64           // PWM modules of one configuration (one timer channel each)
+#define BIND_SLOT_FREE       0xFF         // Timer channel without module during the allocation
+
+_Static_assert(MAX_UART_OPT <= BIND_MAX_OPTIONS, "UART options of a pin must fit into the options of a bind request");
+
+/**
+ * @brief Structure describing the options of one module for the resource allocation (timers or USARTs).
+ * 
+ * Consists of the module, and for each option (in order of preference) the resource it occupies, the channel of the
+ * resource and its index in the pin capabilities (pwm[] of the pin, uart[] of the TX pin for UART modules).
+ */
+typedef struct{
+  ast_module_node_t *module;
+  uint8_t option_count;
+  uint8_t resource[BIND_MAX_OPTIONS];  // Timer or USART number
+  uint8_t channel[BIND_MAX_OPTIONS];   // Timer channel (1...4), 0 for USARTs
+  uint8_t option[BIND_MAX_OPTIONS];    // Index in the pin capabilities
+} bind_request_t;
+
+/**
+ * @brief Structure holding the state of the timer allocation for PWM modules (see bind_share_timers).
+ * 
+ * PWM modules with the same frequency form a group. The modules of a group can share a timer (on different channels),
+ * while each timer belongs to at most one group. Timers are numbered densely in order of their first appearance
+ * in the options, so a set of timers fits into one bit mask of timer_count bits.
+ */
+typedef struct{
+  const bind_request_t *requests;
+  uint8_t *chosen;                                                  // Index of the chosen option of each request
+  uint32_t group_count;
+  uint8_t  group_first[BIND_MAX_PWM_MODULES];                       // Index of the first member of each group in members
+  uint8_t  group_size[BIND_MAX_PWM_MODULES];
+  uint8_t  members[BIND_MAX_PWM_MODULES];                           // Request indices, by group and in bind order
+  uint32_t timer_count;
+  uint8_t  timer_bit[BIND_RESOURCE_LIMIT];                          // Dense index of each timer number
+  uint8_t  slot_member[BIND_RESOURCE_LIMIT][BIND_TIMER_CHANNELS];   // Member of the current group on each timer channel
+  bool     slot_visited[BIND_RESOURCE_LIMIT][BIND_TIMER_CHANNELS];
+  uint8_t *dead;                                                    // Per group, one bit per set of timers of the groups before it
+} bind_timer_search_t;
+
+// Search for an assignment of all requests, storing the index of the chosen option of each request
+typedef bool (*bind_matcher_t)(const bind_request_t *requests, uint32_t request_count, uint8_t *chosen);
+
+/**
+ * @brief Structure describing the baud rate a USART generates with one oversampling (see uart_baud_stm32f446re).
+ * 
+ * Consists of the value of the baud rate register, the achieved baud rate and its deviation from the requested baud rate.
+ */
+typedef struct{
+  uint32_t brr;                // Value of USART_BRR (mantissa and fraction of USARTDIV)
+  double   achieved_baudrate;  // Baud rate of the generated signal
+  double   error_ppm;          // (achieved - requested) / requested in parts per million
+} uart_baud_t;
+
+static void pincap_build_index_stm32f446re();
 static const pin_cap_t* pincap_find_stm32f446re(char port, uint8_t num);
 static void is_valid_stm32f446re_pin(const char *module_name, int line_nr, pin_t pin);
 static void bind_pwm_pins_stm32f446re(ast_dsl_node_t* dsl_node);
 static void bind_pwm_prescaler_period_stm32f446re(ast_dsl_node_t* dsl_node);
 static void bind_uart_pins_stm32f446re(ast_dsl_node_t* dsl_node);
+static bool bind_match_resources(const bind_request_t *requests, uint32_t request_count, uint8_t *chosen);
+static bool bind_match_search(const bind_request_t *requests, uint32_t request_count, uint32_t index, uint32_t used,
+                              uint8_t *dead, uint8_t *chosen);
+static bool bind_share_timers(const bind_request_t *requests, uint32_t request_count, uint8_t *chosen);
+static bool bind_share_search(bind_timer_search_t *search, uint32_t group, uint32_t used);
+static bool bind_share_match_group(bind_timer_search_t *search, uint32_t group, uint32_t timers, uint32_t *timers_used);
+static bool bind_share_augment(bind_timer_search_t *search, uint32_t group, uint32_t timers, uint8_t member);
+static void bind_report_unmatched(const char *function_name, bind_matcher_t matcher, const bind_request_t *requests, uint32_t request_count,
+                                  const char *resource_name, const char *resource_prefix, const char *module_kind);
+static uint32_t uart_clock_stm32f446re(uint8_t usart);
+static bool uart_baud_stm32f446re(uint8_t usart, uint32_t baudrate, uint8_t oversampling, uart_baud_t *baud);
+static uint8_t uart_select_oversampling_stm32f446re(uint8_t usart, uint32_t baudrate, uart_baud_t *baud);
+
+// Direct index into PINCAP_STM32F446RE: [port - 'A'][num] (NULL = pin does not exist), built once
+static const pin_cap_t* pincap_index_stm32f446re[STM32F446RE_PORT_COUNT][STM32F446RE_PINS_PER_PORT];
+static pthread_once_t pincap_index_once_stm32f446re = PTHREAD_ONCE_INIT;
+static const pin_key_t* pincap_index_invalid_stm32f446re = NULL;  // Table entry outside of the index (reported after pthread_once)
 
 
 /* -------------------------------------------- */
@@ -217,143 +297,580 @@ void ast_check_stm32f446re_bind_pins(ast_dsl_node_t* dsl_node){
 /**
  * @brief Binds PWM pins for STM32F446RE.
  * 
- * @param dsl_node Pointer to the DSL node.
+ * @param dsl_node Pointer to the DSL node (enabled modules indexed).
+ * 
+ * Assigns timer numbers and channels to PWM output modules. Modules with the same frequency can share a timer
+ * on different channels, modules with different frequencies never do.
  * 
- * Assigns timer numbers and channels to PWM output modules based on available options and usage.
+ * @note The assignment is searched for all modules together (see bind_share_timers), so a valid assignment is found
+ *       whenever one exists, independent of the module order. The modules of each frequency get as few timers as
+ *       possible, and modules with a frequency of their own get the earliest PWM option of their pin that still allows
+ *       an assignment for the remaining modules (in module order).
+ * @note Logs an error and exits if the timer channels of the pins do not suffice for all PWM modules.
  */
 static void bind_pwm_pins_stm32f446re(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("bind_pwm_pins_stm32f446re", 0, "DSL node is NULL.");
   
-  bool tim_used[15] = { false }; // TIM1 to TIM14 (0 unused)
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  if(pwm_modules.count == 0)
+    return;
+  if(pwm_modules.count > BIND_MAX_PWM_MODULES)
+    log_error("bind_pwm_pins_stm32f446re", pwm_modules.items[BIND_MAX_PWM_MODULES]->line_nr,
+              "Too many PWM modules (%u), each needs its own timer channel of STM32F446RE.", pwm_modules.count);
   
-  ast_module_node_t* current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && (current_module->kind == MODULE_PWM_OUTPUT)){
-      pin_cap_t *cur_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->pin.port, (uint8_t)(current_module->pin.pin_number));
-      if(cur_cap->pwm_count == 0)
-        log_error("bind_pwm_pins_stm32f446re", 0, "Pin '%s' does not support PWM for module '%s'.",
-                  pin_to_string(current_module->pin),
-                  current_module->name);
-      
-      // Pick the first PWM option whose timer is still free
-      for(uint8_t i = 0; i < cur_cap->pwm_count; i++){
-        pwm_opt_t *pwm_opt = &cur_cap->pwm[i];
-        if(!tim_used[pwm_opt->tim]){
-          // Assign this timer and channel to the module
-          current_module->data.pwm.tim_number  = pwm_opt->tim;
-          current_module->data.pwm.tim_channel = pwm_opt->ch;
-          current_module->data.pwm.gpio_af     = pwm_opt->af;
-          
-          tim_used[pwm_opt->tim] = true; // Mark timer as used
-          
-          char* pin_str = pin_to_string(current_module->pin);
-          log_info("bind_pwm_pins_stm32f446re", LOG_OTHER, 0, "Assigned TIM%d_CH%d (AF%d) to PWM module '%s' on pin '%s'.",
-                    current_module->data.pwm.tim_number,
-                    current_module->data.pwm.tim_channel,
-                    current_module->data.pwm.gpio_af,
-                    current_module->name,
-                    pin_str);
-          free(pin_str);
-          break;
-        }
-      }
+  // Collect the timer channel options of each module
+  bind_request_t requests[BIND_MAX_PWM_MODULES];
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    pin_cap_t *cur_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->pin.port, (uint8_t)(current_module->pin.pin_number));
+    if(cur_cap->pwm_count == 0)
+      log_error("bind_pwm_pins_stm32f446re", 0, "Pin '%s' does not support PWM for module '%s'.",
+                pin_to_string(current_module->pin),
+                current_module->name);
+    
+    requests[i].module = current_module;
+    requests[i].option_count = cur_cap->pwm_count;
+    for(uint8_t j = 0; j < cur_cap->pwm_count; j++){
+      requests[i].resource[j] = cur_cap->pwm[j].tim;
+      requests[i].channel[j]  = cur_cap->pwm[j].ch;
+      requests[i].option[j]   = j;
     }
-    current_module = current_module->next;
+  }
+  
+  uint8_t chosen[BIND_MAX_PWM_MODULES];
+  if(!bind_share_timers(requests, pwm_modules.count, chosen))
+    bind_report_unmatched("bind_pwm_pins_stm32f446re", bind_share_timers, requests, pwm_modules.count, "timer channel", "TIM", "PWM");
+  
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    pin_cap_t *cur_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->pin.port, (uint8_t)(current_module->pin.pin_number));
+    pwm_opt_t *pwm_opt = &cur_cap->pwm[requests[i].option[chosen[i]]];
+    
+    // Assign this timer and channel to the module
+    current_module->data.pwm.tim_number  = pwm_opt->tim;
+    current_module->data.pwm.tim_channel = pwm_opt->ch;
+    current_module->data.pwm.gpio_af     = pwm_opt->af;
+    
+    char* pin_str = pin_to_string(current_module->pin);
+    log_info("bind_pwm_pins_stm32f446re", LOG_OTHER, 0, "Assigned TIM%d_CH%d (AF%d) to PWM module '%s' on pin '%s'.",
+              current_module->data.pwm.tim_number,
+              current_module->data.pwm.tim_channel,
+              current_module->data.pwm.gpio_af,
+              current_module->name,
+              pin_str);
+    free(pin_str);
   }
 }
 
 #define STM32F446RE_TIMER_CLOCK_HZ 84000000u
-#define PWM_FIXED_ARR 999u
-#define PWM_MAX_PRESCALER 0xFFFFu
+#define PWM_MAX_PRESCALER          0xFFFFu      // PSC is 16 bits wide on all timers
+#define PWM_MAX_PERIOD_16BIT       0xFFFFu      // ARR of the 16-bit timers
+#define PWM_MAX_PERIOD_32BIT       0xFFFFFFFFu  // ARR of the 32-bit timers TIM2 and TIM5
+#define PWM_MIN_PERIOD             1u           // ARR = 1 gives the duty cycles 0% and 50%
 
 /**
  * @brief Binds PWM prescaler and period for STM32F446RE.
  * 
- * @param dsl_node Pointer to the DSL node.
+ * @param dsl_node Pointer to the DSL node (enabled modules indexed, timers bound).
+ * 
+ * Selects the prescaler (PSC) and period (ARR) of each PWM output module: the pair whose frequency
+ * TIMER_CLOCK / ((PSC + 1) * (ARR + 1)) is closest to the target frequency, and among those the one with the
+ * largest period (finest duty resolution). The period of the 32-bit timers TIM2 and TIM5 can exceed 16 bits.
  * 
- * Calculates and assigns prescaler and period values for PWM output modules based on target frequency.
+ * @note Modules on the same timer have the same frequency (see bind_pwm_pins_stm32f446re), so they get the same pair.
+ * @note The achieved frequency, its error and the duty resolution are logged for each module (see ast_pwm_timing).
  */
 static void bind_pwm_prescaler_period_stm32f446re(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("bind_pwm_prescaler_period_stm32f446re", 0, "DSL node is NULL.");
   
-  ast_module_node_t* current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && (current_module->kind == MODULE_PWM_OUTPUT)){
-      uint32_t target_freq = current_module->data.pwm.frequency;
-      if(target_freq == 0){
-        log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "PWM frequency cannot be zero for module '%s'.",
-                  current_module->name);
-      }
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    uint64_t target_freq = current_module->data.pwm.frequency;
+    if(target_freq == 0)
+      log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "PWM frequency cannot be zero for module '%s'.",
+                current_module->name);
+    if(target_freq * (PWM_MIN_PERIOD + 1u) > STM32F446RE_TIMER_CLOCK_HZ)
+      log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "Target frequency %u Hz too high for PWM module '%s' (at most %u Hz).",
+                current_module->data.pwm.frequency,
+                current_module->name,
+                STM32F446RE_TIMER_CLOCK_HZ / (PWM_MIN_PERIOD + 1u));
+    
+    bool is_32bit = (current_module->data.pwm.tim_number == 2) || (current_module->data.pwm.tim_number == 5);
+    uint64_t max_divider = (uint64_t)(is_32bit ? PWM_MAX_PERIOD_32BIT : PWM_MAX_PERIOD_16BIT) + 1u;
+    // Lowest frequency: clock / (max_divider * (PWM_MAX_PRESCALER + 1)), rounded up (the product does not fit f * 2^48)
+    uint64_t min_freq = (STM32F446RE_TIMER_CLOCK_HZ + max_divider * (PWM_MAX_PRESCALER + 1u) - 1u) / (max_divider * (PWM_MAX_PRESCALER + 1u));
+    if(target_freq < min_freq)
+      log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "Target frequency %u Hz too low for PWM module '%s' on TIM%u.",
+                current_module->data.pwm.frequency,
+                current_module->name,
+                current_module->data.pwm.tim_number);
+    
+    // For each prescaler divider, the rounded ideal period divider gives the smallest error. The error of a pair is
+    // |clock - target * psc_div * arr_div| / (psc_div * arr_div) (in Hz, times target), compared by cross-multiplication.
+    // Larger prescalers only give smaller periods, so the search stops at the first exact pair.
+    uint64_t best_psc_div = 0, best_arr_div = 0, best_error = 0;
+    uint64_t first_psc_div = (STM32F446RE_TIMER_CLOCK_HZ + target_freq * max_divider - 1u) / (target_freq * max_divider);
+    for(uint64_t psc_div = (first_psc_div > 0) ? first_psc_div : 1u; psc_div <= PWM_MAX_PRESCALER + 1u; psc_div++){
+      uint64_t step = target_freq * psc_div;
+      uint64_t arr_div = (STM32F446RE_TIMER_CLOCK_HZ + step / 2u) / step;
+      if(arr_div > max_divider)
+        arr_div = max_divider;
+      if(arr_div < PWM_MIN_PERIOD + 1u)
+        break;
       
-      // Set period to 999 for 0.1% resolution
-      current_module->data.pwm.period = PWM_FIXED_ARR;
-      
-      // Calculate prescaler
-      const uint32_t denom = (target_freq * (PWM_FIXED_ARR + 1u));
-      if(denom == 0)
-        log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "Invalid calculation for prescaler for module '%s'.",
-                  current_module->name);
-      if(denom > STM32F446RE_TIMER_CLOCK_HZ)
-        log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "Target frequency too low for PWM module '%s'.",
-                  current_module->name);
-      uint32_t prescaler = (STM32F446RE_TIMER_CLOCK_HZ / denom) - 1u;
-      if(prescaler > PWM_MAX_PRESCALER)
-        log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "Calculated prescaler too high for PWM module '%s'.",
-                  current_module->name);
-      current_module->data.pwm.prescaler = (uint16_t)prescaler;
+      uint64_t produced = step * arr_div;
+      uint64_t error = (produced > STM32F446RE_TIMER_CLOCK_HZ) ? (produced - STM32F446RE_TIMER_CLOCK_HZ) : (STM32F446RE_TIMER_CLOCK_HZ - produced);
+      if((best_psc_div == 0) || (error * (best_psc_div * best_arr_div) < best_error * (psc_div * arr_div))){
+        best_psc_div = psc_div;
+        best_arr_div = arr_div;
+        best_error   = error;
+      }
+      if(error == 0)
+        break;
     }
-    current_module = current_module->next;
+    if(best_psc_div == 0)
+      log_error("bind_pwm_prescaler_period_stm32f446re", current_module->line_nr, "No prescaler and period found for PWM module '%s'.",
+                current_module->name);
+    
+    current_module->data.pwm.prescaler = (uint16_t)(best_psc_div - 1u);
+    current_module->data.pwm.period    = (uint32_t)(best_arr_div - 1u);
+    
+    ast_pwm_timing_t timing;
+    ast_check_stm32f446re_pwm_timing(current_module, &timing);
+    log_info("bind_pwm_prescaler_period_stm32f446re", LOG_OTHER, 0, "Selected PSC %u and ARR %u on TIM%u for PWM module '%s': %.3f Hz (requested %u Hz, error %+.1f ppm), %u duty steps (%.1f bits).",
+              current_module->data.pwm.prescaler,
+              current_module->data.pwm.period,
+              current_module->data.pwm.tim_number,
+              current_module->name,
+              timing.achieved_frequency,
+              current_module->data.pwm.frequency,
+              timing.error_ppm,
+              timing.duty_steps,
+              timing.resolution_bits);
   }
 }
 
+/**
+ * @brief Determines the PWM signal of a bound STM32F446RE PWM module (see ast_pwm_timing).
+ * 
+ * @param module Pointer to the PWM module (prescaler and period bound).
+ * @param timing Pointer to store the achieved frequency, its error and the duty resolution in.
+ */
+void ast_check_stm32f446re_pwm_timing(const ast_module_node_t* module, ast_pwm_timing_t* timing){
+  if(module == NULL || timing == NULL)
+    log_error("ast_check_stm32f446re_pwm_timing", 0, "Module or timing is NULL.");
+  
+  double divider = ((double)module->data.pwm.prescaler + 1.0) * ((double)module->data.pwm.period + 1.0);
+  timing->achieved_frequency = (double)STM32F446RE_TIMER_CLOCK_HZ / divider;
+  timing->error_ppm = (module->data.pwm.frequency == 0) ? 0.0 :
+                      (timing->achieved_frequency - module->data.pwm.frequency) / module->data.pwm.frequency * 1e6;
+  timing->duty_steps = (module->data.pwm.period < UINT32_MAX) ? module->data.pwm.period + 1u : UINT32_MAX;
+  timing->resolution_bits = log2((double)module->data.pwm.period + 1.0);
+}
+
+#define STM32F446RE_APB1_CLOCK_HZ 42000000u  // PCLK1 (HCLK / 2) of USART2, USART3, UART4 and UART5
+#define STM32F446RE_APB2_CLOCK_HZ 84000000u  // PCLK2 (HCLK) of USART1 and USART6
+#define UART_MAX_MANTISSA         0xFFFu     // DIV_Mantissa of USART_BRR is 12 bits wide
+
 /**
  * @brief Binds UART pins for STM32F446RE.
  * 
- * @param dsl_node Pointer to the DSL node.
+ * @param dsl_node Pointer to the DSL node (enabled modules indexed).
+ * 
+ * Assigns USART numbers, GPIO alternate function numbers and the oversampling to UART modules, so that every module
+ * gets its own USART that is available on both its TX and its RX pin and generates its baud rate within
+ * STM32F446RE_UART_MAX_ERROR_PPM (see uart_select_oversampling_stm32f446re).
  * 
- * Assigns USART numbers and GPIO alternate function numbers to UART modules based on available options and usage.
+ * @note The assignment is searched for all modules together (see bind_match_resources), so a valid assignment is found
+ *       whenever one exists, independent of the module order.
+ * @note Logs an error and exits if no USART of a module reaches its baud rate, or if the USARTs of the pins do not
+ *       suffice for all UART modules.
  */
 static void bind_uart_pins_stm32f446re(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("bind_uart_pins_stm32f446re", 0, "DSL node is NULL.");
   
-  bool usart_used[7] = { false }; // UART/USART1 to UART/USART6 (0 unused)
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  if(uart_modules.count == 0)
+    return;
+  if(uart_modules.count >= BIND_RESOURCE_LIMIT)
+    log_error("bind_uart_pins_stm32f446re", uart_modules.items[BIND_RESOURCE_LIMIT - 1]->line_nr,
+              "Too many UART modules (%u), each needs its own UART/USART of STM32F446RE.", uart_modules.count);
   
-  ast_module_node_t* current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && (current_module->kind == MODULE_UART)){
-      pin_cap_t *tx_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->pin.port, (uint8_t)(current_module->pin.pin_number));
-      pin_cap_t *rx_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->data.uart.rx_pin.port, (uint8_t)(current_module->data.uart.rx_pin.pin_number));
-      // Find common USART options between tx and rx pins
-      bool usart_assigned = false;
-      for(uint8_t i = 0; i < tx_cap->uart_count && !usart_assigned; i++){
-        uart_opt_t *tx_opt = &tx_cap->uart[i];
-        for(uint8_t j = 0; j < rx_cap->uart_count; j++){
-          uart_opt_t *rx_opt = &rx_cap->uart[j];
-          if((tx_opt->usart == rx_opt->usart) && (tx_opt->is_uart == rx_opt->is_uart)){
-            // Check if this USART is already used
-            if(!usart_used[tx_opt->usart]){
-              // Assign this USART to the module
-              current_module->data.uart.usart_number = tx_opt->usart;
-              current_module->data.uart.is_uart      = tx_opt->is_uart;
-              if(tx_opt->af != rx_opt->af)
-                log_error("bind_uart_pins_stm32f446re", current_module->line_nr, "INTERNAL ERROR: TX pin '%s' and RX pin '%s' for UART module '%s' have different AF numbers.",
-                          pin_to_string(current_module->pin),
-                          pin_to_string(current_module->data.uart.rx_pin),
-                          current_module->name);
-              current_module->data.uart.gpio_af      = tx_opt->af; // TX and RX should have the same AF number
-              usart_used[tx_opt->usart] = true; // Mark USART as used
-              usart_assigned = true;
-              break;
+  // Collect the USARTs common to the TX and RX pin of each module that reach its baud rate (in order of the TX pin options)
+  bind_request_t requests[BIND_RESOURCE_LIMIT];
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    pin_cap_t *tx_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->pin.port, (uint8_t)(current_module->pin.pin_number));
+    pin_cap_t *rx_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->data.uart.rx_pin.port, (uint8_t)(current_module->data.uart.rx_pin.pin_number));
+    
+    requests[i].module = current_module;
+    requests[i].option_count = 0;
+    char rejected[MAX_UART_OPT * 96] = "";  // Common USARTs that miss the baud rate, with the error of each oversampling
+    size_t rejected_length = 0;
+    for(uint8_t j = 0; j < tx_cap->uart_count; j++){
+      uart_opt_t *tx_opt = &tx_cap->uart[j];
+      for(uint8_t k = 0; k < rx_cap->uart_count; k++){
+        uart_opt_t *rx_opt = &rx_cap->uart[k];
+        if((tx_opt->usart == rx_opt->usart) && (tx_opt->is_uart == rx_opt->is_uart)){
+          if(tx_opt->af != rx_opt->af)
+            log_error("bind_uart_pins_stm32f446re", current_module->line_nr, "INTERNAL ERROR: TX pin '%s' and RX pin '%s' for UART module '%s' have different AF numbers.",
+                      pin_to_string(current_module->pin),
+                      pin_to_string(current_module->data.uart.rx_pin),
+                      current_module->name);
+          uart_baud_t baud;
+          if(uart_select_oversampling_stm32f446re(tx_opt->usart, current_module->data.uart.baudrate, &baud) == 0){
+            rejected_length += snprintf(rejected + rejected_length, sizeof(rejected) - rejected_length, "%s%s%u (%.0f MHz):",
+                                        (rejected_length > 0) ? ", " : "",
+                                        tx_opt->is_uart ? "UART" : "USART",
+                                        tx_opt->usart,
+                                        uart_clock_stm32f446re(tx_opt->usart) / 1e6);
+            for(uint8_t oversampling = 16; oversampling >= 8 && rejected_length < sizeof(rejected); oversampling /= 2){
+              if(uart_baud_stm32f446re(tx_opt->usart, current_module->data.uart.baudrate, oversampling, &baud))
+                rejected_length += snprintf(rejected + rejected_length, sizeof(rejected) - rejected_length, "%s%ux %+.2f%%", (oversampling == 16) ? " " : ", ", oversampling, baud.error_ppm / 1e4);
+              else
+                rejected_length += snprintf(rejected + rejected_length, sizeof(rejected) - rejected_length, "%s%ux out of range", (oversampling == 16) ? " " : ", ", oversampling);
             }
+            break;
           }
+          requests[i].resource[requests[i].option_count] = tx_opt->usart;
+          requests[i].channel[requests[i].option_count]  = 0;
+          requests[i].option[requests[i].option_count]   = j;
+          requests[i].option_count++;
+          break;
         }
       }
     }
-    current_module = current_module->next;
+    if(requests[i].option_count == 0 && rejected_length > 0)
+      log_error("bind_uart_pins_stm32f446re", current_module->line_nr, "Baud rate %u of UART module '%s' can not be generated within %.2f%% by any UART/USART of its pins: %s.",
+                current_module->data.uart.baudrate,
+                current_module->name,
+                STM32F446RE_UART_MAX_ERROR_PPM / 1e4,
+                rejected);
+    if(requests[i].option_count == 0)
+      log_error("bind_uart_pins_stm32f446re", current_module->line_nr, "TX pin '%s' and RX pin '%s' of UART module '%s' have no UART/USART in common.",
+                pin_to_string(current_module->pin),
+                pin_to_string(current_module->data.uart.rx_pin),
+                current_module->name);
+  }
+  
+  uint8_t chosen[BIND_RESOURCE_LIMIT];
+  if(!bind_match_resources(requests, uart_modules.count, chosen))
+    bind_report_unmatched("bind_uart_pins_stm32f446re", bind_match_resources, requests, uart_modules.count, "UART/USART", "UART/USART", "UART");
+  
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    pin_cap_t *tx_cap = (pin_cap_t*)pincap_find_stm32f446re(current_module->pin.port, (uint8_t)(current_module->pin.pin_number));
+    uart_opt_t *tx_opt = &tx_cap->uart[requests[i].option[chosen[i]]];
+    
+    // Assign this USART to the module (TX and RX have the same AF number)
+    uart_baud_t baud;
+    current_module->data.uart.usart_number = tx_opt->usart;
+    current_module->data.uart.is_uart      = tx_opt->is_uart;
+    current_module->data.uart.gpio_af      = tx_opt->af;
+    current_module->data.uart.oversampling = uart_select_oversampling_stm32f446re(tx_opt->usart, current_module->data.uart.baudrate, &baud);
+    
+    log_info("bind_uart_pins_stm32f446re", LOG_OTHER, 0, "Assigned %s%d (AF%d) to UART module '%s'.",
+              tx_opt->is_uart ? "UART" : "USART",
+              tx_opt->usart,
+              tx_opt->af,
+              current_module->name);
+    log_info("bind_uart_pins_stm32f446re", LOG_OTHER, 0, "Selected BRR 0x%04X with %ux oversampling on %s%u for UART module '%s': %.1f baud (requested %u, error %+.1f ppm).",
+              baud.brr,
+              current_module->data.uart.oversampling,
+              tx_opt->is_uart ? "UART" : "USART",
+              tx_opt->usart,
+              current_module->name,
+              baud.achieved_baudrate,
+              current_module->data.uart.baudrate,
+              baud.error_ppm);
+  }
+}
+
+
+/* -------------------------------------------- */
+/*              Resource allocation             */
+/* -------------------------------------------- */
+
+/**
+ * @brief Assigns a distinct resource (timer or USART) to every request, choosing one of its options each.
+ * 
+ * @param requests Options of each module, in order of preference.
+ * @param request_count Number of requests (less than BIND_RESOURCE_LIMIT).
+ * @param chosen Array to store the index of the chosen option of each request in.
+ * @return true if an assignment was found, false if none exists.
+ * 
+ * @note Backtracking over the requests in order, trying the options in order of preference, so the first assignment
+ *       found gives each request its earliest option that still allows an assignment for all following requests.
+ * @note The set of used resources determines how many requests are assigned, so it identifies a search state alone.
+ *       States without a solution are remembered, which limits the search to 2^BIND_RESOURCE_LIMIT states.
+ */
+static bool bind_match_resources(const bind_request_t *requests, uint32_t request_count, uint8_t *chosen){
+  uint8_t dead[(1u << BIND_RESOURCE_LIMIT) / 8]; // One bit per set of used resources
+  memset(dead, 0, sizeof(dead));
+  return bind_match_search(requests, request_count, 0, 0, dead, chosen);
+}
+
+/**
+ * @brief Searches an assignment for the requests from index on (see bind_match_resources).
+ * 
+ * @param requests Options of each module, in order of preference.
+ * @param request_count Number of requests.
+ * @param index First request without resource.
+ * @param used Resources used by the requests before index (bit n = resource n).
+ * @param dead Sets of used resources known to have no solution (one bit each).
+ * @param chosen Array to store the index of the chosen option of each request in.
+ * @return true if all requests from index on got a resource, false otherwise.
+ */
+static bool bind_match_search(const bind_request_t *requests, uint32_t request_count, uint32_t index, uint32_t used,
+                              uint8_t *dead, uint8_t *chosen){
+  if(index == request_count)
+    return true;
+  if(dead[used / 8] & (1u << (used % 8)))
+    return false;
+  
+  const bind_request_t *request = &requests[index];
+  for(uint8_t i = 0; i < request->option_count; i++){
+    if(request->resource[i] >= BIND_RESOURCE_LIMIT)
+      log_error("bind_match_search", request->module->line_nr, "INTERNAL ERROR: Resource number %u of module '%s' is out of range.",
+                request->resource[i],
+                request->module->name);
+    
+    uint32_t resource_bit = 1u << request->resource[i];
+    if(used & resource_bit)
+      continue;
+    chosen[index] = i;
+    if(bind_match_search(requests, request_count, index + 1, used | resource_bit, dead, chosen))
+      return true;
+  }
+  
+  dead[used / 8] |= (uint8_t)(1u << (used % 8));
+  return false;
+}
+
+/**
+ * @brief Assigns a timer channel to every PWM request, so that modules on the same timer have the same frequency.
+ * 
+ * @param requests Timer channel options of each PWM module, in order of preference.
+ * @param request_count Number of requests (at most BIND_MAX_PWM_MODULES).
+ * @param chosen Array to store the index of the chosen option of each request in.
+ * @return true if an assignment was found, false if none exists.
+ * 
+ * @note The requests are grouped by frequency (groups in order of their first module). Backtracking over the groups
+ *       gives each group a set of timers that are not used by the groups before it, trying sets with fewer timers first.
+ *       The channels of the timers are then matched to the modules of the group (see bind_share_match_group).
+ * @note The set of timers used by the groups before it identifies the state of a group, and states without
+ *       a solution are remembered, which limits the search to group_count * 2^timer_count states.
+ */
+static bool bind_share_timers(const bind_request_t *requests, uint32_t request_count, uint8_t *chosen){
+  bind_timer_search_t search;
+  memset(&search, 0, sizeof(search));
+  search.requests = requests;
+  search.chosen   = chosen;
+  memset(search.timer_bit, BIND_SLOT_FREE, sizeof(search.timer_bit));
+  memset(search.slot_member, BIND_SLOT_FREE, sizeof(search.slot_member));
+  
+  // Number the timers densely and group the requests by frequency
+  uint8_t group_of[BIND_MAX_PWM_MODULES];
+  for(uint32_t i = 0; i < request_count; i++){
+    const bind_request_t *request = &requests[i];
+    for(uint8_t j = 0; j < request->option_count; j++){
+      if((request->resource[j] >= BIND_RESOURCE_LIMIT) || (request->channel[j] < 1) || (request->channel[j] > BIND_TIMER_CHANNELS))
+        log_error("bind_share_timers", request->module->line_nr, "INTERNAL ERROR: Timer channel TIM%u_CH%u of module '%s' is out of range.",
+                  request->resource[j],
+                  request->channel[j],
+                  request->module->name);
+      if(search.timer_bit[request->resource[j]] == BIND_SLOT_FREE)
+        search.timer_bit[request->resource[j]] = (uint8_t)search.timer_count++;
+    }
+    
+    group_of[i] = (uint8_t)search.group_count;
+    for(uint32_t k = 0; k < i; k++){
+      if(requests[k].module->data.pwm.frequency == request->module->data.pwm.frequency){
+        group_of[i] = group_of[k];
+        break;
+      }
+    }
+    if(group_of[i] == search.group_count)
+      search.group_count++;
+    search.group_size[group_of[i]]++;
+  }
+  for(uint32_t g = 1; g < search.group_count; g++)
+    search.group_first[g] = (uint8_t)(search.group_first[g - 1] + search.group_size[g - 1]);
+  uint8_t filled[BIND_MAX_PWM_MODULES] = {0};
+  for(uint32_t i = 0; i < request_count; i++){
+    search.members[search.group_first[group_of[i]] + filled[group_of[i]]] = (uint8_t)i;
+    filled[group_of[i]]++;
+  }
+  
+  // One bit per group and set of used timers
+  size_t dead_bytes_per_group = ((1u << search.timer_count) + 7u) / 8u;
+  search.dead = calloc(search.group_count, dead_bytes_per_group);
+  if(search.dead == NULL)
+    log_error("bind_share_timers", 0, "Memory allocation failed for the timer allocation of %u PWM modules.", request_count);
+  
+  bool found = bind_share_search(&search, 0, 0);
+  free(search.dead);
+  return found;
+}
+
+/**
+ * @brief Searches timers for the groups from group on (see bind_share_timers).
+ * 
+ * @param search State of the timer allocation.
+ * @param group First group without timers.
+ * @param used Timers used by the groups before group (bit n = dense timer n).
+ * @return true if all groups from group on got their timer channels, false otherwise.
+ */
+static bool bind_share_search(bind_timer_search_t *search, uint32_t group, uint32_t used){
+  if(group == search->group_count)
+    return true;
+  
+  size_t dead_bit = ((size_t)group << search->timer_count) + used;
+  if(search->dead[dead_bit / 8] & (1u << (dead_bit % 8)))
+    return false;
+  
+  // Free timers in the options of the group, in order of preference of its modules
+  uint8_t candidates[BIND_RESOURCE_LIMIT];
+  uint32_t candidate_count = 0;
+  uint32_t candidate_mask = 0;
+  for(uint32_t k = 0; k < search->group_size[group]; k++){
+    const bind_request_t *request = &search->requests[search->members[search->group_first[group] + k]];
+    for(uint8_t j = 0; j < request->option_count; j++){
+      uint32_t timer_mask = 1u << search->timer_bit[request->resource[j]];
+      if((used & timer_mask) || (candidate_mask & timer_mask))
+        continue;
+      candidate_mask |= timer_mask;
+      candidates[candidate_count++] = search->timer_bit[request->resource[j]];
+    }
+  }
+  
+  // Try the subsets of the candidates, fewer timers first (at least one per BIND_TIMER_CHANNELS modules, at most one
+  // per module, as larger sets always have unused timers), and earlier candidates first among subsets of the same size
+  uint32_t min_size = (search->group_size[group] + BIND_TIMER_CHANNELS - 1) / BIND_TIMER_CHANNELS;
+  uint32_t max_size = (candidate_count < search->group_size[group]) ? candidate_count : search->group_size[group];
+  for(uint32_t size = min_size; size <= max_size; size++){
+    uint32_t subset = (1u << size) - 1u;
+    while(subset < (1u << candidate_count)){
+      uint32_t timers = 0;
+      for(uint32_t c = 0; c < candidate_count; c++){
+        if(subset & (1u << c))
+          timers |= 1u << candidates[c];
+      }
+      
+      // A set with unused timers was already tried as the smaller set of its used timers
+      uint32_t timers_used;
+      if(bind_share_match_group(search, group, timers, &timers_used) && (timers_used == timers) &&
+         bind_share_search(search, group + 1, used | timers))
+        return true;
+      
+      // Next larger subset with the same number of candidates
+      uint32_t lowest = subset & (~subset + 1u);
+      uint32_t ripple = subset + lowest;
+      subset = (((ripple ^ subset) >> 2) / lowest) | ripple;
+    }
+  }
+  
+  search->dead[dead_bit / 8] |= (uint8_t)(1u << (dead_bit % 8));
+  return false;
+}
+
+/**
+ * @brief Matches the modules of a group to the channels of a set of timers.
+ * 
+ * @param search State of the timer allocation.
+ * @param group Group to match.
+ * @param timers Timers the group may use (bit n = dense timer n).
+ * @param timers_used Pointer to store the timers used by the matching in.
+ * @return true if every module of the group got a channel, false otherwise.
+ * 
+ * @note Augmenting paths (in module order, options in order of preference) find a matching whenever one exists.
+ *       The chosen options of the modules of the group are stored in search->chosen.
+ */
+static bool bind_share_match_group(bind_timer_search_t *search, uint32_t group, uint32_t timers, uint32_t *timers_used){
+  memset(search->slot_member, BIND_SLOT_FREE, sizeof(search->slot_member));
+  for(uint32_t k = 0; k < search->group_size[group]; k++){
+    memset(search->slot_visited, 0, sizeof(search->slot_visited));
+    if(!bind_share_augment(search, group, timers, (uint8_t)k))
+      return false;
+  }
+  
+  *timers_used = 0;
+  for(uint32_t k = 0; k < search->group_size[group]; k++){
+    uint32_t request_index = search->members[search->group_first[group] + k];
+    const bind_request_t *request = &search->requests[request_index];
+    *timers_used |= 1u << search->timer_bit[request->resource[search->chosen[request_index]]];
   }
+  return true;
+}
+
+/**
+ * @brief Finds a channel for one module of a group, moving other modules of the group to other channels if needed.
+ * 
+ * @param search State of the timer allocation (channels taken by the modules of the group so far).
+ * @param group Group of the module.
+ * @param timers Timers the group may use (bit n = dense timer n).
+ * @param member Index of the module within the group.
+ * @return true if the module got a channel, false otherwise.
+ */
+static bool bind_share_augment(bind_timer_search_t *search, uint32_t group, uint32_t timers, uint8_t member){
+  uint32_t request_index = search->members[search->group_first[group] + member];
+  const bind_request_t *request = &search->requests[request_index];
+  for(uint8_t i = 0; i < request->option_count; i++){
+    uint8_t timer = search->timer_bit[request->resource[i]];
+    uint8_t channel = (uint8_t)(request->channel[i] - 1);
+    if(!(timers & (1u << timer)) || search->slot_visited[timer][channel])
+      continue;
+    search->slot_visited[timer][channel] = true;
+    
+    uint8_t owner = search->slot_member[timer][channel];
+    if((owner == BIND_SLOT_FREE) || bind_share_augment(search, group, timers, owner)){
+      search->slot_member[timer][channel] = member;
+      search->chosen[request_index] = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Logs an error for the first module (in bind order) that can not get a resource together with the modules before it.
+ * 
+ * @param function_name Name of the calling function (for logging purposes).
+ * @param matcher Search that found no assignment for the requests (bind_match_resources or bind_share_timers).
+ * @param requests Options of each module, in order of preference.
+ * @param request_count Number of requests (for which the matcher found no assignment).
+ * @param resource_name Name of the resources (e.g. "timer").
+ * @param resource_prefix Name prefix of a resource number (e.g. "TIM").
+ * @param module_kind Kind of the modules (e.g. "PWM").
+ * 
+ * @note Does not return (log_error exits).
+ */
+static void bind_report_unmatched(const char *function_name, bind_matcher_t matcher, const bind_request_t *requests, uint32_t request_count,
+                                  const char *resource_name, const char *resource_prefix, const char *module_kind){
+  uint8_t chosen[BIND_MAX_PWM_MODULES];
+  uint32_t failing = 1;
+  while(failing < request_count && matcher(requests, failing, chosen))
+    failing++;
+  
+  const bind_request_t *request = &requests[failing - 1];
+  char options[BIND_MAX_OPTIONS * 24] = "";
+  size_t length = 0;
+  for(uint8_t i = 0; i < request->option_count && length < sizeof(options); i++){
+    length += snprintf(options + length, sizeof(options) - length, "%s%s%u", (i > 0) ? ", " : "", resource_prefix, request->resource[i]);
+    if((request->channel[i] != 0) && (length < sizeof(options)))
+      length += snprintf(options + length, sizeof(options) - length, "_CH%u", request->channel[i]);
+  }
+  
+  log_error(function_name, request->module->line_nr, "No %s left for %s module '%s': all of its options (%s) are needed by other %s modules.",
+            resource_name,
+            module_kind,
+            request->module->name,
+            options,
+            module_kind);
 }
 
 
@@ -361,18 +878,96 @@ static void bind_uart_pins_stm32f446re(ast_dsl_node_t* dsl_node){
 /*               Helper functions               */
 /* -------------------------------------------- */
 
+/**
+ * @brief Returns the clock of a UART/USART of the STM32F446RE.
+ * 
+ * @param usart The UART/USART number (1...6).
+ * @return uint32_t The frequency of the APB clock the UART/USART is connected to (Hz).
+ */
+static uint32_t uart_clock_stm32f446re(uint8_t usart){
+  return ((usart == 1) || (usart == 6)) ? STM32F446RE_APB2_CLOCK_HZ : STM32F446RE_APB1_CLOCK_HZ;
+}
+
+/**
+ * @brief Determines the baud rate register and the achieved baud rate of a UART/USART for one oversampling.
+ * 
+ * @param usart The UART/USART number (1...6).
+ * @param baudrate The requested baud rate.
+ * @param oversampling The oversampling (16 or 8, OVER8 = 0 or 1).
+ * @param baud Pointer to store the register value, the achieved baud rate and its error in.
+ * @return true if the divider fits into USART_BRR, false otherwise.
+ * 
+ * Computes USARTDIV = PCLK / (oversampling * baudrate) like HAL_UART_Init (UART_BRR_SAMPLING16 and UART_BRR_SAMPLING8):
+ * truncated to 1/100, then rounded to 4 fraction bits (3 with 8x oversampling).
+ */
+static bool uart_baud_stm32f446re(uint8_t usart, uint32_t baudrate, uint8_t oversampling, uart_baud_t *baud){
+  uint64_t pclk = uart_clock_stm32f446re(usart);
+  uint64_t div100 = (pclk * 25u) / ((uint64_t)(oversampling / 4u) * baudrate);  // 100 * USARTDIV
+  uint64_t mantissa = div100 / 100u;
+  uint64_t fraction = ((div100 - mantissa * 100u) * oversampling + 50u) / 100u;  // Can carry into the mantissa
+  uint64_t divider = mantissa * oversampling + fraction;                         // USARTDIV in 1/oversampling
+  if((divider < oversampling) || (divider / oversampling > UART_MAX_MANTISSA))
+    return false;
+  
+  baud->brr = (uint32_t)((oversampling == 16) ? divider : (((divider / 8u) << 4) | (divider % 8u)));
+  baud->achieved_baudrate = (double)pclk / (double)divider;
+  baud->error_ppm = (baud->achieved_baudrate - baudrate) / baudrate * 1e6;
+  return true;
+}
+
+/**
+ * @brief Selects the oversampling of a UART/USART for a baud rate.
+ * 
+ * @param usart The UART/USART number (1...6).
+ * @param baudrate The requested baud rate.
+ * @param baud Pointer to store the register value, the achieved baud rate and its error of the selected oversampling in.
+ * @return uint8_t 16 if 16x oversampling reaches the baud rate within STM32F446RE_UART_MAX_ERROR_PPM, otherwise 8 if
+ *                 8x oversampling (twice the highest baud rate, less tolerance of the receiver) does, otherwise 0.
+ */
+static uint8_t uart_select_oversampling_stm32f446re(uint8_t usart, uint32_t baudrate, uart_baud_t *baud){
+  for(uint8_t oversampling = 16; oversampling >= 8; oversampling /= 2){
+    if(uart_baud_stm32f446re(usart, baudrate, oversampling, baud) && (fabs(baud->error_ppm) <= STM32F446RE_UART_MAX_ERROR_PPM))
+      return oversampling;
+  }
+  return 0;
+}
+
+/**
+ * @brief Fills the direct pin index from the PINCAP_STM32F446RE table.
+ * 
+ * @note Called exactly once (via pthread_once) before the first lookup. Must return normally (no log_error, which
+ *       would leave the once control in progress), so an entry outside of the index is only recorded and reported
+ *       by pincap_find_stm32f446re.
+ */
+static void pincap_build_index_stm32f446re(){
+  for(uint16_t i = 0; i < PINCAP_STM32F446RE_LEN; i++){
+    const pin_key_t *key = &PINCAP_STM32F446RE[i].pin;
+    if(key->port < 'A' || key->port >= 'A' + STM32F446RE_PORT_COUNT || key->num >= STM32F446RE_PINS_PER_PORT){
+      pincap_index_invalid_stm32f446re = key;
+      return;
+    }
+    pincap_index_stm32f446re[key->port - 'A'][key->num] = &PINCAP_STM32F446RE[i];
+  }
+}
+
 /**
  * @brief Finds the pin capabilities for a given port and pin number on the STM32F446RE.
  * 
  * @param port The port character (e.g., 'A', 'B', 'C').
  * @param num The pin number (0-15).
  * @return const pin_cap_t* Pointer to the pin capabilities structure.
+ * 
+ * @note Constant time lookup in the direct pin index.
  */
 static const pin_cap_t* pincap_find_stm32f446re(char port, uint8_t num){
-  for(uint16_t i = 0; i < PINCAP_STM32F446RE_LEN; i++){
-    if(PINCAP_STM32F446RE[i].pin.port == port && PINCAP_STM32F446RE[i].pin.num == num)
-      return &PINCAP_STM32F446RE[i];
-  }
+  pthread_once(&pincap_index_once_stm32f446re, pincap_build_index_stm32f446re);
+  if(pincap_index_invalid_stm32f446re != NULL)
+    log_error("pincap_find_stm32f446re", 0, "INTERNAL ERROR: Pin 'P%c%d' of the STM32F446RE pin capabilities is outside of the pin index.",
+              pincap_index_invalid_stm32f446re->port, pincap_index_invalid_stm32f446re->num);
+  
+  if(port >= 'A' && port < 'A' + STM32F446RE_PORT_COUNT && num < STM32F446RE_PINS_PER_PORT && pincap_index_stm32f446re[port - 'A'][num] != NULL)
+    return pincap_index_stm32f446re[port - 'A'][num];
+  
   log_error("pincap_find_stm32f446re", 0, "Pin 'P%c%d' not found in STM32F446RE pin capabilities.", port, num);
   return NULL; // This line will never be reached due to log_error exiting the program
-}
\ No newline at end of file
+}
@@ -3,10 +3,21 @@
 
 #include "astEnums.h"
 
+// Pin numbering of STM32F446RE: ports A...H with 16 pins each (index [port - 'A'][num])
+#define STM32F446RE_PORT_COUNT    8
+#define STM32F446RE_PINS_PER_PORT 16
+
+// Largest accepted deviation of a generated UART baud rate (2%), can be set at compile time (e.g. -DSTM32F446RE_UART_MAX_ERROR_PPM=10000)
+// Part of the regeneration cache key (see regenCache.c), as it changes the generated code
+#ifndef STM32F446RE_UART_MAX_ERROR_PPM
+#define STM32F446RE_UART_MAX_ERROR_PPM 20000
+#endif
+
 // Validity checks for STM32F446RE
 void ast_check_stm32f446re_valid_pins(ast_dsl_node_t* dsl_node);
 
 // Backend specific parameter bindings for STM32F446RE
 void ast_check_stm32f446re_bind_pins(ast_dsl_node_t* dsl_node);
+void ast_check_stm32f446re_pwm_timing(const ast_module_node_t* module, ast_pwm_timing_t* timing);
 
 #endif // __AST_CHECK_STM32F446RE_H__
\ No newline at end of file
@@ -17,6 +17,8 @@ typedef enum{
   MODULE_UART
 } ast_module_kind_t;
 
+#define MODULE_KIND_COUNT (MODULE_UART + 1) // Number of module kinds (size of per-kind arrays)
+
 /**
  * @brief Structure representing output module parameters.
  * 
@@ -61,11 +63,23 @@ typedef struct{
   uint32_t     period;        // Timer period selected by generator
 } ast_module_pwm_t;
 
+/**
+ * @brief Structure describing the PWM signal a bound PWM module actually generates (see ast_pwm_timing).
+ * 
+ * Consists of the achieved frequency, its deviation from the requested frequency, and the number of distinct duty cycles.
+ */
+typedef struct{
+  double   achieved_frequency;  // Frequency of the generated signal (Hz)
+  double   error_ppm;           // (achieved - requested) / requested in parts per million
+  uint32_t duty_steps;          // Distinct duty cycles below 100% (compare values 0...period)
+  double   resolution_bits;     // log2(duty_steps)
+} ast_pwm_timing_t;
+
 /**
  * @brief Structure representing UART module parameters.
  * 
  * Consists of RX pins, baud rate, data bits, stop bits, and parity. (TX pin is pin in ast_module_node_t)
- * Includes generator selected parameters like USART number, UART/USART type, and GPIO alternate function number.
+ * Includes generator selected parameters like USART number, UART/USART type, GPIO alternate function number, and oversampling.
  */
 typedef struct{
   pin_t  rx_pin;
@@ -78,6 +92,7 @@ typedef struct{
   uint8_t    usart_number;   // USART number selected by generator
   bool       is_uart;        // true=UART, false=USART
   uint8_t    gpio_af;        // GPIO Alternate Function number selected by generator
+  uint8_t    oversampling;   // Oversampling (16 or 8) selected by generator
 } ast_module_uart_t;
 
 /**
@@ -102,6 +117,16 @@ typedef struct ast_module_node_s{
   struct ast_module_node_s* next;
 } ast_module_node_t;
 
+/**
+ * @brief Structure representing a contiguous range of module nodes.
+ * 
+ * Consists of a pointer to the first element of an array of module node pointers and the number of elements.
+ */
+typedef struct{
+  ast_module_node_t** items;
+  uint32_t            count;
+} ast_module_span_t;
+
 /**
  * @brief Structure for building module nodes in the AST.
  * 
@@ -136,12 +161,13 @@ typedef struct ast_module_builder_s{
 /**
  * @brief Structure for building the DSL node in the AST.
  * 
- * Consists of flag indicating if controller has been set, controller type, and pointer to the module builder list.
+ * Consists of flag indicating if controller has been set, controller type, and pointers to the first and last element of the module builder list.
  */
 typedef struct{
   bool controller_set;
   controller_t controller;
   ast_module_builder_t *module_builders_root;
+  ast_module_builder_t *module_builders_tail;   // Last module builder (for appending in constant time)
 } ast_dsl_builder_t;
 
 
@@ -150,12 +176,20 @@ typedef struct{
 /**
  * @brief Structure representing finished build DSL node in the AST.
  * 
- * Consists of global parameters like controller type and pointer to a linked list of module nodes.
+ * Consists of global parameters like controller type and pointers to the first and last element of a linked list of module nodes.
+ * Includes an index of the enabled modules for the code generators: all enabled modules in list order and
+ * the enabled modules of each kind (in list order), both as contiguous arrays.
  * 
  */
 typedef struct{
   controller_t   controller;
   ast_module_node_t* modules_root;
+  ast_module_node_t* modules_tail;   // Last module node (for appending in constant time)
+  
+  /* index of the enabled modules, built when the module order is final (see ast_index_enabled_modules) */
+  bool               modules_indexed;                     // false until the index is built (or after reordering)
+  ast_module_span_t  enabled_modules;                     // All enabled modules in list order
+  ast_module_span_t  enabled_by_kind[MODULE_KIND_COUNT];  // Enabled modules of each kind, one array grouped by kind
 } ast_dsl_node_t;
 
 #endif //__AST_ENUMS_H__
\ No newline at end of file
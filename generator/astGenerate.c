@@ -1,17 +1,21 @@
 #include "astGenerate.h"
 
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 
 #include "astGenerateSTM32F446RE.h"
 #include "astGenerateESP32.h"
 #include "astHelper.h"
 #include "logging.h"
+#include "generatorOptions.h"
 
-static void generate_header(FILE* output_header, ast_dsl_node_t* dsl_node);
-static void generate_header_gpio_output_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_header_gpio_input_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_header_pwm_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_header_uart_func(FILE* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_header(emitter_t* output_header, ast_dsl_node_t* dsl_node);
+static void generate_header_gpio_output_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_header_gpio_input_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_header_pwm_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_header_uart_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
 /* -------------------------------------------- */
 /*           File management functions          */
@@ -22,44 +26,98 @@ static void generate_header_uart_func(FILE* output_source, ast_dsl_node_t* dsl_n
  * 
  * @param output_path Path to the directory where the generated code files will be created.
  * @param dsl_node Pointer to the DSL AST node from which code will be generated.
+ * @param output_header Emitter the header file is generated into (cleared first, can be reused afterwards).
+ * @param output_source Emitter the source file is generated into (cleared first, can be reused afterwards).
+ * @param emit Files to generate (EMIT_HEADER, EMIT_SOURCE, other bits are ignored).
  * 
  * @note If dsl_node is NULL, an error is logged.
  * @note If output_path is NULL, an error is logged.
+ * @note The selected files are generated completely in memory first and then written with one write per file.
+ * @note Files that already have the generated content are not rewritten (keeps their modification time).
+ * @note Files that are not selected are neither generated nor written (their emitters stay untouched).
  */
-void ast_generate_code(const char* output_path, ast_dsl_node_t* dsl_node){
-  if(dsl_node == NULL)
-    log_error("ast_generate_code", 0, "DSL node is NULL.");
+void ast_generate_code(const char* output_path, ast_dsl_node_t* dsl_node, emitter_t* output_header, emitter_t* output_source, unsigned int emit){
   if(output_path == NULL)
     log_error("ast_generate_code", 0, "Output path is NULL.");
+  if(dsl_node == NULL)
+    log_error("ast_generate_code", 0, "DSL node is NULL.");
   
-  // Generate header file
-  char header_path[256];
-  snprintf(header_path, sizeof(header_path), "%s/generated_bsp.h", output_path);
-  
-  FILE* output_header = fopen(header_path, "w");
   if(output_header == NULL)
-    log_error("ast_generate_code", 0, "Failed to open header file for writing: '%s'", header_path);
-  
-  generate_header(output_header, dsl_node);
-  
-  fclose(output_header);
+    log_error("ast_generate_code", 0, "Output header emitter is NULL.");
+  if(output_source == NULL)
+    log_error("ast_generate_code", 0, "Output source emitter is NULL.");
   
+  // Generate the selected files (before writing any of them)
+  if(emit & EMIT_HEADER){
+    emitter_clear(output_header);
+    generate_header(output_header, dsl_node);
+  }
+  if(emit & EMIT_SOURCE){
+    emitter_clear(output_source);
+    generate_source(output_source, dsl_node);
+  }
   
-  // Generate source file
-  char source_path[256];
-  snprintf(source_path, sizeof(source_path), "%s/generated_bsp.c", output_path);
+  // Write header file
+  if(emit & EMIT_HEADER){
+    char header_path[256];
+    snprintf(header_path, sizeof(header_path), "%s/generated_bsp.h", output_path);
+    emitter_write_result_t result = emitter_write_file(output_header, header_path);
+    if(result == EMITTER_WRITE_FAILED)
+      log_error("ast_generate_code", 0, "Failed to write header file: '%s' (%s)", header_path, strerror(errno));
+    if(result == EMITTER_WRITE_UNCHANGED)
+      log_info("ast_generate_code", LOG_OTHER, 0, "Header file '%s' is unchanged, not rewritten", header_path);
+  }
   
-  FILE* output_source = fopen(source_path, "w");
+  // Write source file
+  if(emit & EMIT_SOURCE){
+    char source_path[256];
+    snprintf(source_path, sizeof(source_path), "%s/generated_bsp.c", output_path);
+    emitter_write_result_t result = emitter_write_file(output_source, source_path);
+    if(result == EMITTER_WRITE_FAILED)
+      log_error("ast_generate_code", 0, "Failed to write source file: '%s' (%s)", source_path, strerror(errno));
+    if(result == EMITTER_WRITE_UNCHANGED)
+      log_info("ast_generate_code", LOG_OTHER, 0, "Source file '%s' is unchanged, not rewritten", source_path);
+  }
+}
+
+/**
+ * @brief Generates the board support package (BSP) header and source code in memory (without touching the filesystem).
+ * 
+ * @param dsl_node Pointer to the DSL AST node from which code will be generated.
+ * @param output_header Emitter the header file is generated into (cleared first).
+ * @param output_source Emitter the source file is generated into (cleared first).
+ * 
+ * @note If any parameter is NULL, an error is logged.
+ */
+void ast_generate_code_to_emitters(ast_dsl_node_t* dsl_node, emitter_t* output_header, emitter_t* output_source){
+  if(dsl_node == NULL)
+    log_error("ast_generate_code_to_emitters", 0, "DSL node is NULL.");
+  if(output_header == NULL)
+    log_error("ast_generate_code_to_emitters", 0, "Output header emitter is NULL.");
   if(output_source == NULL)
-    log_error("ast_generate_code", 0, "Failed to open source file for writing: '%s'", source_path);
+    log_error("ast_generate_code_to_emitters", 0, "Output source emitter is NULL.");
   
+  // Generate header file
+  emitter_clear(output_header);
+  generate_header(output_header, dsl_node);
+  
+  // Generate source file
+  emitter_clear(output_source);
+  generate_source(output_source, dsl_node);
+}
+
+/**
+ * @brief Generates the source file content (dispatches to the controller-specific source code generator).
+ * 
+ * @param output_source Emitter of the output source file.
+ * @param dsl_node Pointer to the DSL AST node containing configuration data.
+ */
+static void generate_source(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   switch(dsl_node->controller){ // Dispatch to controller-specific source code generator
     case STM32F446RE: ast_generate_source_stm32f446re(output_source, dsl_node); break;
     case ESP32:       ast_generate_source_esp32(output_source, dsl_node); break;
-    default:          log_error("ast_generate_code", 0, "Unsupported controller type enum value '%d'", dsl_node->controller);
+    default:          log_error("generate_source", 0, "Unsupported controller type enum value '%d'", dsl_node->controller);
   }
-  
-  fclose(output_source);
 }
 
 
@@ -70,146 +128,118 @@ void ast_generate_code(const char* output_path, ast_dsl_node_t* dsl_node){
 /**
  * @brief Generates the header file content (Is the same for all controllers).
  * 
- * @param output_header File pointer to the output header file.
+ * @param output_header Emitter of the output header file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_header(FILE* output_header, ast_dsl_node_t* dsl_node){
+static void generate_header(emitter_t* output_header, ast_dsl_node_t* dsl_node){
   if(output_header == NULL)
-    log_error("generate_header", 0, "Output header file pointer is NULL.");
+    log_error("generate_header", 0, "Output header emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_header", 0, "DSL node is NULL.");
   
-  fprintf(output_header,"#ifndef __GENERATED_BSP_H__\n");
-  fprintf(output_header,"#define __GENERATED_BSP_H__\n");
+  emitter_append(output_header, "#ifndef __GENERATED_BSP_H__\n");
+  emitter_append(output_header, "#define __GENERATED_BSP_H__\n");
   
-  fprintf(output_header,"\n#include <stdbool.h>");
-  fprintf(output_header,"\n#include <stdint.h>");
+  emitter_append(output_header, "\n#include <stdbool.h>");
+  emitter_append(output_header, "\n#include <stdint.h>");
   
-  fprintf(output_header,"\n\n// Initialization function\n");
-  fprintf(output_header,"void BSP_Init(void);\n\n");
-  fprintf(output_header,"// Delay function\n");
-  fprintf(output_header,"void BSP_DelayMs(uint32_t ms);\n");
+  emitter_append(output_header, "\n\n// Initialization function\n");
+  emitter_append(output_header, "void BSP_Init(void);\n\n");
+  emitter_append(output_header, "// Delay function\n");
+  emitter_append(output_header, "void BSP_DelayMs(uint32_t ms);\n");
   
   generate_header_gpio_output_func(output_header, dsl_node);
   generate_header_gpio_input_func(output_header, dsl_node);
   generate_header_pwm_func(output_header, dsl_node);
   generate_header_uart_func(output_header, dsl_node);
   
-  // Check for unsupported module kinds
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      switch(current_module->kind){
-        case MODULE_OUTPUT:
-        case MODULE_INPUT:
-        case MODULE_PWM_OUTPUT:
-        case MODULE_UART: break;
-        default:
-          log_error("generate_header", 0, "Unsupported module kind enum value '%d' for module '%s'", current_module->kind, current_module->name);
-      }
-    }
-    current_module = current_module->next;
-  }
-  
-  fprintf(output_header,"\n#endif // __GENERATED_BSP_H__");
+  emitter_append(output_header, "\n#endif // __GENERATED_BSP_H__");
 }
 
 /**
  * @brief Generates the header file content for GPIO output functions.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_header_gpio_output_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_header_gpio_output_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_header_gpio_output_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_header_gpio_output_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_header_gpio_output_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_OUTPUT){
-      // Generate function prototypes for output GPIOs
-      fprintf(output_source, "\n// GPIO OUTPUT: '%s'\n", current_module->name);
-      fprintf(output_source, "void BSP_%s_On(void);\n", current_module->name);
-      fprintf(output_source, "void BSP_%s_Off(void);\n", current_module->name);
-      fprintf(output_source, "void BSP_%s_Toggle(void);\n", current_module->name);
-      fprintf(output_source, "void BSP_%s_Set(bool on);\n", current_module->name);
-      fprintf(output_source, "bool BSP_%s_IsOn(void);\n", current_module->name);
-    }
-    current_module = current_module->next;
+  ast_module_span_t output_modules = get_enabled_modules(dsl_node, MODULE_OUTPUT);
+  for(uint32_t i = 0; i < output_modules.count; i++){
+    ast_module_node_t *current_module = output_modules.items[i];
+    // Generate function prototypes for output GPIOs
+    emitter_printf(output_source, "\n// GPIO OUTPUT: '%s'\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_On(void);\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_Off(void);\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_Toggle(void);\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_Set(bool on);\n", current_module->name);
+    emitter_printf(output_source, "bool BSP_%s_IsOn(void);\n", current_module->name);
   }
 }
 
 /**
  * @brief Generates the header file content for GPIO input functions.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_header_gpio_input_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_header_gpio_input_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_header_gpio_input_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_header_gpio_input_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_header_gpio_input_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_INPUT){
-      // Generate function prototypes for input GPIOs
-      fprintf(output_source, "\n// GPIO INPUT: '%s'\n", current_module->name);
-      fprintf(output_source, "bool BSP_%s_IsActive(void);\n", current_module->name);
-    }
-    current_module = current_module->next;
+  ast_module_span_t input_modules = get_enabled_modules(dsl_node, MODULE_INPUT);
+  for(uint32_t i = 0; i < input_modules.count; i++){
+    ast_module_node_t *current_module = input_modules.items[i];
+    // Generate function prototypes for input GPIOs
+    emitter_printf(output_source, "\n// GPIO INPUT: '%s'\n", current_module->name);
+    emitter_printf(output_source, "bool BSP_%s_IsActive(void);\n", current_module->name);
   }
 }
 
 /**
  * @brief Generates the header file content for PWM functions.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_header_pwm_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_header_pwm_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_header_pwm_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_header_pwm_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_header_pwm_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_PWM_OUTPUT){
-        // Generate function prototypes for PWM output modules
-        fprintf(output_source, "\n// PWM OUTPUT: '%s'\n", current_module->name);
-        fprintf(output_source, "void BSP_%s_Start(void);\n", current_module->name);
-        fprintf(output_source, "void BSP_%s_Stop(void);\n", current_module->name);
-        fprintf(output_source, "void BSP_%s_SetDuty(uint16_t permille);\n", current_module->name);
-        fprintf(output_source, "uint16_t BSP_%s_GetDuty(void);\n", current_module->name);
-      }
-    }
-    current_module = current_module->next;
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    // Generate function prototypes for PWM output modules
+    emitter_printf(output_source, "\n// PWM OUTPUT: '%s'\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_Start(void);\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_Stop(void);\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_SetDuty(uint16_t permille);\n", current_module->name);
+    emitter_printf(output_source, "uint16_t BSP_%s_GetDuty(void);\n", current_module->name);
   }
 }
 
-static void generate_header_uart_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_header_uart_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_header_uart_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_header_uart_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_header_uart_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_UART){
-        // Generate function prototypes for UART modules
-        fprintf(output_source, "\n// UART: '%s'\n", current_module->name);
-        fprintf(output_source, "void BSP_%s_TransmitChar(uint8_t ch);\n", current_module->name);
-        fprintf(output_source, "void BSP_%s_TransmitMessage(const char *msg);\n", current_module->name);
-        fprintf(output_source, "bool BSP_%s_ReceiveChar(uint8_t *ch);\n", current_module->name);
-        fprintf(output_source, "bool BSP_%s_TryReceiveChar(uint8_t *ch);\n", current_module->name);
-      }
-    }
-    current_module = current_module->next;
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    // Generate function prototypes for UART modules
+    emitter_printf(output_source, "\n// UART: '%s'\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_TransmitChar(uint8_t ch);\n", current_module->name);
+    emitter_printf(output_source, "void BSP_%s_TransmitMessage(const char *msg);\n", current_module->name);
+    emitter_printf(output_source, "bool BSP_%s_ReceiveChar(uint8_t *ch);\n", current_module->name);
+    emitter_printf(output_source, "bool BSP_%s_TryReceiveChar(uint8_t *ch);\n", current_module->name);
   }
 }
\ No newline at end of file
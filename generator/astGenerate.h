@@ -2,7 +2,9 @@
 #define __AST_GENERATE_H__
 
 #include "astEnums.h"
+#include "emitter.h"
 
-void ast_generate_code(const char* output_path, ast_dsl_node_t* dsl_node);
+void ast_generate_code(const char* output_path, ast_dsl_node_t* dsl_node, emitter_t* output_header, emitter_t* output_source, unsigned int emit);
+void ast_generate_code_to_emitters(ast_dsl_node_t* dsl_node, emitter_t* output_header, emitter_t* output_source);
 
 #endif //__AST_GENERATE_H__
\ No newline at end of file
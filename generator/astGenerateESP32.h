@@ -1,9 +1,9 @@
-#ifndef __AST_CHECK_ESP32_H__
-#define __AST_CHECK_ESP32_H__
+#ifndef __AST_GENERATE_ESP32_H__
+#define __AST_GENERATE_ESP32_H__
 
-#include <stdio.h>
 #include "astEnums.h"
+#include "emitter.h"
 
-void ast_generate_source_esp32(FILE* output_source, ast_dsl_node_t* dsl_node);
+void ast_generate_source_esp32(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
-#endif // __AST_CHECK_ESP32_H__
\ No newline at end of file
+#endif // __AST_GENERATE_ESP32_H__
\ No newline at end of file
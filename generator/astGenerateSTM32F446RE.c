@@ -4,26 +4,29 @@
 #include "logging.h"
 
 #define STM32F446RE_MAX_PORT 'D' // Maximum port letter for STM32F446RE (Port H has no usable pins)
+#define STM32F446RE_TIMER_CHANNELS 4 // Channels of a timer (TIMx_CH1...TIMx_CH4)
 
-static void generate_source_pwm_init_declaration(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_uart_init_declaration(FILE* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_pwm_init_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_uart_init_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
-static void generate_source_timer_handle_declaration(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_uart_handle_declaration(FILE* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_timer_handle_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_uart_handle_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
-static void generate_source_BSP_init_function(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_pwm_init_call(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_uart_init_call(FILE* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_BSP_init_function(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_pwm_init_call(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_uart_init_call(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
-static void generate_source_gpio_init_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_pwm_init_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_uart_init_func(FILE* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_gpio_init_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_pwm_init_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_uart_init_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
-static void generate_source_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_gpio_output_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_gpio_input_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_pwm_output_func(FILE* output_source, ast_dsl_node_t* dsl_node);
-static void generate_source_uart_func(FILE* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_gpio_output_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_gpio_input_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_pwm_output_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+static void generate_source_uart_func(emitter_t* output_source, ast_dsl_node_t* dsl_node);
+
+static bool is_first_pwm_module_on_timer(ast_module_span_t pwm_modules, uint32_t index);
 
 
 /* -------------------------------------------- */
@@ -33,29 +36,29 @@ static void generate_source_uart_func(FILE* output_source, ast_dsl_node_t* dsl_n
 /**
  * @brief Generates the source file content for the STM32F446RE board support package (BSP).
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-void ast_generate_source_stm32f446re(FILE* output_source, ast_dsl_node_t* dsl_node){
+void ast_generate_source_stm32f446re(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("ast_generate_source_stm32f446re", 0, "Output source file pointer is NULL.");
+    log_error("ast_generate_source_stm32f446re", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("ast_generate_source_stm32f446re", 0, "DSL node is NULL.");
   
-  fprintf(output_source, "#include \"generated_bsp.h\"\n\n");
+  emitter_append(output_source, "#include \"generated_bsp.h\"\n\n");
   
   if(has_enabled_uart_module(dsl_node))
-    fprintf(output_source, "#include <string.h>\n\n");
+    emitter_append(output_source, "#include <string.h>\n\n");
   
-  fprintf(output_source, "#include \"stm32f4xx_hal.h\"\n");
+  emitter_append(output_source, "#include \"stm32f4xx_hal.h\"\n");
   
   if(has_enabled_pwm_module(dsl_node) || has_enabled_uart_module(dsl_node)){
-    fprintf(output_source, "\nextern void Error_Handler(void);\n\n");
+    emitter_append(output_source, "\nextern void Error_Handler(void);\n\n");
   }
   
   // Forward declarations of initialization functions
   if(has_enabled_gpio_module(dsl_node))
-    fprintf(output_source, "static void BSP_Init_GPIO(void);\n");
+    emitter_append(output_source, "static void BSP_Init_GPIO(void);\n");
   generate_source_pwm_init_declaration(output_source, dsl_node);
   generate_source_uart_init_declaration(output_source, dsl_node);
   
@@ -63,7 +66,7 @@ void ast_generate_source_stm32f446re(FILE* output_source, ast_dsl_node_t* dsl_no
   generate_source_timer_handle_declaration(output_source, dsl_node);
   generate_source_uart_handle_declaration(output_source, dsl_node);
   
-  fprintf(output_source, "\n\n// ---------- INITIALIZATION FUNCTIONS ----------\n\n");
+  emitter_append(output_source, "\n\n// ---------- INITIALIZATION FUNCTIONS ----------\n\n");
   
   // Generate BSP_Init function
   generate_source_BSP_init_function(output_source, dsl_node);
@@ -85,805 +88,827 @@ void ast_generate_source_stm32f446re(FILE* output_source, ast_dsl_node_t* dsl_no
 /**
  * @brief Generates the PWM initialization function declarations for enabled PWM modules.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_pwm_init_declaration(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_pwm_init_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_pwm_init_declaration", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_pwm_init_declaration", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_pwm_init_declaration", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_PWM_OUTPUT){
-        fprintf(output_source, "static void BSP_Init_PWM_TIM%u(void);\n", current_module->data.pwm.tim_number);
-      }
-    }
-    current_module = current_module->next;
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    if(!is_first_pwm_module_on_timer(pwm_modules, i))
+      continue;
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    emitter_printf(output_source, "static void BSP_Init_PWM_TIM%u(void);\n", current_module->data.pwm.tim_number);
   }
 }
 
 /**
  * @brief Generates the UART initialization function declarations for enabled UART modules.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_uart_init_declaration(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_uart_init_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_uart_init_declaration", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_uart_init_declaration", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_uart_init_declaration", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_UART){
-        fprintf(output_source, "static void BSP_Init_UART_U");
-        if(current_module->data.uart.is_uart)
-          fprintf(output_source, "ART%u(void);\n", current_module->data.uart.usart_number);
-        else
-          fprintf(output_source, "SART%u(void);\n", current_module->data.uart.usart_number);
-      }
-    }
-    current_module = current_module->next;
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    emitter_append(output_source, "static void BSP_Init_UART_U");
+    if(current_module->data.uart.is_uart)
+      emitter_printf(output_source, "ART%u(void);\n", current_module->data.uart.usart_number);
+    else
+      emitter_printf(output_source, "SART%u(void);\n", current_module->data.uart.usart_number);
   }
 }
 
 /**
  * @brief Generates the timer handle declarations for PWM modules.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_timer_handle_declaration(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_timer_handle_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_timer_handle_declaration", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_timer_handle_declaration", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_timer_handle_declaration", 0, "DSL node is NULL.");
   
   bool first_declaration = true;
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_PWM_OUTPUT){
-        if(first_declaration){
-          fprintf(output_source, "\n// Timer handle declarations for PWM modules\n");
-          first_declaration = false;
-        }
-        fprintf(output_source, "static TIM_HandleTypeDef htim%u;\n", current_module->data.pwm.tim_number);
-      }
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    if(!is_first_pwm_module_on_timer(pwm_modules, i))
+      continue;
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    if(first_declaration){
+      emitter_append(output_source, "\n// Timer handle declarations for PWM modules\n");
+      first_declaration = false;
     }
-    current_module = current_module->next;
+    emitter_printf(output_source, "static TIM_HandleTypeDef htim%u;\n", current_module->data.pwm.tim_number);
   }
 }
 
 /**
  * @brief Generates the UART handle declarations for UART modules.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_uart_handle_declaration(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_uart_handle_declaration(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_uart_handle_declaration", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_uart_handle_declaration", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_uart_handle_declaration", 0, "DSL node is NULL.");
   
   bool first_declaration = true;
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_UART){
-        if(first_declaration){
-          fprintf(output_source, "\n// UART handle declarations for UART modules\n");
-          first_declaration = false;
-        }
-        fprintf(output_source, "static UART_HandleTypeDef huart%u;\n", current_module->data.uart.usart_number);
-      }
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    if(first_declaration){
+      emitter_append(output_source, "\n// UART handle declarations for UART modules\n");
+      first_declaration = false;
     }
-    current_module = current_module->next;
+    emitter_printf(output_source, "static UART_HandleTypeDef huart%u;\n", current_module->data.uart.usart_number);
   }
 }
 
 /**
  * @brief Generates the BSP_Init function for the STM32F446RE board support package (BSP).
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_BSP_init_function(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_BSP_init_function(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_BSP_init_function", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_BSP_init_function", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_BSP_init_function", 0, "DSL node is NULL.");
   
-  fprintf(output_source,"/**\n");
-  fprintf(output_source," * @brief Initializes the board support package (BSP) peripherals and GPIOs.\n");
-  fprintf(output_source," */\n");
-  fprintf(output_source,"void BSP_Init(void){\n");
-  fprintf(output_source,"  // Initialize HAL Library\n");
-  fprintf(output_source,"  HAL_Init();\n  \n");
-  fprintf(output_source,"  // Initialize other peripherals\n");
+  emitter_append(output_source, "/**\n");
+  emitter_append(output_source, " * @brief Initializes the board support package (BSP) peripherals and GPIOs.\n");
+  emitter_append(output_source, " */\n");
+  emitter_append(output_source, "void BSP_Init(void){\n");
+  emitter_append(output_source, "  // Initialize HAL Library\n");
+  emitter_append(output_source, "  HAL_Init();\n  \n");
+  emitter_append(output_source, "  // Initialize other peripherals\n");
   if(has_enabled_gpio_module(dsl_node))
-    fprintf(output_source,"  BSP_Init_GPIO();\n");
+    emitter_append(output_source, "  BSP_Init_GPIO();\n");
   generate_source_pwm_init_call(output_source, dsl_node);
   generate_source_uart_init_call(output_source, dsl_node);
-  fprintf(output_source,"}\n");
+  emitter_append(output_source, "}\n");
 }
 
 /**
  * @brief Generates the PWM initialization calls for enabled PWM modules.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_pwm_init_call(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_pwm_init_call(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_pwm_init_call", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_pwm_init_call", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_pwm_init_call", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_PWM_OUTPUT){
-        fprintf(output_source, "  BSP_Init_PWM_TIM%u();\n", current_module->data.pwm.tim_number);
-      }
-    }
-    current_module = current_module->next;
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    if(!is_first_pwm_module_on_timer(pwm_modules, i))
+      continue;
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    emitter_printf(output_source, "  BSP_Init_PWM_TIM%u();\n", current_module->data.pwm.tim_number);
   }
 }
 
 /**
  * @brief Generates the UART initialization calls for enabled UART modules.
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_uart_init_call(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_uart_init_call(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_uart_init_call", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_uart_init_call", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_uart_init_call", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_UART){
-        fprintf(output_source, "  BSP_Init_UART_U");
-        if(current_module->data.uart.is_uart)
-          fprintf(output_source, "ART%u();\n", current_module->data.uart.usart_number);
-        else
-          fprintf(output_source, "SART%u();\n", current_module->data.uart.usart_number);
-      }
-    }
-    current_module = current_module->next;
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    emitter_append(output_source, "  BSP_Init_UART_U");
+    if(current_module->data.uart.is_uart)
+      emitter_printf(output_source, "ART%u();\n", current_module->data.uart.usart_number);
+    else
+      emitter_printf(output_source, "SART%u();\n", current_module->data.uart.usart_number);
   }
 }
 
 /**
  * @brief Generates the GPIO initialization function for the STM32F446RE board support package (BSP).
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_gpio_init_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_gpio_init_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_gpio_init_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_gpio_init_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_gpio_init_func", 0, "DSL node is NULL.");
   
-  fprintf(output_source,"\n/**\n");
-  fprintf(output_source," * @brief Initializes the GPIO pins (inputs and outputs).\n");
-  fprintf(output_source," */\n");
-  fprintf(output_source,"static void BSP_Init_GPIO(void){\n");
-  
-  // Enable all needed GPIO port clocks
-  fprintf(output_source,"  // Enable GPIO ports clock\n");
-  char current_port = 'A';
-  while(current_port <= STM32F446RE_MAX_PORT){
-    ast_module_node_t *current_module = dsl_node->modules_root;
-    bool port_needed = false;
-    while(current_module != NULL){
-      if(current_module->kind == MODULE_OUTPUT || current_module->kind == MODULE_INPUT){
-        if(current_module->enable && current_module->pin.port == current_port){
-          port_needed = true;
-          break;
-        }
-      }
-      current_module = current_module->next;
+  emitter_append(output_source, "\n/**\n");
+  emitter_append(output_source, " * @brief Initializes the GPIO pins (inputs and outputs).\n");
+  emitter_append(output_source, " */\n");
+  emitter_append(output_source, "static void BSP_Init_GPIO(void){\n");
+  
+  // Enable all needed GPIO port clocks (collect the ports of all GPIO modules first)
+  emitter_append(output_source, "  // Enable GPIO ports clock\n");
+  bool port_needed[STM32F446RE_MAX_PORT - 'A' + 1] = {false};
+  ast_module_kind_t gpio_kinds[] = {MODULE_OUTPUT, MODULE_INPUT};
+  for(unsigned int k = 0; k < sizeof(gpio_kinds) / sizeof(gpio_kinds[0]); k++){
+    ast_module_span_t gpio_modules = get_enabled_modules(dsl_node, gpio_kinds[k]);
+    for(uint32_t i = 0; i < gpio_modules.count; i++){
+      char port = gpio_modules.items[i]->pin.port;
+      if(port >= 'A' && port <= STM32F446RE_MAX_PORT)
+        port_needed[port - 'A'] = true;
     }
-    if(port_needed)
-      fprintf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_port);
-    
-    current_port++;
   }
-  fprintf(output_source, "  \n");
-  
-  // Configure GPIO pins
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      if(current_module->kind == MODULE_OUTPUT){
-        fprintf(output_source, "  // Configure OUTPUT GPIO pin: '%s'\n", current_module->name);
-        fprintf(output_source, "  GPIO_InitTypeDef cfg_%s = {\n", current_module->name);
-        fprintf(output_source, "    .Pin   = GPIO_PIN_%u,\n", current_module->pin.pin_number);
-        fprintf(output_source, "    .Mode  = ");
-        switch(current_module->data.output.type){
-          case GPIO_TYPE_PUSHPULL:  fprintf(output_source, "GPIO_MODE_OUTPUT_PP,\n"); break;
-          case GPIO_TYPE_OPENDRAIN: fprintf(output_source, "GPIO_MODE_OUTPUT_OD,\n"); break;
-          default:                  log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO type enum value '%d' for module '%s'", current_module->data.output.type, current_module->name);
-        }
-        fprintf(output_source, "    .Pull  = ");
-        switch(current_module->data.output.pull){
-          case GPIO_PULL_UP:   fprintf(output_source, "GPIO_PULLUP,\n");   break;
-          case GPIO_PULL_DOWN: fprintf(output_source, "GPIO_PULLDOWN,\n"); break;
-          case GPIO_PULL_NONE: fprintf(output_source, "GPIO_NOPULL,\n");   break;
-          default:             log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO pull enum value '%d' for module '%s'", current_module->data.output.pull, current_module->name);
-        }
-        fprintf(output_source, "    .Speed = ");
-        switch(current_module->data.output.speed){
-          case GPIO_SPEED_LOW:        fprintf(output_source, "GPIO_SPEED_FREQ_LOW,\n");        break;
-          case GPIO_SPEED_MEDIUM:     fprintf(output_source, "GPIO_SPEED_FREQ_MEDIUM,\n");     break;
-          case GPIO_SPEED_HIGH:       fprintf(output_source, "GPIO_SPEED_FREQ_HIGH,\n");       break;
-          case GPIO_SPEED_VERY_HIGH:  fprintf(output_source, "GPIO_SPEED_FREQ_VERY_HIGH,\n");  break;
-          default:                    log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO speed enum value '%d' for module '%s'", current_module->data.output.speed, current_module->name);
-        }
-        fprintf(output_source, "  };\n");
-        fprintf(output_source, "  HAL_GPIO_Init(GPIO%c, &cfg_%s);\n", current_module->pin.port, current_module->name);
-        // Set initial level if specified
-        if(current_module->data.output.init == GPIO_INIT_ON){
-          if(current_module->data.output.active_level == HIGH)
-            fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_SET);\n", current_module->pin.port, current_module->pin.pin_number);
-          else // active_level == LOW
-            fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_RESET);\n", current_module->pin.port, current_module->pin.pin_number);
-        } else if(current_module->data.output.init == GPIO_INIT_OFF){
-          if(current_module->data.output.active_level == HIGH)
-            fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_RESET);\n", current_module->pin.port, current_module->pin.pin_number);
-          else // active_level == LOW
-            fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_SET);\n", current_module->pin.port, current_module->pin.pin_number);
-        }
+  for(char current_port = 'A'; current_port <= STM32F446RE_MAX_PORT; current_port++){
+    if(port_needed[current_port - 'A'])
+      emitter_printf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_port);
+  }
+  emitter_append(output_source, "  \n");
+  
+  // Configure GPIO pins (outputs and inputs in pin order)
+  for(uint32_t i = 0; i < dsl_node->enabled_modules.count; i++){
+    ast_module_node_t *current_module = dsl_node->enabled_modules.items[i];
+    if(current_module->kind == MODULE_OUTPUT){
+      emitter_printf(output_source, "  // Configure OUTPUT GPIO pin: '%s'\n", current_module->name);
+      emitter_printf(output_source, "  GPIO_InitTypeDef cfg_%s = {\n", current_module->name);
+      emitter_printf(output_source, "    .Pin   = GPIO_PIN_%u,\n", current_module->pin.pin_number);
+      emitter_append(output_source, "    .Mode  = ");
+      switch(current_module->data.output.type){
+        case GPIO_TYPE_PUSHPULL:  emitter_append(output_source, "GPIO_MODE_OUTPUT_PP,\n"); break;
+        case GPIO_TYPE_OPENDRAIN: emitter_append(output_source, "GPIO_MODE_OUTPUT_OD,\n"); break;
+        default:                  log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO type enum value '%d' for module '%s'", current_module->data.output.type, current_module->name);
+      }
+      emitter_append(output_source, "    .Pull  = ");
+      switch(current_module->data.output.pull){
+        case GPIO_PULL_UP:   emitter_append(output_source, "GPIO_PULLUP,\n");   break;
+        case GPIO_PULL_DOWN: emitter_append(output_source, "GPIO_PULLDOWN,\n"); break;
+        case GPIO_PULL_NONE: emitter_append(output_source, "GPIO_NOPULL,\n");   break;
+        default:             log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO pull enum value '%d' for module '%s'", current_module->data.output.pull, current_module->name);
       }
-      else if(current_module->kind == MODULE_INPUT){
-        fprintf(output_source, "  \n  // Configure INPUT GPIO pin: '%s'\n", current_module->name);
-        fprintf(output_source, "  GPIO_InitTypeDef cfg_%s = {\n", current_module->name);
-        fprintf(output_source, "    .Pin  = GPIO_PIN_%u,\n", current_module->pin.pin_number);
-        fprintf(output_source, "    .Mode = GPIO_MODE_INPUT,\n");
-        fprintf(output_source, "    .Pull = ");
-        switch(current_module->data.input.pull){
-          case GPIO_PULL_UP:   fprintf(output_source, "GPIO_PULLUP,\n");   break;
-          case GPIO_PULL_DOWN: fprintf(output_source, "GPIO_PULLDOWN,\n"); break;
-          case GPIO_PULL_NONE: fprintf(output_source, "GPIO_NOPULL,\n");   break;
-          default:             log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO pull enum value '%d' for module '%s'", current_module->data.input.pull, current_module->name);
-        }
-        fprintf(output_source, "  };\n");
-        fprintf(output_source, "  HAL_GPIO_Init(GPIO%c, &cfg_%s);\n", current_module->pin.port, current_module->name);
+      emitter_append(output_source, "    .Speed = ");
+      switch(current_module->data.output.speed){
+        case GPIO_SPEED_LOW:        emitter_append(output_source, "GPIO_SPEED_FREQ_LOW,\n");        break;
+        case GPIO_SPEED_MEDIUM:     emitter_append(output_source, "GPIO_SPEED_FREQ_MEDIUM,\n");     break;
+        case GPIO_SPEED_HIGH:       emitter_append(output_source, "GPIO_SPEED_FREQ_HIGH,\n");       break;
+        case GPIO_SPEED_VERY_HIGH:  emitter_append(output_source, "GPIO_SPEED_FREQ_VERY_HIGH,\n");  break;
+        default:                    log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO speed enum value '%d' for module '%s'", current_module->data.output.speed, current_module->name);
+      }
+      emitter_append(output_source, "  };\n");
+      emitter_printf(output_source, "  HAL_GPIO_Init(GPIO%c, &cfg_%s);\n", current_module->pin.port, current_module->name);
+      // Set initial level if specified
+      if(current_module->data.output.init == GPIO_INIT_ON){
+        if(current_module->data.output.active_level == HIGH)
+          emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_SET);\n", current_module->pin.port, current_module->pin.pin_number);
+        else // active_level == LOW
+          emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_RESET);\n", current_module->pin.port, current_module->pin.pin_number);
+      } else if(current_module->data.output.init == GPIO_INIT_OFF){
+        if(current_module->data.output.active_level == HIGH)
+          emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_RESET);\n", current_module->pin.port, current_module->pin.pin_number);
+        else // active_level == LOW
+          emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_SET);\n", current_module->pin.port, current_module->pin.pin_number);
       }
     }
-    current_module = current_module->next;
+    else if(current_module->kind == MODULE_INPUT){
+      emitter_printf(output_source, "  \n  // Configure INPUT GPIO pin: '%s'\n", current_module->name);
+      emitter_printf(output_source, "  GPIO_InitTypeDef cfg_%s = {\n", current_module->name);
+      emitter_printf(output_source, "    .Pin  = GPIO_PIN_%u,\n", current_module->pin.pin_number);
+      emitter_append(output_source, "    .Mode = GPIO_MODE_INPUT,\n");
+      emitter_append(output_source, "    .Pull = ");
+      switch(current_module->data.input.pull){
+        case GPIO_PULL_UP:   emitter_append(output_source, "GPIO_PULLUP,\n");   break;
+        case GPIO_PULL_DOWN: emitter_append(output_source, "GPIO_PULLDOWN,\n"); break;
+        case GPIO_PULL_NONE: emitter_append(output_source, "GPIO_NOPULL,\n");   break;
+        default:             log_error("generate_source_gpio_init_func", 0, "Unsupported GPIO pull enum value '%d' for module '%s'", current_module->data.input.pull, current_module->name);
+      }
+      emitter_append(output_source, "  };\n");
+      emitter_printf(output_source, "  HAL_GPIO_Init(GPIO%c, &cfg_%s);\n", current_module->pin.port, current_module->name);
+    }
   }
   
-  fprintf(output_source,"}\n");
+  emitter_append(output_source, "}\n");
 }
 
 /**
- * @brief Generates the PWM initialization function for the STM32F446RE board support package (BSP).
+ * @brief Generates the PWM initialization functions for the STM32F446RE board support package (BSP).
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
+ * 
+ * Generates one function per used timer, which configures the timer once and every channel used by a PWM module
+ * (modules on the same timer have the same prescaler and period, see bind_pwm_pins_stm32f446re).
  */
-static void generate_source_pwm_init_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_pwm_init_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_pwm_init_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_pwm_init_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_pwm_init_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_PWM_OUTPUT){
-      // Generate PWM initialization function
-      fprintf(output_source, "\n/**\n");
-      fprintf(output_source, " * @brief Initializes the PWM on TIM%u for module '%s'.\n", current_module->data.pwm.tim_number, current_module->name);
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "static void BSP_Init_PWM_TIM%u(void){\n", current_module->data.pwm.tim_number);
-      
-      fprintf(output_source, "  // Enable clocks\n");
-      fprintf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->pin.port);
-      fprintf(output_source, "  __HAL_RCC_TIM%u_CLK_ENABLE();\n", current_module->data.pwm.tim_number);
-      fprintf(output_source, "  \n");
-      
-      fprintf(output_source, "  // Configure GPIO pin for PWM output\n");
-      fprintf(output_source, "  GPIO_InitTypeDef GPIO_InitStruct = {0};\n");
-      fprintf(output_source, "  GPIO_InitStruct.Pin       = GPIO_PIN_%u;\n", current_module->pin.pin_number);
-      fprintf(output_source, "  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;\n");
-      fprintf(output_source, "  GPIO_InitStruct.Pull      = ");
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    if(!is_first_pwm_module_on_timer(pwm_modules, i))
+      continue;
+    ast_module_node_t *timer_module = pwm_modules.items[i];
+    uint32_t tim_number = timer_module->data.pwm.tim_number;
+    
+    // Modules on this timer (in module order, starting with timer_module)
+    ast_module_node_t *timer_modules[STM32F446RE_TIMER_CHANNELS];
+    uint32_t timer_module_count = 0;
+    for(uint32_t j = i; j < pwm_modules.count; j++){
+      if(pwm_modules.items[j]->data.pwm.tim_number != tim_number)
+        continue;
+      if(timer_module_count == STM32F446RE_TIMER_CHANNELS)
+        log_error("generate_source_pwm_init_func", pwm_modules.items[j]->line_nr, "More than %u PWM modules on TIM%u (module '%s').",
+                  STM32F446RE_TIMER_CHANNELS,
+                  tim_number,
+                  pwm_modules.items[j]->name);
+      if((pwm_modules.items[j]->data.pwm.prescaler != timer_module->data.pwm.prescaler) ||
+         (pwm_modules.items[j]->data.pwm.period != timer_module->data.pwm.period))
+        log_error("generate_source_pwm_init_func", pwm_modules.items[j]->line_nr, "PWM module '%s' shares TIM%u with module '%s' but needs another prescaler or period.",
+                  pwm_modules.items[j]->name,
+                  tim_number,
+                  timer_module->name);
+      timer_modules[timer_module_count++] = pwm_modules.items[j];
+    }
+    bool shared = (timer_module_count > 1);
+    
+    // Generate PWM initialization function
+    emitter_append(output_source, "\n/**\n");
+    emitter_printf(output_source, " * @brief Initializes the PWM on TIM%u for module%s ", tim_number, shared ? "s" : "");
+    for(uint32_t k = 0; k < timer_module_count; k++)
+      emitter_printf(output_source, "%s'%s'", (k > 0) ? ", " : "", timer_modules[k]->name);
+    emitter_append(output_source, ".\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "static void BSP_Init_PWM_TIM%u(void){\n", tim_number);
+    
+    emitter_append(output_source, "  // Enable clocks\n");
+    for(uint32_t k = 0; k < timer_module_count; k++){
+      bool port_enabled = false;
+      for(uint32_t m = 0; m < k; m++)
+        port_enabled |= (timer_modules[m]->pin.port == timer_modules[k]->pin.port);
+      if(!port_enabled)
+        emitter_printf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", timer_modules[k]->pin.port);
+    }
+    emitter_printf(output_source, "  __HAL_RCC_TIM%u_CLK_ENABLE();\n", tim_number);
+    emitter_append(output_source, "  \n");
+    
+    emitter_printf(output_source, "  // Configure GPIO pin%s for PWM output\n", shared ? "s" : "");
+    emitter_append(output_source, "  GPIO_InitTypeDef GPIO_InitStruct = {0};\n");
+    for(uint32_t k = 0; k < timer_module_count; k++){
+      ast_module_node_t *current_module = timer_modules[k];
+      if(k > 0)
+        emitter_append(output_source, "  \n");
+      emitter_printf(output_source, "  GPIO_InitStruct.Pin       = GPIO_PIN_%u;\n", current_module->pin.pin_number);
+      emitter_append(output_source, "  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;\n");
+      emitter_append(output_source, "  GPIO_InitStruct.Pull      = ");
       switch(current_module->data.pwm.pull){
-        case GPIO_PULL_UP:   fprintf(output_source, "GPIO_PULLUP;\n");   break;
-        case GPIO_PULL_DOWN: fprintf(output_source, "GPIO_PULLDOWN;\n"); break;
-        case GPIO_PULL_NONE: fprintf(output_source, "GPIO_NOPULL;\n");   break;
+        case GPIO_PULL_UP:   emitter_append(output_source, "GPIO_PULLUP;\n");   break;
+        case GPIO_PULL_DOWN: emitter_append(output_source, "GPIO_PULLDOWN;\n"); break;
+        case GPIO_PULL_NONE: emitter_append(output_source, "GPIO_NOPULL;\n");   break;
         default:             log_error("generate_source_pwm_init_func", 0, "Unsupported GPIO pull enum value '%d' for module '%s'", current_module->data.pwm.pull, current_module->name);
       }
-      fprintf(output_source, "  GPIO_InitStruct.Speed     = ");
+      emitter_append(output_source, "  GPIO_InitStruct.Speed     = ");
       switch(current_module->data.pwm.speed){
-        case GPIO_SPEED_LOW:        fprintf(output_source, "GPIO_SPEED_FREQ_LOW;\n");        break;
-        case GPIO_SPEED_MEDIUM:     fprintf(output_source, "GPIO_SPEED_FREQ_MEDIUM;\n");     break;
-        case GPIO_SPEED_HIGH:       fprintf(output_source, "GPIO_SPEED_FREQ_HIGH;\n");       break;
-        case GPIO_SPEED_VERY_HIGH:  fprintf(output_source, "GPIO_SPEED_FREQ_VERY_HIGH;\n");  break;
+        case GPIO_SPEED_LOW:        emitter_append(output_source, "GPIO_SPEED_FREQ_LOW;\n");        break;
+        case GPIO_SPEED_MEDIUM:     emitter_append(output_source, "GPIO_SPEED_FREQ_MEDIUM;\n");     break;
+        case GPIO_SPEED_HIGH:       emitter_append(output_source, "GPIO_SPEED_FREQ_HIGH;\n");       break;
+        case GPIO_SPEED_VERY_HIGH:  emitter_append(output_source, "GPIO_SPEED_FREQ_VERY_HIGH;\n");  break;
         default:                    log_error("generate_source_pwm_init_func", 0, "Unsupported GPIO speed enum value '%d' for module '%s'", current_module->data.pwm.speed, current_module->name);
       }
-      fprintf(output_source, "  GPIO_InitStruct.Alternate = GPIO_AF%u_TIM%u;\n", current_module->data.pwm.gpio_af, current_module->data.pwm.tim_number);
-      fprintf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct);\n", current_module->pin.port);
-      fprintf(output_source, "  \n");
-      
-      fprintf(output_source, "  // Configure TIM%u for PWM\n", current_module->data.pwm.tim_number);
-      fprintf(output_source, "  htim%u.Instance               = TIM%u;\n", current_module->data.pwm.tim_number, current_module->data.pwm.tim_number);
-      fprintf(output_source, "  htim%u.Init.Prescaler         = %u;\n", current_module->data.pwm.tim_number, current_module->data.pwm.prescaler);
-      fprintf(output_source, "  htim%u.Init.CounterMode       = TIM_COUNTERMODE_UP;\n", current_module->data.pwm.tim_number);
-      fprintf(output_source, "  htim%u.Init.Period            = %u;\n", current_module->data.pwm.tim_number, current_module->data.pwm.period);
-      fprintf(output_source, "  htim%u.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;\n", current_module->data.pwm.tim_number);
-      fprintf(output_source, "  htim%u.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;\n", current_module->data.pwm.tim_number);
-      fprintf(output_source, "  if(HAL_TIM_PWM_Init(&htim%u) != HAL_OK)\n", current_module->data.pwm.tim_number);
-      fprintf(output_source, "    Error_Handler();\n");
-      fprintf(output_source, "  \n");
-      
-      fprintf(output_source, "  // Configure PWM channel\n");
-      fprintf(output_source, "  TIM_OC_InitTypeDef sConfigOC = {0};\n");
-      fprintf(output_source, "  sConfigOC.OCMode        = TIM_OCMODE_PWM1;\n"); // Is always PWM1 (PWM2 would be inverted)
-      fprintf(output_source, "  sConfigOC.Pulse         = 0;\n");
-      fprintf(output_source, "  sConfigOC.OCPolarity    = ");
+      emitter_printf(output_source, "  GPIO_InitStruct.Alternate = GPIO_AF%u_TIM%u;\n", current_module->data.pwm.gpio_af, tim_number);
+      emitter_printf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct);\n", current_module->pin.port);
+    }
+    emitter_append(output_source, "  \n");
+    
+    emitter_printf(output_source, "  // Configure TIM%u for PWM\n", tim_number);
+    emitter_printf(output_source, "  htim%u.Instance               = TIM%u;\n", tim_number, tim_number);
+    emitter_printf(output_source, "  htim%u.Init.Prescaler         = %u;\n", tim_number, timer_module->data.pwm.prescaler);
+    emitter_printf(output_source, "  htim%u.Init.CounterMode       = TIM_COUNTERMODE_UP;\n", tim_number);
+    emitter_printf(output_source, "  htim%u.Init.Period            = %u;\n", tim_number, timer_module->data.pwm.period);
+    emitter_printf(output_source, "  htim%u.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;\n", tim_number);
+    emitter_printf(output_source, "  htim%u.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;\n", tim_number);
+    emitter_printf(output_source, "  if(HAL_TIM_PWM_Init(&htim%u) != HAL_OK)\n", tim_number);
+    emitter_append(output_source, "    Error_Handler();\n");
+    emitter_append(output_source, "  \n");
+    
+    emitter_printf(output_source, "  // Configure PWM channel%s\n", shared ? "s" : "");
+    emitter_append(output_source, "  TIM_OC_InitTypeDef sConfigOC = {0};\n");
+    emitter_append(output_source, "  sConfigOC.OCMode        = TIM_OCMODE_PWM1;\n"); // Is always PWM1 (PWM2 would be inverted)
+    emitter_append(output_source, "  sConfigOC.Pulse         = 0;\n");
+    for(uint32_t k = 0; k < timer_module_count; k++){
+      ast_module_node_t *current_module = timer_modules[k];
+      if(k > 0)
+        emitter_append(output_source, "  \n");
+      emitter_append(output_source, "  sConfigOC.OCPolarity    = ");
       if(current_module->data.pwm.active_level == HIGH)
-        fprintf(output_source, "TIM_OCPOLARITY_HIGH;\n");
+        emitter_append(output_source, "TIM_OCPOLARITY_HIGH;\n");
       else
-        fprintf(output_source, "TIM_OCPOLARITY_LOW;\n");
-      fprintf(output_source, "  sConfigOC.OCFastMode    = TIM_OCFAST_DISABLE;\n");
-      fprintf(output_source, "  if(HAL_TIM_PWM_ConfigChannel(&htim%u, &sConfigOC, TIM_CHANNEL_%u) != HAL_OK)\n", current_module->data.pwm.tim_number, current_module->data.pwm.tim_channel);
-      fprintf(output_source, "    Error_Handler();\n");
-      fprintf(output_source, "  \n");
-      
-      fprintf(output_source, "  // Ensure PWM is stopped initially\n");
-      fprintf(output_source, "  __HAL_TIM_SET_COMPARE(&htim%u, TIM_CHANNEL_%u, 0);\n", current_module->data.pwm.tim_number, current_module->data.pwm.tim_channel);
-      
-      fprintf(output_source, "}\n");
+        emitter_append(output_source, "TIM_OCPOLARITY_LOW;\n");
+      if(k == 0)
+        emitter_append(output_source, "  sConfigOC.OCFastMode    = TIM_OCFAST_DISABLE;\n");
+      emitter_printf(output_source, "  if(HAL_TIM_PWM_ConfigChannel(&htim%u, &sConfigOC, TIM_CHANNEL_%u) != HAL_OK)\n", tim_number, current_module->data.pwm.tim_channel);
+      emitter_append(output_source, "    Error_Handler();\n");
     }
-    current_module = current_module->next;
+    emitter_append(output_source, "  \n");
+    
+    emitter_append(output_source, "  // Ensure PWM is stopped initially\n");
+    for(uint32_t k = 0; k < timer_module_count; k++)
+      emitter_printf(output_source, "  __HAL_TIM_SET_COMPARE(&htim%u, TIM_CHANNEL_%u, 0);\n", tim_number, timer_modules[k]->data.pwm.tim_channel);
+    
+    emitter_append(output_source, "}\n");
   }
 }
 
 /**
  * @brief Generates the UART initialization functions for all enabled UART modules.
  * 
- * @param output_source The file pointer to the output source file.
+ * @param output_source The emitter of the output source file.
  * @param dsl_node The root node of the DSL AST.
  */
-static void generate_source_uart_init_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_uart_init_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_uart_init_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_uart_init_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_uart_init_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_UART){
-      // Generate UART initialization function
-      fprintf(output_source, "\n/**\n");
-      fprintf(output_source, " * @brief Initializes the UART on %s%u for module '%s'.\n",
-              current_module->data.uart.is_uart ? "UART" : "USART",
-              current_module->data.uart.usart_number,
-              current_module->name);
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "static void BSP_Init_UART_U");
-      if(current_module->data.uart.is_uart)
-        fprintf(output_source, "ART%u(void){\n", current_module->data.uart.usart_number);
-      else
-        fprintf(output_source, "SART%u(void){\n", current_module->data.uart.usart_number);
-      
-      // Configure GPIO pins if UART/USART is on the same port (all cases except UART5 with tx PC12 and rx PD2)
-      if(current_module->pin.port == current_module->data.uart.rx_pin.port){
-        fprintf(output_source, "  // Enable GPIO port clock\n");
-        fprintf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->pin.port);
-        fprintf(output_source, "  \n");
-        
-        fprintf(output_source, "  // Configure GPIO pins for UART TX and RX\n");
-        fprintf(output_source, "  GPIO_InitTypeDef GPIO_InitStruct = {0};\n");
-        fprintf(output_source, "  GPIO_InitStruct.Pin       = GPIO_PIN_%u|GPIO_PIN_%u;\n", current_module->pin.pin_number, current_module->data.uart.rx_pin.pin_number);
-        fprintf(output_source, "  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;\n");
-        fprintf(output_source, "  GPIO_InitStruct.Pull      = GPIO_NOPULL;\n");
-        fprintf(output_source, "  GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;\n");
-        fprintf(output_source, "  GPIO_InitStruct.Alternate = GPIO_AF%u_U", current_module->data.uart.gpio_af);
-        if(current_module->data.uart.is_uart)
-          fprintf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
-        else
-          fprintf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
-        fprintf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct);\n  \n", current_module->pin.port);
-      } else{ // Special case TX and RX are not on the same port (e.g. UART5 with tx PC12 and rx PD2)
-        fprintf(output_source, "  // Enable GPIO port clocks\n");
-        fprintf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->pin.port);
-        fprintf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->data.uart.rx_pin.port);
-        fprintf(output_source, "  \n");
-        
-        fprintf(output_source, "  // Configure GPIO pin for UART TX\n");
-        fprintf(output_source, "  GPIO_InitTypeDef GPIO_InitStruct_TX = {0};\n");
-        fprintf(output_source, "  GPIO_InitStruct_TX.Pin       = GPIO_PIN_%u;\n", current_module->pin.pin_number);
-        fprintf(output_source, "  GPIO_InitStruct_TX.Mode      = GPIO_MODE_AF_PP;\n");
-        fprintf(output_source, "  GPIO_InitStruct_TX.Pull      = GPIO_NOPULL;\n");
-        fprintf(output_source, "  GPIO_InitStruct_TX.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;\n");
-        fprintf(output_source, "  GPIO_InitStruct_TX.Alternate = GPIO_AF%u_U", current_module->data.uart.gpio_af);
-        if(current_module->data.uart.is_uart)
-          fprintf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
-        else
-          fprintf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
-        fprintf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct_TX);\n  \n", current_module->pin.port);
-        
-        fprintf(output_source, "  // Configure GPIO pin for UART RX\n");
-        fprintf(output_source, "  GPIO_InitTypeDef GPIO_InitStruct_RX = {0};\n");
-        fprintf(output_source, "  GPIO_InitStruct_RX.Pin       = GPIO_PIN_%u;\n", current_module->data.uart.rx_pin.pin_number);
-        fprintf(output_source, "  GPIO_InitStruct_RX.Mode      = GPIO_MODE_AF_PP;\n");
-        fprintf(output_source, "  GPIO_InitStruct_RX.Pull      = GPIO_NOPULL;\n");
-        fprintf(output_source, "  GPIO_InitStruct_RX.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;\n");
-        fprintf(output_source, "  GPIO_InitStruct_RX.Alternate = GPIO_AF%u_U", current_module->data.uart.gpio_af);
-        if(current_module->data.uart.is_uart)
-          fprintf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
-        else
-          fprintf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
-        fprintf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct_RX);\n  \n", current_module->data.uart.rx_pin.port);
-      }
-        
-      fprintf(output_source, "  // Enable UART%u peripheral clock\n", current_module->data.uart.usart_number);
-      fprintf(output_source, "  __HAL_RCC_U");
-      if(current_module->data.uart.is_uart)
-        fprintf(output_source, "ART%u_CLK_ENABLE();\n  \n", current_module->data.uart.usart_number);
-      else
-        fprintf(output_source, "SART%u_CLK_ENABLE();\n  \n", current_module->data.uart.usart_number);
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    // Generate UART initialization function
+    emitter_append(output_source, "\n/**\n");
+    emitter_printf(output_source, " * @brief Initializes the UART on %s%u for module '%s'.\n",
+                   current_module->data.uart.is_uart ? "UART" : "USART",
+                   current_module->data.uart.usart_number,
+                   current_module->name);
+    emitter_append(output_source, " */\n");
+    emitter_append(output_source, "static void BSP_Init_UART_U");
+    if(current_module->data.uart.is_uart)
+      emitter_printf(output_source, "ART%u(void){\n", current_module->data.uart.usart_number);
+    else
+      emitter_printf(output_source, "SART%u(void){\n", current_module->data.uart.usart_number);
     
-      // UART configuration
-      fprintf(output_source, "  // Configure UART%u\n", current_module->data.uart.usart_number);
+    // Configure GPIO pins if UART/USART is on the same port (all cases except UART5 with tx PC12 and rx PD2)
+    if(current_module->pin.port == current_module->data.uart.rx_pin.port){
+      emitter_append(output_source, "  // Enable GPIO port clock\n");
+      emitter_printf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->pin.port);
+      emitter_append(output_source, "  \n");
       
-      fprintf(output_source, "  huart%u.Instance          = U", current_module->data.uart.usart_number);
+      emitter_append(output_source, "  // Configure GPIO pins for UART TX and RX\n");
+      emitter_append(output_source, "  GPIO_InitTypeDef GPIO_InitStruct = {0};\n");
+      emitter_printf(output_source, "  GPIO_InitStruct.Pin       = GPIO_PIN_%u|GPIO_PIN_%u;\n", current_module->pin.pin_number, current_module->data.uart.rx_pin.pin_number);
+      emitter_append(output_source, "  GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;\n");
+      emitter_append(output_source, "  GPIO_InitStruct.Pull      = GPIO_NOPULL;\n");
+      emitter_append(output_source, "  GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;\n");
+      emitter_printf(output_source, "  GPIO_InitStruct.Alternate = GPIO_AF%u_U", current_module->data.uart.gpio_af);
       if(current_module->data.uart.is_uart)
-        fprintf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
+        emitter_printf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
       else
-        fprintf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
-      
-      fprintf(output_source, "  huart%u.Init.BaudRate     = %u;\n", current_module->data.uart.usart_number, current_module->data.uart.baudrate);
+        emitter_printf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
+      emitter_printf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct);\n  \n", current_module->pin.port);
+    } else{ // Special case TX and RX are not on the same port (e.g. UART5 with tx PC12 and rx PD2)
+      emitter_append(output_source, "  // Enable GPIO port clocks\n");
+      emitter_printf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->pin.port);
+      emitter_printf(output_source, "  __HAL_RCC_GPIO%c_CLK_ENABLE();\n", current_module->data.uart.rx_pin.port);
+      emitter_append(output_source, "  \n");
       
-      if(current_module->data.uart.databits == 8)
-        fprintf(output_source, "  huart%u.Init.WordLength   = UART_WORDLENGTH_8B;\n", current_module->data.uart.usart_number);
-      else if(current_module->data.uart.databits == 9)
-        fprintf(output_source, "  huart%u.Init.WordLength   = UART_WORDLENGTH_9B;\n", current_module->data.uart.usart_number);
-      else
-        log_error("generate_source_uart_init_func", 0, "Unsupported databits value '%u' for UART module '%s'", current_module->data.uart.databits, current_module->name);
-      
-      if(current_module->data.uart.stopbits == 1.0f)
-        fprintf(output_source, "  huart%u.Init.StopBits     = UART_STOPBITS_1;\n", current_module->data.uart.usart_number);
-      else if(current_module->data.uart.stopbits == 2.0f)
-        fprintf(output_source, "  huart%u.Init.StopBits     = UART_STOPBITS_2;\n", current_module->data.uart.usart_number);
+      emitter_append(output_source, "  // Configure GPIO pin for UART TX\n");
+      emitter_append(output_source, "  GPIO_InitTypeDef GPIO_InitStruct_TX = {0};\n");
+      emitter_printf(output_source, "  GPIO_InitStruct_TX.Pin       = GPIO_PIN_%u;\n", current_module->pin.pin_number);
+      emitter_append(output_source, "  GPIO_InitStruct_TX.Mode      = GPIO_MODE_AF_PP;\n");
+      emitter_append(output_source, "  GPIO_InitStruct_TX.Pull      = GPIO_NOPULL;\n");
+      emitter_append(output_source, "  GPIO_InitStruct_TX.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;\n");
+      emitter_printf(output_source, "  GPIO_InitStruct_TX.Alternate = GPIO_AF%u_U", current_module->data.uart.gpio_af);
+      if(current_module->data.uart.is_uart)
+        emitter_printf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
       else
-        log_error("generate_source_uart_init_func", 0, "Unsupported stopbits value '%u' for UART module '%s'", current_module->data.uart.stopbits, current_module->name);
+        emitter_printf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
+      emitter_printf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct_TX);\n  \n", current_module->pin.port);
       
-      if(current_module->data.uart.parity == UART_PARITY_NONE)
-        fprintf(output_source, "  huart%u.Init.Parity       = UART_PARITY_NONE;\n", current_module->data.uart.usart_number);
-      else if(current_module->data.uart.parity == UART_PARITY_EVEN)
-        fprintf(output_source, "  huart%u.Init.Parity       = UART_PARITY_EVEN;\n", current_module->data.uart.usart_number);
-      else if(current_module->data.uart.parity == UART_PARITY_ODD)
-        fprintf(output_source, "  huart%u.Init.Parity       = UART_PARITY_ODD;\n", current_module->data.uart.usart_number);
+      emitter_append(output_source, "  // Configure GPIO pin for UART RX\n");
+      emitter_append(output_source, "  GPIO_InitTypeDef GPIO_InitStruct_RX = {0};\n");
+      emitter_printf(output_source, "  GPIO_InitStruct_RX.Pin       = GPIO_PIN_%u;\n", current_module->data.uart.rx_pin.pin_number);
+      emitter_append(output_source, "  GPIO_InitStruct_RX.Mode      = GPIO_MODE_AF_PP;\n");
+      emitter_append(output_source, "  GPIO_InitStruct_RX.Pull      = GPIO_NOPULL;\n");
+      emitter_append(output_source, "  GPIO_InitStruct_RX.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;\n");
+      emitter_printf(output_source, "  GPIO_InitStruct_RX.Alternate = GPIO_AF%u_U", current_module->data.uart.gpio_af);
+      if(current_module->data.uart.is_uart)
+        emitter_printf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
       else
-        log_error("generate_source_uart_init_func", 0, "Unsupported parity enum value '%d' for UART module '%s'", current_module->data.uart.parity, current_module->name);
-      
-      fprintf(output_source, "  huart%u.Init.Mode         = UART_MODE_TX_RX;\n", current_module->data.uart.usart_number);
-      fprintf(output_source, "  huart%u.Init.HwFlowCtl    = UART_HWCONTROL_NONE;\n", current_module->data.uart.usart_number);
-      fprintf(output_source, "  huart%u.Init.OverSampling = UART_OVERSAMPLING_16;\n", current_module->data.uart.usart_number);
-      fprintf(output_source, "  if(HAL_UART_Init(&huart%u) != HAL_OK)\n", current_module->data.uart.usart_number);
-      fprintf(output_source, "    Error_Handler();\n");
-      fprintf(output_source, "}\n");
+        emitter_printf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
+      emitter_printf(output_source, "  HAL_GPIO_Init(GPIO%c, &GPIO_InitStruct_RX);\n  \n", current_module->data.uart.rx_pin.port);
     }
-    current_module = current_module->next;
+      
+    emitter_printf(output_source, "  // Enable UART%u peripheral clock\n", current_module->data.uart.usart_number);
+    emitter_append(output_source, "  __HAL_RCC_U");
+    if(current_module->data.uart.is_uart)
+      emitter_printf(output_source, "ART%u_CLK_ENABLE();\n  \n", current_module->data.uart.usart_number);
+    else
+      emitter_printf(output_source, "SART%u_CLK_ENABLE();\n  \n", current_module->data.uart.usart_number);
+  
+    // UART configuration
+    emitter_printf(output_source, "  // Configure UART%u\n", current_module->data.uart.usart_number);
+    
+    emitter_printf(output_source, "  huart%u.Instance          = U", current_module->data.uart.usart_number);
+    if(current_module->data.uart.is_uart)
+      emitter_printf(output_source, "ART%u;\n", current_module->data.uart.usart_number);
+    else
+      emitter_printf(output_source, "SART%u;\n", current_module->data.uart.usart_number);
+    
+    emitter_printf(output_source, "  huart%u.Init.BaudRate     = %u;\n", current_module->data.uart.usart_number, current_module->data.uart.baudrate);
+    
+    if(current_module->data.uart.databits == 8)
+      emitter_printf(output_source, "  huart%u.Init.WordLength   = UART_WORDLENGTH_8B;\n", current_module->data.uart.usart_number);
+    else if(current_module->data.uart.databits == 9)
+      emitter_printf(output_source, "  huart%u.Init.WordLength   = UART_WORDLENGTH_9B;\n", current_module->data.uart.usart_number);
+    else
+      log_error("generate_source_uart_init_func", 0, "Unsupported databits value '%u' for UART module '%s'", current_module->data.uart.databits, current_module->name);
+    
+    if(current_module->data.uart.stopbits == 1.0f)
+      emitter_printf(output_source, "  huart%u.Init.StopBits     = UART_STOPBITS_1;\n", current_module->data.uart.usart_number);
+    else if(current_module->data.uart.stopbits == 2.0f)
+      emitter_printf(output_source, "  huart%u.Init.StopBits     = UART_STOPBITS_2;\n", current_module->data.uart.usart_number);
+    else
+      log_error("generate_source_uart_init_func", 0, "Unsupported stopbits value '%u' for UART module '%s'", current_module->data.uart.stopbits, current_module->name);
+    
+    if(current_module->data.uart.parity == UART_PARITY_NONE)
+      emitter_printf(output_source, "  huart%u.Init.Parity       = UART_PARITY_NONE;\n", current_module->data.uart.usart_number);
+    else if(current_module->data.uart.parity == UART_PARITY_EVEN)
+      emitter_printf(output_source, "  huart%u.Init.Parity       = UART_PARITY_EVEN;\n", current_module->data.uart.usart_number);
+    else if(current_module->data.uart.parity == UART_PARITY_ODD)
+      emitter_printf(output_source, "  huart%u.Init.Parity       = UART_PARITY_ODD;\n", current_module->data.uart.usart_number);
+    else
+      log_error("generate_source_uart_init_func", 0, "Unsupported parity enum value '%d' for UART module '%s'", current_module->data.uart.parity, current_module->name);
+    
+    emitter_printf(output_source, "  huart%u.Init.Mode         = UART_MODE_TX_RX;\n", current_module->data.uart.usart_number);
+    emitter_printf(output_source, "  huart%u.Init.HwFlowCtl    = UART_HWCONTROL_NONE;\n", current_module->data.uart.usart_number);
+    emitter_printf(output_source, "  huart%u.Init.OverSampling = UART_OVERSAMPLING_%u;\n", current_module->data.uart.usart_number, current_module->data.uart.oversampling);
+    emitter_printf(output_source, "  if(HAL_UART_Init(&huart%u) != HAL_OK)\n", current_module->data.uart.usart_number);
+    emitter_append(output_source, "    Error_Handler();\n");
+    emitter_append(output_source, "}\n");
   }
 }
 
 /**
  * @brief Generates the usage functions for the modules for the STM32F446RE board support package (BSP).
  * 
- * @param output_source File pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node containing configuration data.
  */
-static void generate_source_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_func", 0, "DSL node is NULL.");
   
   // Generate delay function
-  fprintf(output_source, "\n\n// ---------- Delay function ----------\n");
-  fprintf(output_source, "/**\n");
-  fprintf(output_source, " * @brief Delays execution for a specified number of milliseconds.\n");
-  fprintf(output_source, " * @param ms Number of milliseconds to delay.\n");
-  fprintf(output_source, " */\n");
-  fprintf(output_source, "void BSP_DelayMs(uint32_t ms){\n");
-  fprintf(output_source, "  HAL_Delay(ms);\n");
-  fprintf(output_source, "}\n");
+  emitter_append(output_source, "\n\n// ---------- Delay function ----------\n");
+  emitter_append(output_source, "/**\n");
+  emitter_append(output_source, " * @brief Delays execution for a specified number of milliseconds.\n");
+  emitter_append(output_source, " * @param ms Number of milliseconds to delay.\n");
+  emitter_append(output_source, " */\n");
+  emitter_append(output_source, "void BSP_DelayMs(uint32_t ms){\n");
+  emitter_append(output_source, "  HAL_Delay(ms);\n");
+  emitter_append(output_source, "}\n");
   
   // Generate functions for each module kind
   generate_source_gpio_output_func(output_source, dsl_node);
   generate_source_gpio_input_func(output_source, dsl_node);
   generate_source_pwm_output_func(output_source, dsl_node);
   generate_source_uart_func(output_source, dsl_node);
-  
-  // Check for unsupported module kinds
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable){
-      switch(current_module->kind){
-        case MODULE_OUTPUT:
-        case MODULE_INPUT:
-        case MODULE_PWM_OUTPUT:
-        case MODULE_UART: break;
-        default:
-          log_error("generate_source_func", 0, "Unsupported module kind enum value '%d' for module '%s'", current_module->kind, current_module->name);
-      }
-    }
-    current_module = current_module->next;
-  }
 }
 
 /**
  * @brief Generates all source code functions for GPIO output modules for the STM32F446RE board support package (BSP).
  * 
- * @param output_source Pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node.
  */
-static void generate_source_gpio_output_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_gpio_output_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_gpio_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_gpio_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_gpio_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_OUTPUT){
-      ast_module_node_t *output_module = current_module;
-      // Generate functions for output GPIOs
-      fprintf(output_source, "\n\n// ---------- GPIO OUTPUT: '%s' ----------\n", output_module->name);
-      // Generate ON function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Turns ON the '%s' GPIO output.\n", output_module->name);
-      fprintf(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_On(void){\n", output_module->name);
-      fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
-              (output_module->data.output.active_level == HIGH) ? "SET" : "RESET");
-      fprintf(output_source, "}\n\n");
-      
-      // Generate OFF function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Turns OFF the '%s' GPIO output.\n", output_module->name);
-      fprintf(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_Off(void){\n", output_module->name);
-      fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
-              (output_module->data.output.active_level == HIGH) ? "RESET" : "SET");
-      fprintf(output_source, "}\n\n");
-      
-      // Generate TOGGLE function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Toggles the '%s' GPIO output.\n", output_module->name);
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_Toggle(void){\n", output_module->name);
-      fprintf(output_source, "  HAL_GPIO_TogglePin(GPIO%c, GPIO_PIN_%u);\n", output_module->pin.port, output_module->pin.pin_number);
-      fprintf(output_source, "}\n\n");
-      
-      // Generate SET function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Sets the '%s' GPIO output to the specified state.\n", output_module->name);
-      fprintf(output_source, " * @param on If true, turns the output on; otherwise, turns it off.\n");
-      fprintf(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_Set(bool on){\n", output_module->name);
-      fprintf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, on ? GPIO_PIN_%s : GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
-              (output_module->data.output.active_level == HIGH) ? "SET" : "RESET",
-              (output_module->data.output.active_level == HIGH) ? "RESET" : "SET");
-      fprintf(output_source, "}\n\n");
-      
-      // Generate IS_ON function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Reads the current state of the '%s' GPIO output.\n", output_module->name);
-      fprintf(output_source, " * @return true if the output is ON; false otherwise.\n");
-      fprintf(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "bool BSP_%s_IsOn(void){\n", output_module->name);
-      fprintf(output_source, "  return (HAL_GPIO_ReadPin(GPIO%c, GPIO_PIN_%u) == GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
-              (output_module->data.output.active_level == HIGH) ? "SET" : "RESET");
-      fprintf(output_source, "}\n");
-    }
-    current_module = current_module->next;
+  ast_module_span_t output_modules = get_enabled_modules(dsl_node, MODULE_OUTPUT);
+  for(uint32_t i = 0; i < output_modules.count; i++){
+    ast_module_node_t *current_module = output_modules.items[i];
+    ast_module_node_t *output_module = current_module;
+    // Generate functions for output GPIOs
+    emitter_printf(output_source, "\n\n// ---------- GPIO OUTPUT: '%s' ----------\n", output_module->name);
+    // Generate ON function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Turns ON the '%s' GPIO output.\n", output_module->name);
+    emitter_append(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_On(void){\n", output_module->name);
+    emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
+                   (output_module->data.output.active_level == HIGH) ? "SET" : "RESET");
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate OFF function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Turns OFF the '%s' GPIO output.\n", output_module->name);
+    emitter_append(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_Off(void){\n", output_module->name);
+    emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
+                   (output_module->data.output.active_level == HIGH) ? "RESET" : "SET");
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate TOGGLE function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Toggles the '%s' GPIO output.\n", output_module->name);
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_Toggle(void){\n", output_module->name);
+    emitter_printf(output_source, "  HAL_GPIO_TogglePin(GPIO%c, GPIO_PIN_%u);\n", output_module->pin.port, output_module->pin.pin_number);
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate SET function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Sets the '%s' GPIO output to the specified state.\n", output_module->name);
+    emitter_append(output_source, " * @param on If true, turns the output on; otherwise, turns it off.\n");
+    emitter_append(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_Set(bool on){\n", output_module->name);
+    emitter_printf(output_source, "  HAL_GPIO_WritePin(GPIO%c, GPIO_PIN_%u, on ? GPIO_PIN_%s : GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
+                   (output_module->data.output.active_level == HIGH) ? "SET" : "RESET",
+                   (output_module->data.output.active_level == HIGH) ? "RESET" : "SET");
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate IS_ON function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Reads the current state of the '%s' GPIO output.\n", output_module->name);
+    emitter_append(output_source, " * @return true if the output is ON; false otherwise.\n");
+    emitter_append(output_source, " * @note The electrical GPIO level is derived from the configured active level.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "bool BSP_%s_IsOn(void){\n", output_module->name);
+    emitter_printf(output_source, "  return (HAL_GPIO_ReadPin(GPIO%c, GPIO_PIN_%u) == GPIO_PIN_%s);\n", output_module->pin.port, output_module->pin.pin_number,
+                   (output_module->data.output.active_level == HIGH) ? "SET" : "RESET");
+    emitter_append(output_source, "}\n");
   }
 }
 
 /**
  * @brief Generates all source code functions for GPIO input modules for the STM32F446RE board support package (BSP).
  * 
- * @param output_source Pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node.
  */
-static void generate_source_gpio_input_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_gpio_input_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_gpio_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_gpio_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_gpio_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_INPUT){
-      ast_module_node_t *input_module = current_module;
-      // Generate functions for input GPIOs
-      fprintf(output_source, "\n\n// ---------- GPIO INPUT: '%s' ----------\n", input_module->name);
-      
-      // Generate IS_ACTIVE function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Checks if the '%s' GPIO input is in its active state.\n", input_module->name);
-      fprintf(output_source, " * @return true if the input is active; false otherwise.\n");
-      fprintf(output_source, " * @note Considers the active level configuration.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "bool BSP_%s_IsActive(void){\n", input_module->name);
-      if(input_module->data.input.active_level == HIGH){
-        fprintf(output_source, "  return (HAL_GPIO_ReadPin(GPIO%c, GPIO_PIN_%u) == GPIO_PIN_SET);\n", input_module->pin.port, input_module->pin.pin_number);
-      }
-      else{ // active_level == LOW
-        fprintf(output_source, "  return (HAL_GPIO_ReadPin(GPIO%c, GPIO_PIN_%u) == GPIO_PIN_RESET);\n", input_module->pin.port, input_module->pin.pin_number);
-      }
-      fprintf(output_source, "}\n");
+  ast_module_span_t input_modules = get_enabled_modules(dsl_node, MODULE_INPUT);
+  for(uint32_t i = 0; i < input_modules.count; i++){
+    ast_module_node_t *current_module = input_modules.items[i];
+    ast_module_node_t *input_module = current_module;
+    // Generate functions for input GPIOs
+    emitter_printf(output_source, "\n\n// ---------- GPIO INPUT: '%s' ----------\n", input_module->name);
+    
+    // Generate IS_ACTIVE function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Checks if the '%s' GPIO input is in its active state.\n", input_module->name);
+    emitter_append(output_source, " * @return true if the input is active; false otherwise.\n");
+    emitter_append(output_source, " * @note Considers the active level configuration.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "bool BSP_%s_IsActive(void){\n", input_module->name);
+    if(input_module->data.input.active_level == HIGH){
+      emitter_printf(output_source, "  return (HAL_GPIO_ReadPin(GPIO%c, GPIO_PIN_%u) == GPIO_PIN_SET);\n", input_module->pin.port, input_module->pin.pin_number);
     }
-    current_module = current_module->next;
+    else{ // active_level == LOW
+      emitter_printf(output_source, "  return (HAL_GPIO_ReadPin(GPIO%c, GPIO_PIN_%u) == GPIO_PIN_RESET);\n", input_module->pin.port, input_module->pin.pin_number);
+    }
+    emitter_append(output_source, "}\n");
   }
 }
 
 /** 
  * @brief Generates all source code functions for PWM output modules for the STM32F446RE board support package (BSP).
  * 
- * @param output_source Pointer to the output source file.
+ * @param output_source Emitter of the output source file.
  * @param dsl_node Pointer to the DSL AST node.
  */
-static void generate_source_pwm_output_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_pwm_output_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_pwm_output_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_pwm_output_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_pwm_output_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_PWM_OUTPUT){
-      ast_module_node_t *pwm_module = current_module;
-      // Generate functions for PWM output modules
-      fprintf(output_source, "\n\n// ---------- PWM OUTPUT: '%s' ----------\n", pwm_module->name);
-      
-      // Generate needed variables
-      fprintf(output_source, "// Internal state for PWM module '%s'\n", pwm_module->name);
-      fprintf(output_source, "static bool s_pwm_%s_running = false;\n", pwm_module->name);
-      fprintf(output_source, "static uint16_t s_pwm_%s_duty_permille = %d; // Duty cycle in permille (0..1000)\n\n", pwm_module->name, pwm_module->data.pwm.duty_cycle);
-      
-      // Generate Start function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Starts the PWM signal generation for the '%s' module.\n", pwm_module->name);
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_Start(void){\n", pwm_module->name);
-      fprintf(output_source, "  if(!s_pwm_%s_running){\n", pwm_module->name);
-      fprintf(output_source, "    // Ensure the last set duty cycle is applied before starting\n");
-      fprintf(output_source, "    BSP_%s_SetDuty(s_pwm_%s_duty_permille);\n    \n", pwm_module->name, pwm_module->name);
-      fprintf(output_source, "    // Start PWM signal generation\n");
-      fprintf(output_source, "    if(HAL_TIM_PWM_Start(&htim%u, TIM_CHANNEL_%u) != HAL_OK)\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
-      fprintf(output_source, "      Error_Handler();\n");
-      fprintf(output_source, "    s_pwm_%s_running = true;\n", pwm_module->name);
-      fprintf(output_source, "  }\n");
-      fprintf(output_source, "}\n\n");
-      
-      // Generate Stop function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Stops the PWM signal generation for the '%s' module.\n", pwm_module->name);
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_Stop(void){\n", pwm_module->name);
-      fprintf(output_source, "  if(s_pwm_%s_running){\n", pwm_module->name);
-      fprintf(output_source, "    if(HAL_TIM_PWM_Stop(&htim%u, TIM_CHANNEL_%u) != HAL_OK)\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
-      fprintf(output_source, "      Error_Handler();\n");
-      fprintf(output_source, "    s_pwm_%s_running = false;\n", pwm_module->name);
-      fprintf(output_source, "  }\n  \n");
-      fprintf(output_source, "  // Force output to inactive level\n");
-      fprintf(output_source, "  __HAL_TIM_SET_COMPARE(&htim%u, TIM_CHANNEL_%u, 0);\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
-      fprintf(output_source, "}\n\n");
-      
-      // Generate SetDuty function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Sets the duty cycle for the '%s' PWM output.\n", pwm_module->name);
-      fprintf(output_source, " * @param permille Duty cycle in permille (0..1000).\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_SetDuty(uint16_t permille){\n", pwm_module->name);
-      fprintf(output_source, "  if(permille > 1000)\n");
-      fprintf(output_source, "    permille = 1000;\n  \n");
-      fprintf(output_source, "  s_pwm_%s_duty_permille = permille;\n  \n", pwm_module->name);
-      if(pwm_module->data.pwm.active_level == LOW){
-        fprintf(output_source, "  // Invert duty cycle for active LOW configuration\n");
-        fprintf(output_source, "  permille = 1000u - permille;\n  \n");
-      }
-      fprintf(output_source, "  // ARR is the PWM top value\n");
-      fprintf(output_source, "  uint32_t arr = __HAL_TIM_GET_AUTORELOAD(&htim%u);\n  \n", pwm_module->data.pwm.tim_number);
-      fprintf(output_source, "  // Convert 0..1000 permille to timer compare value\n");
-      fprintf(output_source, "  uint32_t crr = (arr * (uint32_t)permille + 500u) / 1000u; // Rounded calculation\n  \n");
-      fprintf(output_source, "  if(crr > arr) crr = arr;\n  \n");
-      fprintf(output_source, "  // Set the compare register to update duty cycle\n");
-      fprintf(output_source, "  __HAL_TIM_SET_COMPARE(&htim%u, TIM_CHANNEL_%u, crr);\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
-      fprintf(output_source, "}\n\n");
-      
-      // Generate GetDuty function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Gets the current duty cycle for the '%s' PWM output.\n", pwm_module->name);
-      fprintf(output_source, " * @return Duty cycle in permille (0..1000).\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "uint16_t BSP_%s_GetDuty(void){\n", pwm_module->name);
-      fprintf(output_source, "  return s_pwm_%s_duty_permille;\n", pwm_module->name);
-      fprintf(output_source, "}\n");
+  ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+  for(uint32_t i = 0; i < pwm_modules.count; i++){
+    ast_module_node_t *current_module = pwm_modules.items[i];
+    ast_module_node_t *pwm_module = current_module;
+    // Generate functions for PWM output modules
+    emitter_printf(output_source, "\n\n// ---------- PWM OUTPUT: '%s' ----------\n", pwm_module->name);
+    
+    // Generate needed variables
+    emitter_printf(output_source, "// Internal state for PWM module '%s'\n", pwm_module->name);
+    emitter_printf(output_source, "static bool s_pwm_%s_running = false;\n", pwm_module->name);
+    emitter_printf(output_source, "static uint16_t s_pwm_%s_duty_permille = %d; // Duty cycle in permille (0..1000)\n\n", pwm_module->name, pwm_module->data.pwm.duty_cycle);
+    
+    // Generate Start function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Starts the PWM signal generation for the '%s' module.\n", pwm_module->name);
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_Start(void){\n", pwm_module->name);
+    emitter_printf(output_source, "  if(!s_pwm_%s_running){\n", pwm_module->name);
+    emitter_append(output_source, "    // Ensure the last set duty cycle is applied before starting\n");
+    emitter_printf(output_source, "    BSP_%s_SetDuty(s_pwm_%s_duty_permille);\n    \n", pwm_module->name, pwm_module->name);
+    emitter_append(output_source, "    // Start PWM signal generation\n");
+    emitter_printf(output_source, "    if(HAL_TIM_PWM_Start(&htim%u, TIM_CHANNEL_%u) != HAL_OK)\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
+    emitter_append(output_source, "      Error_Handler();\n");
+    emitter_printf(output_source, "    s_pwm_%s_running = true;\n", pwm_module->name);
+    emitter_append(output_source, "  }\n");
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate Stop function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Stops the PWM signal generation for the '%s' module.\n", pwm_module->name);
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_Stop(void){\n", pwm_module->name);
+    emitter_printf(output_source, "  if(s_pwm_%s_running){\n", pwm_module->name);
+    emitter_printf(output_source, "    if(HAL_TIM_PWM_Stop(&htim%u, TIM_CHANNEL_%u) != HAL_OK)\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
+    emitter_append(output_source, "      Error_Handler();\n");
+    emitter_printf(output_source, "    s_pwm_%s_running = false;\n", pwm_module->name);
+    emitter_append(output_source, "  }\n  \n");
+    emitter_append(output_source, "  // Force output to inactive level\n");
+    emitter_printf(output_source, "  __HAL_TIM_SET_COMPARE(&htim%u, TIM_CHANNEL_%u, 0);\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate SetDuty function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Sets the duty cycle for the '%s' PWM output.\n", pwm_module->name);
+    emitter_append(output_source, " * @param permille Duty cycle in permille (0..1000).\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_SetDuty(uint16_t permille){\n", pwm_module->name);
+    emitter_append(output_source, "  if(permille > 1000)\n");
+    emitter_append(output_source, "    permille = 1000;\n  \n");
+    emitter_printf(output_source, "  s_pwm_%s_duty_permille = permille;\n  \n", pwm_module->name);
+    if(pwm_module->data.pwm.active_level == LOW){
+      emitter_append(output_source, "  // Invert duty cycle for active LOW configuration\n");
+      emitter_append(output_source, "  permille = 1000u - permille;\n  \n");
     }
-    current_module = current_module->next;
+    emitter_append(output_source, "  // ARR is the PWM top value\n");
+    emitter_printf(output_source, "  uint32_t arr = __HAL_TIM_GET_AUTORELOAD(&htim%u);\n  \n", pwm_module->data.pwm.tim_number);
+    emitter_append(output_source, "  // Convert 0..1000 permille to timer compare value\n");
+    if(pwm_module->data.pwm.period > (UINT32_MAX - 500u) / 1000u) // 32-bit timer with a period above 22 bits, arr * permille + 500 needs 64 bits
+      emitter_append(output_source, "  uint32_t crr = (uint32_t)(((uint64_t)arr * permille + 500u) / 1000u); // Rounded calculation\n  \n");
+    else
+      emitter_append(output_source, "  uint32_t crr = (arr * (uint32_t)permille + 500u) / 1000u; // Rounded calculation\n  \n");
+    emitter_append(output_source, "  if(crr > arr) crr = arr;\n  \n");
+    emitter_append(output_source, "  // Set the compare register to update duty cycle\n");
+    emitter_printf(output_source, "  __HAL_TIM_SET_COMPARE(&htim%u, TIM_CHANNEL_%u, crr);\n", pwm_module->data.pwm.tim_number, pwm_module->data.pwm.tim_channel);
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate GetDuty function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Gets the current duty cycle for the '%s' PWM output.\n", pwm_module->name);
+    emitter_append(output_source, " * @return Duty cycle in permille (0..1000).\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "uint16_t BSP_%s_GetDuty(void){\n", pwm_module->name);
+    emitter_printf(output_source, "  return s_pwm_%s_duty_permille;\n", pwm_module->name);
+    emitter_append(output_source, "}\n");
   }
 }
 
-static void generate_source_uart_func(FILE* output_source, ast_dsl_node_t* dsl_node){
+static void generate_source_uart_func(emitter_t* output_source, ast_dsl_node_t* dsl_node){
   if(output_source == NULL)
-    log_error("generate_source_uart_func", 0, "Output source file pointer is NULL.");
+    log_error("generate_source_uart_func", 0, "Output source emitter is NULL.");
   if(dsl_node == NULL)
     log_error("generate_source_uart_func", 0, "DSL node is NULL.");
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_UART){
-      ast_module_node_t *uart_module = current_module;
-      // Generate functions for UART modules
-      fprintf(output_source, "\n\n// ---------- UART: '%s' ----------\n", uart_module->name);
-      
-      // Generate Transmit-Char function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Transmits single character over the '%s' UART module.\n", uart_module->name);
-      fprintf(output_source, " * @param ch Byte to transmit.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_TransmitChar(uint8_t ch){\n", uart_module->name);
-      fprintf(output_source, "  HAL_UART_Transmit(&huart%u, &ch, 1, HAL_MAX_DELAY);\n", uart_module->data.uart.usart_number);
-      fprintf(output_source, "}\n\n");
-      
-      // Generate Transmit-Message function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Transmits a message over the '%s' UART module.\n", uart_module->name);
-      fprintf(output_source, " * @param message Pointer to the null-terminated message string.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "void BSP_%s_TransmitMessage(const char* message){\n", uart_module->name);
-      fprintf(output_source, "  if(message == NULL)\n");
-      fprintf(output_source, "    return;\n  \n");
-      fprintf(output_source, "  HAL_UART_Transmit(&huart%u, (uint8_t*)message, strlen(message), HAL_MAX_DELAY);\n", uart_module->data.uart.usart_number);
-      fprintf(output_source, "}\n\n");
-      
-      // Generate Receive-Char function
-      fprintf(output_source, "/**\n");
-      fprintf(output_source, " * @brief Receives a single character from the '%s' UART module.\n", uart_module->name);
-      fprintf(output_source, " * @param ch Pointer to the variable to store the received byte.\n");
-      fprintf(output_source, " * @return true if a character was successfully received; false otherwise.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "bool BSP_%s_ReceiveChar(uint8_t* ch){\n", uart_module->name);
-      fprintf(output_source, "  if(ch == NULL)\n");
-      fprintf(output_source, "    return false;\n  \n");
-      fprintf(output_source, "  return (HAL_UART_Receive(&huart%u, ch, 1, HAL_MAX_DELAY) == HAL_OK);\n", uart_module->data.uart.usart_number);
-      fprintf(output_source, "}\n");
-      
-      // Generate Try-Receive-Char function
-      fprintf(output_source, "\n/**\n");
-      fprintf(output_source, " * @brief Tries to receive a single character from the '%s' UART module without blocking.\n", uart_module->name);
-      fprintf(output_source, " * @param ch Pointer to the variable to store the received byte.\n");
-      fprintf(output_source, " * @return true if a character was successfully received; false otherwise.\n");
-      fprintf(output_source, " */\n");
-      fprintf(output_source, "bool BSP_%s_TryReceiveChar(uint8_t* ch){\n", uart_module->name);
-      fprintf(output_source, "  if(ch == NULL)\n");
-      fprintf(output_source, "    return false;\n  \n");
-      fprintf(output_source, "  return (HAL_UART_Receive(&huart%u, ch, 1, 0) == HAL_OK);\n", uart_module->data.uart.usart_number);
-      fprintf(output_source, "}\n");
-    }
-    current_module = current_module->next;
+  ast_module_span_t uart_modules = get_enabled_modules(dsl_node, MODULE_UART);
+  for(uint32_t i = 0; i < uart_modules.count; i++){
+    ast_module_node_t *current_module = uart_modules.items[i];
+    ast_module_node_t *uart_module = current_module;
+    // Generate functions for UART modules
+    emitter_printf(output_source, "\n\n// ---------- UART: '%s' ----------\n", uart_module->name);
+    
+    // Generate Transmit-Char function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Transmits single character over the '%s' UART module.\n", uart_module->name);
+    emitter_append(output_source, " * @param ch Byte to transmit.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_TransmitChar(uint8_t ch){\n", uart_module->name);
+    emitter_printf(output_source, "  HAL_UART_Transmit(&huart%u, &ch, 1, HAL_MAX_DELAY);\n", uart_module->data.uart.usart_number);
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate Transmit-Message function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Transmits a message over the '%s' UART module.\n", uart_module->name);
+    emitter_append(output_source, " * @param message Pointer to the null-terminated message string.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "void BSP_%s_TransmitMessage(const char* message){\n", uart_module->name);
+    emitter_append(output_source, "  if(message == NULL)\n");
+    emitter_append(output_source, "    return;\n  \n");
+    emitter_printf(output_source, "  HAL_UART_Transmit(&huart%u, (uint8_t*)message, strlen(message), HAL_MAX_DELAY);\n", uart_module->data.uart.usart_number);
+    emitter_append(output_source, "}\n\n");
+    
+    // Generate Receive-Char function
+    emitter_append(output_source, "/**\n");
+    emitter_printf(output_source, " * @brief Receives a single character from the '%s' UART module.\n", uart_module->name);
+    emitter_append(output_source, " * @param ch Pointer to the variable to store the received byte.\n");
+    emitter_append(output_source, " * @return true if a character was successfully received; false otherwise.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "bool BSP_%s_ReceiveChar(uint8_t* ch){\n", uart_module->name);
+    emitter_append(output_source, "  if(ch == NULL)\n");
+    emitter_append(output_source, "    return false;\n  \n");
+    emitter_printf(output_source, "  return (HAL_UART_Receive(&huart%u, ch, 1, HAL_MAX_DELAY) == HAL_OK);\n", uart_module->data.uart.usart_number);
+    emitter_append(output_source, "}\n");
+    
+    // Generate Try-Receive-Char function
+    emitter_append(output_source, "\n/**\n");
+    emitter_printf(output_source, " * @brief Tries to receive a single character from the '%s' UART module without blocking.\n", uart_module->name);
+    emitter_append(output_source, " * @param ch Pointer to the variable to store the received byte.\n");
+    emitter_append(output_source, " * @return true if a character was successfully received; false otherwise.\n");
+    emitter_append(output_source, " */\n");
+    emitter_printf(output_source, "bool BSP_%s_TryReceiveChar(uint8_t* ch){\n", uart_module->name);
+    emitter_append(output_source, "  if(ch == NULL)\n");
+    emitter_append(output_source, "    return false;\n  \n");
+    emitter_printf(output_source, "  return (HAL_UART_Receive(&huart%u, ch, 1, 0) == HAL_OK);\n", uart_module->data.uart.usart_number);
+    emitter_append(output_source, "}\n");
+  }
+}
+
+
+/* -------------------------------------------- */
+/*               Helper functions               */
+/* -------------------------------------------- */
+
+/**
+ * @brief Checks if a PWM module is the first one (in module order) on its timer.
+ * 
+ * @param pwm_modules Enabled PWM modules.
+ * @param index Index of the module in pwm_modules.
+ * @return true if no module before it uses the same timer, false otherwise.
+ * 
+ * @note Modules with the same frequency can share a timer (see bind_pwm_pins_stm32f446re), which is declared,
+ *       initialized and configured once, at its first module.
+ */
+static bool is_first_pwm_module_on_timer(ast_module_span_t pwm_modules, uint32_t index){
+  for(uint32_t i = 0; i < index; i++){
+    if(pwm_modules.items[i]->data.pwm.tim_number == pwm_modules.items[index]->data.pwm.tim_number)
+      return false;
   }
+  return true;
 }
@@ -1,9 +1,9 @@
 #ifndef __AST_GENERATE_STM32F446RE_H__
 #define __AST_GENERATE_STM32F446RE_H__
 
-#include <stdio.h>
 #include "astEnums.h"
+#include "emitter.h"
 
-void ast_generate_source_stm32f446re(FILE* output_source, ast_dsl_node_t* dsl_node);
+void ast_generate_source_stm32f446re(emitter_t* output_source, ast_dsl_node_t* dsl_node);
 
 #endif // __AST_GENERATE_STM32F446RE_H__
\ No newline at end of file
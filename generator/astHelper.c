@@ -4,14 +4,6 @@
 
 #include <stdlib.h>
 
-bool value_has_enabled_gpio = false;
-bool value_has_enabled_pwm = false;
-bool value_has_enabled_uart = false;
-
-bool value_set_has_enabled_gpio = false;
-bool value_set_has_enabled_pwm = false;
-bool value_set_has_enabled_uart = false;
-
 /* -------------------------------------------- */
 /*               Helper functions               */
 /* -------------------------------------------- */
@@ -26,22 +18,7 @@ bool has_enabled_gpio_module(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("has_enabled_gpio_module", 0, "DSL node is NULL.");
   
-  // Use cached value if available
-  if(value_set_has_enabled_gpio)
-    return value_has_enabled_gpio;
-  
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && (current_module->kind == MODULE_OUTPUT || current_module->kind == MODULE_INPUT)){
-      value_has_enabled_gpio = true;
-      value_set_has_enabled_gpio = true;
-      return true;
-    }
-    current_module = current_module->next;
-  }
-  value_has_enabled_gpio = false;
-  value_set_has_enabled_gpio = true;
-  return false;
+  return get_enabled_modules(dsl_node, MODULE_OUTPUT).count > 0 || get_enabled_modules(dsl_node, MODULE_INPUT).count > 0;
 }
 
 /**
@@ -54,22 +31,7 @@ bool has_enabled_pwm_module(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("has_enabled_pwm_module", 0, "DSL node is NULL.");
   
-  // Use cached value if available
-  if(value_set_has_enabled_pwm)
-    return value_has_enabled_pwm;
-  
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_PWM_OUTPUT){
-      value_has_enabled_pwm = true;
-      value_set_has_enabled_pwm = true;
-      return true;
-    }
-    current_module = current_module->next;
-  }
-  value_has_enabled_pwm = false;
-  value_set_has_enabled_pwm = true;
-  return false;
+  return get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT).count > 0;
 }
 
 /**
@@ -82,20 +44,25 @@ bool has_enabled_uart_module(ast_dsl_node_t* dsl_node){
   if(dsl_node == NULL)
     log_error("has_enabled_uart_module", 0, "DSL node is NULL.");
   
-  // Use cached value if available
-  if(value_set_has_enabled_uart)
-    return value_has_enabled_uart;
+  return get_enabled_modules(dsl_node, MODULE_UART).count > 0;
+}
+
+/**
+ * @brief Returns the enabled modules of one kind from the index of the DSL node.
+ * 
+ * @param dsl_node Pointer to the DSL AST node.
+ * @param kind Module kind.
+ * @return Span of the enabled modules of the kind in list order (count 0 if there are none).
+ * 
+ * @note Logs an error and exits if the index has not been built (see ast_index_enabled_modules) or the kind is unsupported.
+ */
+ast_module_span_t get_enabled_modules(const ast_dsl_node_t* dsl_node, ast_module_kind_t kind){
+  if(dsl_node == NULL)
+    log_error("get_enabled_modules", 0, "DSL node is NULL.");
+  if(!dsl_node->modules_indexed)
+    log_error("get_enabled_modules", 0, "Enabled modules of the DSL node are not indexed.");
+  if((unsigned int)kind >= MODULE_KIND_COUNT)
+    log_error("get_enabled_modules", 0, "Unsupported module kind enum value '%d'", kind);
   
-  ast_module_node_t *current_module = dsl_node->modules_root;
-  while(current_module != NULL){
-    if(current_module->enable && current_module->kind == MODULE_UART){
-      value_has_enabled_uart = true;
-      value_set_has_enabled_uart = true;
-      return true;
-    }
-    current_module = current_module->next;
-  }
-  value_has_enabled_uart = false;
-  value_set_has_enabled_uart = true;
-  return false;
+  return dsl_node->enabled_by_kind[kind];
 }
\ No newline at end of file
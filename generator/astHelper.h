@@ -9,4 +9,6 @@ bool has_enabled_gpio_module(ast_dsl_node_t* dsl_node);
 bool has_enabled_pwm_module(ast_dsl_node_t* dsl_node);
 bool has_enabled_uart_module(ast_dsl_node_t* dsl_node);
 
+ast_module_span_t get_enabled_modules(const ast_dsl_node_t* dsl_node, ast_module_kind_t kind);
+
 #endif // __AST_HELPER_H__
\ No newline at end of file
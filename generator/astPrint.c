@@ -2,79 +2,103 @@
 
 #include "logging.h"
 #include "astEnums2Str.h"
+#include "generatorOptions.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 
-static void ast_print_helper(FILE *pfDot, const ast_dsl_node_t* dsl_node, bool print_enabled_only);
+static void ast_print_helper(emitter_t *output, const ast_dsl_node_t* dsl_node, bool print_enabled_only);
+static void ast_print_write_file(const emitter_t *output, const char *file_path);
 
 /* -------------------------------------------- */
 /*                 AST Printing                 */
 /* -------------------------------------------- */
 
 /**
- * @brief Prints the AST represented by the given DSL node to a DOT file and creates shell scripts to generate and remove PNG and DOT files.
+ * @brief Prints the AST represented by the given DSL node to DOT files and creates shell scripts to generate and remove PNG and DOT files.
  * 
  * @param output_path Path to the directory where the output files will be created.
  * @param dsl_node Pointer to the DSL AST node to be printed.
+ * @param output Emitter used as buffer for each file (cleared before each file).
+ * @param emit Artifacts to write (EMIT_DOT for the DOT files, EMIT_SCRIPTS for the shell scripts, other bits are ignored).
+ * 
+ * @note Files that already have the same content are not rewritten (see emitter_write_file).
+ * @note The AST is only traversed for the DOT files that are written.
  */
-void ast_print(const char* output_path, const ast_dsl_node_t* dsl_node){
+void ast_print(const char* output_path, const ast_dsl_node_t* dsl_node, emitter_t *output, unsigned int emit){
   if(dsl_node == NULL)
     log_error("ast_print", 0, "DSL node is NULL, cannot print AST.");
+  if(output == NULL)
+    log_error("ast_print", 0, "Output emitter is NULL.");
   
   // Create shell script to remove PNG and DOT files (is at beginning to avoid not creating it if error occurs during AST print)
-  char remove_script_path[256];
-  snprintf(remove_script_path, sizeof(remove_script_path), "%s/removePNGandDOT.sh", output_path);
-  FILE *file_remove = fopen(remove_script_path, "w");
-  if(file_remove == NULL)
-    log_error("ast_print", 0, "Failed to create remove script at path: '%s'", remove_script_path);
-  fprintf(file_remove, "rm -f %s/ast_graph_complete.gv %s/ast_graph_complete.png\n", output_path, output_path);
-  fprintf(file_remove, "rm -f %s/ast_graph_enabled_only.gv %s/ast_graph_enabled_only.png\n", output_path, output_path);
-  fclose(file_remove);
+  if(emit & EMIT_SCRIPTS){
+    char remove_script_path[256];
+    snprintf(remove_script_path, sizeof(remove_script_path), "%s/removePNGandDOT.sh", output_path);
+    emitter_clear(output);
+    emitter_printf(output, "rm -f %s/ast_graph_complete.gv %s/ast_graph_complete.png\n", output_path, output_path);
+    emitter_printf(output, "rm -f %s/ast_graph_enabled_only.gv %s/ast_graph_enabled_only.png\n", output_path, output_path);
+    ast_print_write_file(output, remove_script_path);
+  }
   
-  char dot_file_complete[256];
-  snprintf(dot_file_complete, sizeof(dot_file_complete), "%s/ast_graph_complete.gv", output_path);
-  FILE *file_dot = fopen(dot_file_complete, "w");
-  if(file_dot == NULL)
-    log_error("ast_print", 0, "Failed to open DOT file for writing: '%s'", dot_file_complete);
-  ast_print_helper(file_dot, dsl_node, false);
-  fclose(file_dot);
-
-  char dot_file_enabled[256];
-  snprintf(dot_file_enabled, sizeof(dot_file_enabled), "%s/ast_graph_enabled_only.gv", output_path);
-  file_dot = fopen(dot_file_enabled, "w");
-  if(file_dot == NULL)
-    log_error("ast_print", 0, "Failed to open DOT file for writing: '%s'", dot_file_enabled);
-  ast_print_helper(file_dot, dsl_node, true);
-  fclose(file_dot);
+  if(emit & EMIT_DOT){
+    char dot_file_complete[256];
+    snprintf(dot_file_complete, sizeof(dot_file_complete), "%s/ast_graph_complete.gv", output_path);
+    emitter_clear(output);
+    ast_print_helper(output, dsl_node, false);
+    ast_print_write_file(output, dot_file_complete);
+    
+    char dot_file_enabled[256];
+    snprintf(dot_file_enabled, sizeof(dot_file_enabled), "%s/ast_graph_enabled_only.gv", output_path);
+    emitter_clear(output);
+    ast_print_helper(output, dsl_node, true);
+    ast_print_write_file(output, dot_file_enabled);
+  }
   
   // Create shell script to generate PNG from DOT
-  char create_script_path[256];
-  snprintf(create_script_path, sizeof(create_script_path), "%s/createPNGfromDOT.sh", output_path);
-  FILE *file_create = fopen(create_script_path, "w");
-  if(file_create == NULL)
-    log_error("ast_print", 0, "Failed to create create script at path: '%s'", create_script_path);
-  fprintf(file_create, "dot %s/ast_graph_complete.gv -Tpng -o %s/ast_graph_complete.png\n", output_path, output_path);
-  fprintf(file_create, "dot %s/ast_graph_enabled_only.gv -Tpng -o %s/ast_graph_enabled_only.png\n", output_path, output_path);
-  fclose(file_create);
+  if(emit & EMIT_SCRIPTS){
+    char create_script_path[256];
+    snprintf(create_script_path, sizeof(create_script_path), "%s/createPNGfromDOT.sh", output_path);
+    emitter_clear(output);
+    emitter_printf(output, "dot %s/ast_graph_complete.gv -Tpng -o %s/ast_graph_complete.png\n", output_path, output_path);
+    emitter_printf(output, "dot %s/ast_graph_enabled_only.gv -Tpng -o %s/ast_graph_enabled_only.png\n", output_path, output_path);
+    ast_print_write_file(output, create_script_path);
+  }
+}
+
+/**
+ * @brief Writes the content of the emitter into a file (only if the content changed).
+ * 
+ * @param output Emitter with the file content.
+ * @param file_path Path of the file.
+ * 
+ * @note Logs an error and exits if the file could not be written.
+ */
+static void ast_print_write_file(const emitter_t *output, const char *file_path){
+  emitter_write_result_t result = emitter_write_file(output, file_path);
+  if(result == EMITTER_WRITE_FAILED)
+    log_error("ast_print", 0, "Failed to write file: '%s' (%s)", file_path, strerror(errno));
+  if(result == EMITTER_WRITE_UNCHANGED)
+    log_info("ast_print", LOG_OTHER, 0, "File '%s' is unchanged, not rewritten", file_path);
 }
 
 /**
  * @brief Helper function to print the AST in DOT format.
  * 
- * @param pfDot File pointer to the DOT file.
+ * @param output Emitter of the DOT file.
  * @param dsl_node Pointer to the DSL AST node to be printed.
  * @param print_enabled_only If true, only enabled modules are printed.
  */
-static void ast_print_helper(FILE *pfDot, const ast_dsl_node_t* dsl_node, bool print_enabled_only){
-  fprintf(pfDot, "digraph AST {\n");
-  fprintf(pfDot, "  splines=ortho;\n");
-  fprintf(pfDot, "  node [shape=plain, fontname=\"Helvetica\"];\n");
-  fprintf(pfDot, "  edge [arrowhead=vee];\n");
+static void ast_print_helper(emitter_t *output, const ast_dsl_node_t* dsl_node, bool print_enabled_only){
+  emitter_append(output, "digraph AST {\n");
+  emitter_append(output, "  splines=ortho;\n");
+  emitter_append(output, "  node [shape=plain, fontname=\"Helvetica\"];\n");
+  emitter_append(output, "  edge [arrowhead=vee];\n");
   
   // Print controller node
-  fprintf(pfDot,
+  emitter_printf(output, 
   "  Controller [label=<<TABLE BORDER=\"1\" CELLBORDER=\"0\" CELLSPACING=\"0\" CELLPADDING=\"8\" BGCOLOR=\"#E8E8E8\">"
   "\n    <TR><TD><B>Controller</B></TD></TR>\n    <TR><TD>%s</TD></TR>\n    </TABLE>>];\n",
   controller_to_string(dsl_node->controller)
@@ -102,105 +126,107 @@ static void ast_print_helper(FILE *pfDot, const ast_dsl_node_t* dsl_node, bool p
       log_error("ast_print_helper", 0, "Unknown module kind enum value '%d'", current_module->kind);
     
     // Print general module info
-    fprintf(pfDot, "  Module%d [label=<<TABLE BORDER=\"1\" CELLBORDER=\"0\" CELLSPACING=\"0\" CELLPADDING=\"6\" BGCOLOR=\"%s\">", 
-                      current_module->node_id, colour);
+    emitter_printf(output, "  Module%d [label=<<TABLE BORDER=\"1\" CELLBORDER=\"0\" CELLSPACING=\"0\" CELLPADDING=\"6\" BGCOLOR=\"%s\">", 
+                             current_module->node_id, colour);
     
     // Module name as header
-    fprintf(pfDot, "\n    <TR><TD><B>%s</B> (%d)</TD></TR>", current_module->name, current_module->node_id);
+    emitter_printf(output, "\n    <TR><TD><B>%s</B> (%d)</TD></TR>", current_module->name, current_module->node_id);
     
     // General module attributes as bullet points
-    fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Kind:</B> %s</TD></TR>",   kind_to_string(current_module->kind));
+    emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Kind:</B> %s</TD></TR>",   kind_to_string(current_module->kind));
     
     if(current_module->kind != MODULE_UART){
       char *pin_str = pin_to_string(current_module->pin);
-      fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pin:</B> %s</TD></TR>",    pin_str);
+      emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pin:</B> %s</TD></TR>",    pin_str);
       free(pin_str);
     } else {
       char *tx_pin_str = pin_to_string(current_module->pin);
       char *rx_pin_str = pin_to_string(current_module->data.uart.rx_pin);
-      fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>TX Pin:</B> %s</TD></TR>", tx_pin_str);
-      fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>RX Pin:</B> %s</TD></TR>", rx_pin_str);
+      emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>TX Pin:</B> %s</TD></TR>", tx_pin_str);
+      emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>RX Pin:</B> %s</TD></TR>", rx_pin_str);
       free(tx_pin_str);
       free(rx_pin_str);
     }
-
-    fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Enable:</B> %s</TD></TR>", bool_to_string(current_module->enable));
+      
+    emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Enable:</B> %s</TD></TR>", bool_to_string(current_module->enable));
     
     
     
     // Print module-specific data
     switch(current_module->kind){
-      case MODULE_OUTPUT:       fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Type:</B> %s</TD></TR>",
-                                                gpio_type_to_string(current_module->data.output.type));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pull:</B> %s</TD></TR>",
-                                                gpio_pull_to_string(current_module->data.output.pull));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Speed:</B> %s</TD></TR>",
-                                                gpio_speed_to_string(current_module->data.output.speed));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Init:</B> %s</TD></TR>",
-                                                gpio_init_to_string(current_module->data.output.init));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Active Level:</B> %s</TD></TR>",
-                                                level_to_string(current_module->data.output.active_level));
+      case MODULE_OUTPUT:       emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Type:</B> %s</TD></TR>",
+                                                       gpio_type_to_string(current_module->data.output.type));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pull:</B> %s</TD></TR>",
+                                                       gpio_pull_to_string(current_module->data.output.pull));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Speed:</B> %s</TD></TR>",
+                                                       gpio_speed_to_string(current_module->data.output.speed));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Init:</B> %s</TD></TR>",
+                                                       gpio_init_to_string(current_module->data.output.init));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Active Level:</B> %s</TD></TR>",
+                                                       level_to_string(current_module->data.output.active_level));
                                 break;
-      case MODULE_INPUT:        fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pull:</B> %s</TD></TR>",
-                                                gpio_pull_to_string(current_module->data.input.pull));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Active Level:</B> %s</TD></TR>",
-                                                level_to_string(current_module->data.input.active_level));
+      case MODULE_INPUT:        emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pull:</B> %s</TD></TR>",
+                                                       gpio_pull_to_string(current_module->data.input.pull));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Active Level:</B> %s</TD></TR>",
+                                                       level_to_string(current_module->data.input.active_level));
                                 break;
-      case MODULE_PWM_OUTPUT:   fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pull:</B> %s</TD></TR>",
-                                          gpio_pull_to_string(current_module->data.pwm.pull));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Speed:</B> %s</TD></TR>",
-                                          gpio_speed_to_string(current_module->data.pwm.speed));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Active Level:</B> %s</TD></TR>",
-                                          level_to_string(current_module->data.pwm.active_level));
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Frequency:</B> %u Hz</TD></TR>",
-                                          current_module->data.pwm.frequency);
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Duty Cycle:</B> %.1f %%</TD></TR>",
-                                          (float)current_module->data.pwm.duty_cycle / 10.0f);
+      case MODULE_PWM_OUTPUT:   emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Pull:</B> %s</TD></TR>",
+                                                 gpio_pull_to_string(current_module->data.pwm.pull));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Speed:</B> %s</TD></TR>",
+                                                 gpio_speed_to_string(current_module->data.pwm.speed));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Active Level:</B> %s</TD></TR>",
+                                                 level_to_string(current_module->data.pwm.active_level));
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Frequency:</B> %u Hz</TD></TR>",
+                                                 current_module->data.pwm.frequency);
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Duty Cycle:</B> %.1f %%</TD></TR>",
+                                                 (float)current_module->data.pwm.duty_cycle / 10.0f);
                                 if(current_module->enable && (dsl_node->controller == STM32F446RE || dsl_node->controller == ESP32)){
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>TIM Number:</B> %u</TD></TR>",
-                                            current_module->data.pwm.tim_number);
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>TIM Channel:</B> %u</TD></TR>",
-                                            current_module->data.pwm.tim_channel);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>TIM Number:</B> %u</TD></TR>",
+                                                   current_module->data.pwm.tim_number);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>TIM Channel:</B> %u</TD></TR>",
+                                                   current_module->data.pwm.tim_channel);
                                 }
                                 if(current_module->enable && dsl_node->controller == STM32F446RE){
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>GPIO AF:</B> %u</TD></TR>",
-                                            current_module->data.pwm.gpio_af);
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Prescaler:</B> %u</TD></TR>",
-                                            current_module->data.pwm.prescaler);
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Period:</B> %u</TD></TR>",
-                                            current_module->data.pwm.period);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>GPIO AF:</B> %u</TD></TR>",
+                                                   current_module->data.pwm.gpio_af);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Prescaler:</B> %u</TD></TR>",
+                                                   current_module->data.pwm.prescaler);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Period:</B> %u</TD></TR>",
+                                                   current_module->data.pwm.period);
                                 }
                                 break;
-      case MODULE_UART:         fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Baudrate:</B> %u</TD></TR>",
-                                                current_module->data.uart.baudrate);
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Databits:</B> %u</TD></TR>",
-                                                current_module->data.uart.databits);
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Stopbits:</B> %.15g</TD></TR>",
-                                                current_module->data.uart.stopbits);
-                                fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Parity:</B> %s</TD></TR>",
-                                                uart_parity_to_string(current_module->data.uart.parity));
+      case MODULE_UART:         emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Baudrate:</B> %u</TD></TR>",
+                                                       current_module->data.uart.baudrate);
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Databits:</B> %u</TD></TR>",
+                                                       current_module->data.uart.databits);
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Stopbits:</B> %.15g</TD></TR>",
+                                                       current_module->data.uart.stopbits);
+                                emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Parity:</B> %s</TD></TR>",
+                                                       uart_parity_to_string(current_module->data.uart.parity));
                                 if(current_module->enable && dsl_node->controller == STM32F446RE){
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>USART Number:</B> %u</TD></TR>",
-                                            current_module->data.uart.usart_number);
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Is UART:</B> %s</TD></TR>",
-                                            bool_to_string(current_module->data.uart.is_uart));
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>GPIO AF:</B> %u</TD></TR>",
-                                            current_module->data.uart.gpio_af);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>USART Number:</B> %u</TD></TR>",
+                                                   current_module->data.uart.usart_number);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Is UART:</B> %s</TD></TR>",
+                                                   bool_to_string(current_module->data.uart.is_uart));
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>GPIO AF:</B> %u</TD></TR>",
+                                                   current_module->data.uart.gpio_af);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>Oversampling:</B> %u</TD></TR>",
+                                                   current_module->data.uart.oversampling);
                                 } else if(current_module->enable && dsl_node->controller == ESP32){
-                                  fprintf(pfDot, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>UART Number:</B> %u</TD></TR>",
-                                            current_module->data.uart.usart_number);
+                                  emitter_printf(output, "\n    <TR><TD ALIGN=\"LEFT\">&#8226; <B>UART Number:</B> %u</TD></TR>",
+                                                   current_module->data.uart.usart_number);
                                 }
                                 break;
       default:  log_error("ast_print_helper", 0, "Unknown module kind enum value '%d'", current_module->kind);
                 break; // This won't be reached due to log_error exiting
     }
     
-    fprintf(pfDot, "\n    </TABLE>>];\n");
+    emitter_append(output, "\n    </TABLE>>];\n");
     current_module = current_module->next;
   }
   
   // Print edges from controller to modules
-  fprintf(pfDot, "\n");
+  emitter_append(output, "\n");
   current_module = dsl_node->modules_root;
   while(current_module != NULL){
     // Skip disabled modules if print_enabled_only is true
@@ -208,11 +234,11 @@ static void ast_print_helper(FILE *pfDot, const ast_dsl_node_t* dsl_node, bool p
       current_module = current_module->next;
       continue;
     }
-    fprintf(pfDot, "  Controller -> Module%d;\n", current_module->node_id);
+    emitter_printf(output, "  Controller -> Module%d;\n", current_module->node_id);
     current_module = current_module->next;
   }
   
-  fprintf(pfDot, "}\n");
+  emitter_append(output, "}\n");
 }
 
 
@@ -2,7 +2,8 @@
 #define __AST_PRINT_H__
 
 #include "astEnums.h"
+#include "emitter.h"
 
-void ast_print(const char* output_path, const ast_dsl_node_t* dsl_node);
+void ast_print(const char* output_path, const ast_dsl_node_t* dsl_node, emitter_t *output, unsigned int emit);
 
 #endif //__AST_PRINT_H__
\ No newline at end of file
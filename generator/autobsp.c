@@ -0,0 +1,322 @@
+#include "autobsp.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "logging.h"
+#include "parserInC.h"
+#include "parserContext.h"
+#include "inputBuffer.h"
+#include "runStats.h"
+#include "emitter.h"
+#include "astBuild.h"
+#include "astCheck.h"
+#include "astGenerate.h"
+
+/**
+ * @brief Steps of the pipeline a session has completed, each step needs the previous one.
+ */
+typedef enum{
+  AUTOBSP_STAGE_EMPTY,    // Nothing parsed yet, or the last step failed
+  AUTOBSP_STAGE_PARSED,   // AST built from the text (autobsp_parse_string)
+  AUTOBSP_STAGE_CHECKED,  // AST checked, sorted and indexed (autobsp_check)
+  AUTOBSP_STAGE_BOUND     // Backend specific parameters bound (autobsp_bind)
+} autobsp_stage_t;
+
+/**
+ * @brief Structure holding the state of one configuration.
+ * 
+ * Consists of the parser context (reused by every parse of the session), the copy of the parsed text and its name,
+ * the AST, the completed steps, the statistics of the scanner, and the messages of the last call.
+ * 
+ * @note A session must only be used by one thread at a time, different sessions can be used on different threads.
+ */
+struct autobsp_session_s{
+  parser_context_t *ctx;          // Owns the scanner, the arena with the AST, and the emitters of the generated code
+  input_buffer_t    input;        // Copy of the parsed text, the names in the AST are slices of it
+  char             *name;         // Name of the text used in messages (e.g. the file name)
+  ast_dsl_node_t   *ast_root;     // AST of the parsed text (NULL before a successful parse)
+  autobsp_stage_t   stage;
+  run_stats_t       stats;
+  emitter_t         diagnostics;  // Messages of the last call (errors, suggestions, syntax errors)
+};
+
+typedef void (*autobsp_step_fn_t)(autobsp_session_t *session);
+
+static autobsp_status_t autobsp_run_step(autobsp_session_t *session, autobsp_step_fn_t step, autobsp_status_t error_status);
+static void autobsp_step_parse(autobsp_session_t *session);
+static void autobsp_step_check(autobsp_session_t *session);
+static void autobsp_step_bind(autobsp_session_t *session);
+static void autobsp_step_generate(autobsp_session_t *session);
+
+
+/* -------------------------------------------- */
+/*          Constructor and destructor          */
+/* -------------------------------------------- */
+
+/**
+ * @brief Creates an empty session.
+ * 
+ * @return Pointer to the new session, or NULL if memory could not be allocated.
+ */
+autobsp_session_t* autobsp_session_new(void){
+  autobsp_session_t *session = (autobsp_session_t*)calloc(1, sizeof(autobsp_session_t));
+  if(session == NULL)
+    return NULL;
+  
+  session->ctx      = NULL;
+  session->name     = NULL;
+  session->ast_root = NULL;
+  session->stage    = AUTOBSP_STAGE_EMPTY;
+  session->input.data        = NULL;
+  session->input.length      = 0;
+  session->input.mapped_size = 0;
+  run_stats_init(&session->stats);
+  emitter_init(&session->diagnostics);
+  return session;
+}
+
+/**
+ * @brief Frees a session with its AST, its generated code and its diagnostics.
+ * 
+ * @param session Pointer to the session (NULL is ignored).
+ * 
+ * @note All buffers returned for the session become invalid.
+ */
+void autobsp_session_free(autobsp_session_t *session){
+  if(session == NULL)
+    return;
+  
+  parser_free_context(session->ctx);
+  input_buffer_release(&session->input);
+  free(session->name);
+  emitter_free(&session->diagnostics);
+  free(session);
+}
+
+
+/* -------------------------------------------- */
+/*                Pipeline steps                */
+/* -------------------------------------------- */
+
+/**
+ * @brief Parses a DSL text and builds its AST (includes the checks for required parameters).
+ * 
+ * @param session Pointer to the session, the AST of an earlier text is released.
+ * @param name Name of the text used in messages (e.g. the file name), NULL for "<string>".
+ * @param text DSL text (does not need to be null-terminated), copied into the session.
+ * @param length Length of the text in bytes.
+ * @return AUTOBSP_OK, or AUTOBSP_ERROR_PARSE with the messages in autobsp_diagnostics().
+ * 
+ * @note The memory of an earlier parse of the session is reused.
+ */
+autobsp_status_t autobsp_parse_string(autobsp_session_t *session, const char *name, const char *text, size_t length){
+  if(session == NULL || (text == NULL && length > 0))
+    return AUTOBSP_ERROR_INVALID_ARGUMENT;
+  
+  session->stage    = AUTOBSP_STAGE_EMPTY;
+  session->ast_root = NULL;
+  emitter_clear(&session->diagnostics);
+  
+  // Replace the text and its name (the old AST is released by the reset of the context in the parse step)
+  input_buffer_release(&session->input);
+  if(!input_buffer_copy(&session->input, text, length))
+    return AUTOBSP_ERROR_MEMORY;
+  
+  char *name_copy = strdup((name != NULL) ? name : "<string>");
+  if(name_copy == NULL)
+    return AUTOBSP_ERROR_MEMORY;
+  free(session->name);
+  session->name = name_copy;
+  
+  autobsp_status_t status = autobsp_run_step(session, autobsp_step_parse, AUTOBSP_ERROR_PARSE);
+  if(status == AUTOBSP_OK)
+    session->stage = AUTOBSP_STAGE_PARSED;
+  return status;
+}
+
+/**
+ * @brief Checks the parsed configuration for the controller, then sorts and indexes the modules for binding and generation.
+ * 
+ * @param session Pointer to the session with a parsed text.
+ * @return AUTOBSP_OK, AUTOBSP_ERROR_INVALID_STATE if nothing is parsed, or AUTOBSP_ERROR_CHECK with the messages in autobsp_diagnostics().
+ */
+autobsp_status_t autobsp_check(autobsp_session_t *session){
+  if(session == NULL)
+    return AUTOBSP_ERROR_INVALID_ARGUMENT;
+  emitter_clear(&session->diagnostics);
+  if(session->stage != AUTOBSP_STAGE_PARSED)
+    return AUTOBSP_ERROR_INVALID_STATE;
+  
+  autobsp_status_t status = autobsp_run_step(session, autobsp_step_check, AUTOBSP_ERROR_CHECK);
+  if(status == AUTOBSP_OK)
+    session->stage = AUTOBSP_STAGE_CHECKED;
+  return status;
+}
+
+/**
+ * @brief Binds the backend specific parameters (e.g. timers, prescalers, peripheral numbers) of the checked configuration.
+ * 
+ * @param session Pointer to the session with a checked configuration.
+ * @return AUTOBSP_OK, AUTOBSP_ERROR_INVALID_STATE if it is not checked, or AUTOBSP_ERROR_BIND with the messages in autobsp_diagnostics().
+ */
+autobsp_status_t autobsp_bind(autobsp_session_t *session){
+  if(session == NULL)
+    return AUTOBSP_ERROR_INVALID_ARGUMENT;
+  emitter_clear(&session->diagnostics);
+  if(session->stage != AUTOBSP_STAGE_CHECKED)
+    return AUTOBSP_ERROR_INVALID_STATE;
+  
+  autobsp_status_t status = autobsp_run_step(session, autobsp_step_bind, AUTOBSP_ERROR_BIND);
+  if(status == AUTOBSP_OK)
+    session->stage = AUTOBSP_STAGE_BOUND;
+  return status;
+}
+
+/**
+ * @brief Generates the header and source file of the bound configuration in memory.
+ * 
+ * @param session Pointer to the session with a bound configuration.
+ * @param header Pointer to store the generated header file in (generated_bsp.h), can be NULL.
+ * @param source Pointer to store the generated source file in (generated_bsp.c), can be NULL.
+ * @return AUTOBSP_OK, AUTOBSP_ERROR_INVALID_STATE if it is not bound, or AUTOBSP_ERROR_GENERATE with the messages in autobsp_diagnostics().
+ * 
+ * @note The buffers are owned by the session and stay valid until the next parse or generation of the session or until it is freed.
+ */
+autobsp_status_t autobsp_generate_to_buffer(autobsp_session_t *session, autobsp_buffer_t *header, autobsp_buffer_t *source){
+  if(session == NULL)
+    return AUTOBSP_ERROR_INVALID_ARGUMENT;
+  emitter_clear(&session->diagnostics);
+  if(session->stage != AUTOBSP_STAGE_BOUND)
+    return AUTOBSP_ERROR_INVALID_STATE;
+  
+  autobsp_status_t status = autobsp_run_step(session, autobsp_step_generate, AUTOBSP_ERROR_GENERATE);
+  if(status != AUTOBSP_OK)
+    return status;
+  
+  if(header != NULL){
+    header->data   = session->ctx->header_emitter.data;
+    header->length = session->ctx->header_emitter.length;
+  }
+  if(source != NULL){
+    source->data   = session->ctx->source_emitter.data;
+    source->length = session->ctx->source_emitter.length;
+  }
+  return AUTOBSP_OK;
+}
+
+/**
+ * @brief Runs one step of the pipeline, collecting its messages and turning a reported error into a status.
+ * 
+ * @param session Pointer to the session.
+ * @param step Step to run.
+ * @param error_status Status returned if the step reports an error.
+ * @return AUTOBSP_OK, or error_status if the step reported an error (the session is empty then and has to be parsed again).
+ * 
+ * @note No log file is written, error messages and suggestions are appended to the diagnostics of the session.
+ */
+static autobsp_status_t autobsp_run_step(autobsp_session_t *session, autobsp_step_fn_t step, autobsp_status_t error_status){
+  log_set_diagnostics(&session->diagnostics);
+  init_logging(NULL);
+  
+  // Every reported error jumps back here instead of exiting the program
+  jmp_buf error_jump;
+  if(setjmp(error_jump) != 0){
+    log_set_error_jump(NULL);
+    log_set_diagnostics(NULL);
+    session->stage    = AUTOBSP_STAGE_EMPTY;
+    session->ast_root = NULL;
+    return error_status;
+  }
+  log_set_error_jump(&error_jump);
+  
+  step(session);
+  
+  log_set_error_jump(NULL);
+  close_logging();
+  log_set_diagnostics(NULL);
+  return AUTOBSP_OK;
+}
+
+/**
+ * @brief Parse step: scans and parses the text, checks the required parameters and builds the AST.
+ */
+static void autobsp_step_parse(autobsp_session_t *session){
+  run_stats_init(&session->stats);
+  if(session->ctx == NULL)
+    session->ctx = parser_new_context(session->name, &session->input, &session->stats);
+  else
+    parser_reset_context(session->ctx, session->name, &session->input, &session->stats);
+  
+  parser_context_t *ctx = session->ctx;
+  int ret_parse = yyparse(ctx, ctx->scanner);
+  if(ret_parse != 0)
+    log_error("autobsp_parse_string", 0, "Parsing failed with error code %d", ret_parse);
+  if(ctx->dsl_builder == NULL)
+    log_error("autobsp_parse_string", 0, "Failed to generate DSL builder from parsed code.");
+  
+  ast_check_required_params(ctx->dsl_builder);
+  session->ast_root = ast_convert_dsl_builder_to_dsl_node(&ctx->arena, ctx->dsl_builder);
+  ctx->dsl_builder = NULL;
+}
+
+/**
+ * @brief Check step: checks all enabled modules, sorts the modules by pin and indexes the enabled modules.
+ */
+static void autobsp_step_check(autobsp_session_t *session){
+  ast_check_all_enabled_modules(session->ast_root);
+  ast_sort_modules_by_pin(session->ast_root);
+  ast_index_enabled_modules(&session->ctx->arena, session->ast_root);
+}
+
+/**
+ * @brief Bind step: binds the backend specific parameters.
+ */
+static void autobsp_step_bind(autobsp_session_t *session){
+  ast_bind_backend_specific_params(session->ast_root);
+}
+
+/**
+ * @brief Generate step: generates the header and source file into the emitters of the context.
+ */
+static void autobsp_step_generate(autobsp_session_t *session){
+  ast_generate_code_to_emitters(session->ast_root, &session->ctx->header_emitter, &session->ctx->source_emitter);
+}
+
+
+/* -------------------------------------------- */
+/*                 Diagnostics                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Returns the messages of the last call of a session (errors, suggestions for unknown tokens, syntax errors).
+ * 
+ * @param session Pointer to the session.
+ * @return Null-terminated messages (empty if the last call succeeded), valid until the next call of the session.
+ */
+const char* autobsp_diagnostics(const autobsp_session_t *session){
+  if(session == NULL || session->diagnostics.data == NULL)
+    return "";
+  return session->diagnostics.data;
+}
+
+/**
+ * @brief Returns the name of a status (e.g. "AUTOBSP_ERROR_PARSE").
+ * 
+ * @param status Status returned by a library call.
+ * @return Name of the status, "UNKNOWN" for invalid values.
+ */
+const char* autobsp_status_to_string(autobsp_status_t status){
+  switch(status){
+    case AUTOBSP_OK:                     return "AUTOBSP_OK";
+    case AUTOBSP_ERROR_INVALID_ARGUMENT: return "AUTOBSP_ERROR_INVALID_ARGUMENT";
+    case AUTOBSP_ERROR_INVALID_STATE:    return "AUTOBSP_ERROR_INVALID_STATE";
+    case AUTOBSP_ERROR_MEMORY:           return "AUTOBSP_ERROR_MEMORY";
+    case AUTOBSP_ERROR_PARSE:            return "AUTOBSP_ERROR_PARSE";
+    case AUTOBSP_ERROR_CHECK:            return "AUTOBSP_ERROR_CHECK";
+    case AUTOBSP_ERROR_BIND:             return "AUTOBSP_ERROR_BIND";
+    case AUTOBSP_ERROR_GENERATE:         return "AUTOBSP_ERROR_GENERATE";
+    default:                             return "UNKNOWN";
+  }
+}
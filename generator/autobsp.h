@@ -0,0 +1,52 @@
+#ifndef __AUTOBSP_H__
+#define __AUTOBSP_H__
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief Result of a library call.
+ * 
+ * On errors, the messages of the failed step are available with autobsp_diagnostics().
+ */
+typedef enum{
+  AUTOBSP_OK = 0,
+  AUTOBSP_ERROR_INVALID_ARGUMENT,  // Session or text is NULL
+  AUTOBSP_ERROR_INVALID_STATE,     // A step was called before the steps it depends on succeeded
+  AUTOBSP_ERROR_MEMORY,            // The text could not be copied
+  AUTOBSP_ERROR_PARSE,             // Unknown token, syntax error, invalid or missing parameter
+  AUTOBSP_ERROR_CHECK,             // The configuration is not valid for the controller (e.g. pin used twice)
+  AUTOBSP_ERROR_BIND,              // Backend specific parameters could not be determined (e.g. timer of a PWM output)
+  AUTOBSP_ERROR_GENERATE           // The code could not be generated
+} autobsp_status_t;
+
+/**
+ * @brief Text generated by the library (null-terminated), owned by the session.
+ */
+typedef struct{
+  const char *data;
+  size_t      length;
+} autobsp_buffer_t;
+
+// State of one configuration (parsed text, AST, generated code, diagnostics), see autobsp.c
+typedef struct autobsp_session_s autobsp_session_t;
+
+autobsp_session_t* autobsp_session_new(void);
+void autobsp_session_free(autobsp_session_t *session);
+
+autobsp_status_t autobsp_parse_string(autobsp_session_t *session, const char *name, const char *text, size_t length);
+autobsp_status_t autobsp_check(autobsp_session_t *session);
+autobsp_status_t autobsp_bind(autobsp_session_t *session);
+autobsp_status_t autobsp_generate_to_buffer(autobsp_session_t *session, autobsp_buffer_t *header, autobsp_buffer_t *source);
+
+const char* autobsp_diagnostics(const autobsp_session_t *session);
+const char* autobsp_status_to_string(autobsp_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__AUTOBSP_H__
@@ -0,0 +1,511 @@
+#include "batchMode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define BATCH_DEFAULT_OUTPUT_ROOT "output"  // Output root for entries without an explicit output path
+#define BATCH_MAX_JOBS            256       // Upper limit for the number of worker threads
+
+/**
+ * @brief Structure representing one DSL file of the batch.
+ * 
+ * Consists of the code file, its output directory, and the result and duration of its run.
+ */
+typedef struct{
+  char   *code_file;
+  char   *output_path;
+  int     result;       // 0 = success
+  double  duration_ms;  // Wall time of the run
+} batch_entry_t;
+
+/**
+ * @brief Structure shared by all worker threads.
+ * 
+ * Consists of the list of entries, the index of the next unprocessed entry, the number of finished entries,
+ * the lock protecting both counters and the status output, the function running one entry, and the options of all runs.
+ */
+typedef struct{
+  batch_entry_t   *entries;
+  size_t           entry_count;
+  size_t           next_entry;
+  size_t           finished_entries;
+  pthread_mutex_t  lock;
+  batch_run_fn_t   run;
+  const generator_options_t *options;
+} batch_queue_t;
+
+/**
+ * @brief Structure pairing the resolved output directory of an entry with the entry (see batch_check_unique_outputs).
+ */
+typedef struct{
+  char   *resolved_path;
+  size_t  entry_index;
+} batch_output_t;
+
+static void batch_print_usage();
+static bool batch_add_entry(batch_entry_t **entries, size_t *count, size_t *capacity, const char *code_file, const char *output_path);
+static bool batch_add_argument_entry(batch_entry_t **entries, size_t *count, size_t *capacity, const char *argument);
+static bool batch_read_manifest(const char *manifest_file, batch_entry_t **entries, size_t *count, size_t *capacity);
+static void batch_free_entries(batch_entry_t *entries, size_t count);
+static bool batch_check_unique_outputs(const batch_entry_t *entries, size_t count);
+static int batch_compare_outputs(const void *a, const void *b);
+
+static bool make_directories(const char *path);
+static double monotonic_ms();
+static void *batch_worker(void *arg);
+static void batch_print_summary(const batch_entry_t *entries, size_t count, unsigned int jobs, double wall_ms, bool log_written);
+
+
+/* -------------------------------------------- */
+/*                  Batch mode                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Runs the generator for several DSL files on a pool of worker threads.
+ * 
+ * Arguments: [--jobs <n>] (--manifest <manifest_file> | <codefile>[:<output_path>] ...)
+ * 
+ * @param argc Number of arguments after "--batch".
+ * @param argv Arguments after "--batch".
+ * @param run Function running the generator for one DSL file.
+ * @param options Options passed to every run.
+ * @return 0 if all files were generated successfully, 1 otherwise.
+ * 
+ * @note Prints the status of each file when it is finished and a timing summary at the end.
+ * @note Output directories that do not exist are created.
+ */
+int batch_main(int argc, char *argv[], batch_run_fn_t run, const generator_options_t *options){
+  batch_entry_t *entries = NULL;
+  size_t count = 0, capacity = 0;
+  
+  long online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned int jobs = (online_cpus > 0) ? (unsigned int)online_cpus : 1;
+  
+  // Parse arguments
+  for(int i = 0; i < argc; i++){
+    if(strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "-j") == 0){
+      if(i + 1 >= argc || atoi(argv[i + 1]) <= 0){
+        fprintf(stderr, "\nERROR 'batch_main': '%s' needs a positive number of worker threads.\n", argv[i]);
+        batch_free_entries(entries, count);
+        return 1;
+      }
+      jobs = (unsigned int)atoi(argv[++i]);
+      
+    } else if(strcmp(argv[i], "--manifest") == 0){
+      if(i + 1 >= argc){
+        fprintf(stderr, "\nERROR 'batch_main': '--manifest' needs a manifest file.\n");
+        batch_free_entries(entries, count);
+        return 1;
+      }
+      if(!batch_read_manifest(argv[++i], &entries, &count, &capacity)){
+        batch_free_entries(entries, count);
+        return 1;
+      }
+      
+    } else if(!batch_add_argument_entry(&entries, &count, &capacity, argv[i])){
+      batch_free_entries(entries, count);
+      return 1;
+    }
+  }
+  
+  if(count == 0){
+    batch_print_usage();
+    return 1;
+  }
+  
+  if(jobs > BATCH_MAX_JOBS)
+    jobs = BATCH_MAX_JOBS;
+  if(jobs > count)
+    jobs = (unsigned int)count;
+  
+  // Create missing output directories upfront (not thread safe for nested paths)
+  for(size_t i = 0; i < count; i++){
+    if(!make_directories(entries[i].output_path)){
+      fprintf(stderr, "\nERROR 'batch_main': Could not create output directory '%s': %s\n", entries[i].output_path, strerror(errno));
+      batch_free_entries(entries, count);
+      return 1;
+    }
+  }
+  
+  // Two runs writing into the same directory would overwrite each other's files (and regeneration cache)
+  if(!batch_check_unique_outputs(entries, count)){
+    batch_free_entries(entries, count);
+    return 1;
+  }
+  
+  printf("Generating %zu DSL files with %u worker threads\n", count, jobs);
+  
+  // Start worker pool
+  batch_queue_t queue = {
+    .entries          = entries,
+    .entry_count      = count,
+    .next_entry       = 0,
+    .finished_entries = 0,
+    .run              = run,
+    .options          = options
+  };
+  pthread_mutex_init(&queue.lock, NULL);
+  
+  double start_ms = monotonic_ms();
+  
+  pthread_t threads[BATCH_MAX_JOBS];
+  unsigned int started = 0;
+  for(unsigned int i = 0; i < jobs; i++){
+    if(pthread_create(&threads[i], NULL, batch_worker, &queue) != 0){
+      fprintf(stderr, "\nWARNING 'batch_main': Could not start worker thread %u, continuing with %u threads.\n", i, started);
+      break;
+    }
+    started++;
+  }
+  
+  if(started == 0) // Fall back to the calling thread
+    batch_worker(&queue);
+  
+  for(unsigned int i = 0; i < started; i++)
+    pthread_join(threads[i], NULL);
+  
+  double wall_ms = monotonic_ms() - start_ms;
+  pthread_mutex_destroy(&queue.lock);
+  
+  batch_print_summary(entries, count, (started == 0) ? 1 : started, wall_ms, (options->emit & EMIT_LOG) != 0);
+  
+  int result = 0;
+  for(size_t i = 0; i < count; i++)
+    if(entries[i].result != 0)
+      result = 1;
+  
+  batch_free_entries(entries, count);
+  return result;
+}
+
+/**
+ * @brief Worker thread: takes the next unprocessed entry until all entries are processed.
+ * 
+ * @param arg Pointer to the shared batch queue.
+ * @return Always NULL.
+ */
+static void *batch_worker(void *arg){
+  batch_queue_t *queue = (batch_queue_t*)arg;
+  
+  while(true){
+    pthread_mutex_lock(&queue->lock);
+    if(queue->next_entry >= queue->entry_count){
+      pthread_mutex_unlock(&queue->lock);
+      return NULL;
+    }
+    batch_entry_t *entry = &queue->entries[queue->next_entry++];
+    pthread_mutex_unlock(&queue->lock);
+    
+    double start_ms = monotonic_ms();
+    entry->result = queue->run(entry->code_file, entry->output_path, queue->options);
+    entry->duration_ms = monotonic_ms() - start_ms;
+    
+    // Print status of the finished entry
+    pthread_mutex_lock(&queue->lock);
+    queue->finished_entries++;
+    printf("[%zu/%zu] %s  %s -> %s (%.2f ms)\n", queue->finished_entries, queue->entry_count,
+           (entry->result == 0) ? "OK  " : "FAIL", entry->code_file, entry->output_path, entry->duration_ms);
+    fflush(stdout);
+    pthread_mutex_unlock(&queue->lock);
+  }
+}
+
+/**
+ * @brief Prints the aggregated results and timings of the batch.
+ * 
+ * @param entries Array of processed entries.
+ * @param count Number of entries.
+ * @param jobs Number of worker threads used.
+ * @param wall_ms Wall time of the whole batch.
+ * @param log_written True if the runs write AutoBSP.log (referenced for failed files).
+ */
+static void batch_print_summary(const batch_entry_t *entries, size_t count, unsigned int jobs, double wall_ms, bool log_written){
+  size_t failed = 0;
+  double sum_ms = 0.0, min_ms = 0.0, max_ms = 0.0;
+  
+  for(size_t i = 0; i < count; i++){
+    if(entries[i].result != 0)
+      failed++;
+    
+    sum_ms += entries[i].duration_ms;
+    if(i == 0 || entries[i].duration_ms < min_ms)
+      min_ms = entries[i].duration_ms;
+    if(i == 0 || entries[i].duration_ms > max_ms)
+      max_ms = entries[i].duration_ms;
+  }
+  
+  printf("\nBatch summary: %zu files, %zu succeeded, %zu failed, %u worker threads\n", count, count - failed, failed, jobs);
+  printf("  Wall time:        %10.2f ms\n", wall_ms);
+  printf("  Sum of file runs: %10.2f ms (speedup %.2fx)\n", sum_ms, (wall_ms > 0.0) ? sum_ms / wall_ms : 0.0);
+  printf("  Per file:         %10.2f ms min, %.2f ms avg, %.2f ms max\n", min_ms, sum_ms / (double)count, max_ms);
+  
+  if(failed > 0){
+    printf("  Failed files:\n");
+    for(size_t i = 0; i < count; i++)
+      if(entries[i].result != 0){
+        if(log_written)
+          printf("    %s (see '%s/AutoBSP.log')\n", entries[i].code_file, entries[i].output_path);
+        else
+          printf("    %s\n", entries[i].code_file);
+      }
+  }
+}
+
+
+/* -------------------------------------------- */
+/*               Batch entry list               */
+/* -------------------------------------------- */
+
+static void batch_print_usage(){
+  fprintf(stderr, "\nERROR 'batch_main': No DSL files given.\n");
+  fprintf(stderr, "              Usage: AutoBSP [--stats] --batch [--jobs <n>] (--manifest <manifest_file> | <codefile_name>[:<output_path>] ...)\n");
+  fprintf(stderr, "              Manifest: one '<codefile_name> [<output_path>]' per line, '#' starts a comment\n");
+  fprintf(stderr, "              Without output path the files are generated into '%s/<codefile_name without extension>'\n", BATCH_DEFAULT_OUTPUT_ROOT);
+}
+
+/**
+ * @brief Appends a new entry to the batch entry list.
+ * 
+ * @param entries Pointer to the dynamic array of entries.
+ * @param count Pointer to the number of entries.
+ * @param capacity Pointer to the allocated number of entries.
+ * @param code_file Path of the DSL file.
+ * @param output_path Path of the output directory, or NULL to derive it from the code file name.
+ * @return true if the entry was added; false if memory could not be allocated.
+ */
+static bool batch_add_entry(batch_entry_t **entries, size_t *count, size_t *capacity, const char *code_file, const char *output_path){
+  if(*count == *capacity){
+    size_t new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+    batch_entry_t *new_entries = (batch_entry_t*)realloc(*entries, new_capacity * sizeof(batch_entry_t));
+    if(new_entries == NULL){
+      fprintf(stderr, "\nERROR 'batch_add_entry': Could not allocate memory for batch entries.\n");
+      return false;
+    }
+    *entries = new_entries;
+    *capacity = new_capacity;
+  }
+  
+  batch_entry_t *entry = &(*entries)[*count];
+  entry->code_file   = strdup(code_file);
+  entry->result      = 1;
+  entry->duration_ms = 0.0;
+  
+  if(output_path != NULL){
+    entry->output_path = strdup(output_path);
+  } else{
+    // Default: <output root>/<file name without directory and extension>
+    const char *file_name = strrchr(code_file, '/');
+    file_name = (file_name != NULL) ? file_name + 1 : code_file;
+    const char *extension = strrchr(file_name, '.');
+    int name_length = (extension != NULL && extension != file_name) ? (int)(extension - file_name) : (int)strlen(file_name);
+    
+    size_t size = strlen(BATCH_DEFAULT_OUTPUT_ROOT) + 1 + (size_t)name_length + 1;
+    entry->output_path = (char*)malloc(size);
+    if(entry->output_path != NULL)
+      snprintf(entry->output_path, size, "%s/%.*s", BATCH_DEFAULT_OUTPUT_ROOT, name_length, file_name);
+  }
+  
+  if(entry->code_file == NULL || entry->output_path == NULL){
+    free(entry->code_file);
+    free(entry->output_path);
+    fprintf(stderr, "\nERROR 'batch_add_entry': Could not allocate memory for batch entry '%s'.\n", code_file);
+    return false;
+  }
+  
+  (*count)++;
+  return true;
+}
+
+/**
+ * @brief Appends an entry given on the command line as "<codefile>[:<output_path>]".
+ * 
+ * @return true if the entry was added; false otherwise.
+ */
+static bool batch_add_argument_entry(batch_entry_t **entries, size_t *count, size_t *capacity, const char *argument){
+  if(argument[0] == '-' && argument[1] == '-'){
+    fprintf(stderr, "\nERROR 'batch_main': Unknown option '%s'.\n", argument);
+    return false;
+  }
+  
+  const char *separator = strchr(argument, ':');
+  if(separator == NULL)
+    return batch_add_entry(entries, count, capacity, argument, NULL);
+  
+  char *code_file = strndup(argument, (size_t)(separator - argument));
+  if(code_file == NULL){
+    fprintf(stderr, "\nERROR 'batch_add_argument_entry': Could not allocate memory for batch entry '%s'.\n", argument);
+    return false;
+  }
+  bool added = batch_add_entry(entries, count, capacity, code_file, (separator[1] != '\0') ? separator + 1 : NULL);
+  free(code_file);
+  return added;
+}
+
+/**
+ * @brief Reads all entries of a manifest file.
+ * 
+ * Each line contains a code file and optionally its output directory, separated by whitespace.
+ * Empty lines and everything after a '#' are ignored.
+ * 
+ * @return true if the manifest was read; false if it could not be opened or an entry could not be added.
+ */
+static bool batch_read_manifest(const char *manifest_file, batch_entry_t **entries, size_t *count, size_t *capacity){
+  FILE *manifest = fopen(manifest_file, "r");
+  if(manifest == NULL){
+    fprintf(stderr, "\nERROR 'batch_read_manifest': Error opening manifest file '%s'\n", manifest_file);
+    return false;
+  }
+  
+  char *line = NULL;
+  size_t line_size = 0;
+  int line_nr = 0;
+  bool success = true;
+  
+  while(success && getline(&line, &line_size, manifest) != -1){
+    line_nr++;
+    
+    char *comment = strchr(line, '#');
+    if(comment != NULL)
+      *comment = '\0';
+    
+    char *save_ptr = NULL;
+    char *code_file   = strtok_r(line, " \t\r\n", &save_ptr);
+    char *output_path = strtok_r(NULL, " \t\r\n", &save_ptr);
+    char *unexpected  = strtok_r(NULL, " \t\r\n", &save_ptr);
+    
+    if(code_file == NULL)
+      continue;
+    
+    if(unexpected != NULL){
+      fprintf(stderr, "\nERROR 'batch_read_manifest': Line %d of '%s' has more than two entries ('%s').\n", line_nr, manifest_file, unexpected);
+      success = false;
+    } else{
+      success = batch_add_entry(entries, count, capacity, code_file, output_path);
+    }
+  }
+  
+  free(line);
+  fclose(manifest);
+  return success;
+}
+
+/**
+ * @brief Frees all entries and the entry array.
+ */
+static void batch_free_entries(batch_entry_t *entries, size_t count){
+  for(size_t i = 0; i < count; i++){
+    free(entries[i].code_file);
+    free(entries[i].output_path);
+  }
+  free(entries);
+}
+
+
+/**
+ * @brief Checks that no two entries share an output directory.
+ * 
+ * The directories are compared after resolving them (realpath), so differently written paths of the same directory
+ * (e.g. "out" and "./out/") and equal default paths of code files in different directories are detected.
+ * 
+ * @param entries Array of entries (output directories created).
+ * @param count Number of entries.
+ * @return true if all output directories are distinct; false otherwise (an error is printed).
+ */
+static bool batch_check_unique_outputs(const batch_entry_t *entries, size_t count){
+  batch_output_t *outputs = (batch_output_t*)calloc(count, sizeof(batch_output_t));
+  if(outputs == NULL){
+    fprintf(stderr, "\nERROR 'batch_check_unique_outputs': Could not allocate memory for %zu output directories.\n", count);
+    return false;
+  }
+  
+  bool unique = true;
+  size_t resolved = 0;
+  for(; resolved < count; resolved++){
+    outputs[resolved].entry_index = resolved;
+    outputs[resolved].resolved_path = realpath(entries[resolved].output_path, NULL);
+    if(outputs[resolved].resolved_path == NULL){
+      fprintf(stderr, "\nERROR 'batch_check_unique_outputs': Could not resolve output directory '%s': %s\n", entries[resolved].output_path, strerror(errno));
+      unique = false;
+      break;
+    }
+  }
+  
+  if(unique){
+    qsort(outputs, count, sizeof(batch_output_t), batch_compare_outputs);
+    for(size_t i = 1; i < count; i++){
+      if(strcmp(outputs[i - 1].resolved_path, outputs[i].resolved_path) == 0){
+        const batch_entry_t *first  = &entries[outputs[i - 1].entry_index];
+        const batch_entry_t *second = &entries[outputs[i].entry_index];
+        fprintf(stderr, "\nERROR 'batch_main': '%s' and '%s' have the same output directory '%s'.\n", first->code_file, second->code_file, outputs[i].resolved_path);
+        fprintf(stderr, "              Give each DSL file its own output directory (<codefile_name>:<output_path>).\n");
+        unique = false;
+        break;
+      }
+    }
+  }
+  
+  for(size_t i = 0; i < count; i++)
+    free(outputs[i].resolved_path);
+  free(outputs);
+  return unique;
+}
+
+/**
+ * @brief Orders output directories by their resolved path, entries with equal paths by their position in the batch.
+ */
+static int batch_compare_outputs(const void *a, const void *b){
+  const batch_output_t *output_a = (const batch_output_t*)a;
+  const batch_output_t *output_b = (const batch_output_t*)b;
+  int order = strcmp(output_a->resolved_path, output_b->resolved_path);
+  if(order != 0)
+    return order;
+  return (output_a->entry_index < output_b->entry_index) ? -1 : (output_a->entry_index > output_b->entry_index);
+}
+
+
+/* -------------------------------------------- */
+/*               Helper functions               */
+/* -------------------------------------------- */
+
+/**
+ * @brief Creates a directory and all missing parent directories (like "mkdir -p").
+ * 
+ * @param path Path of the directory.
+ * @return true if the directory exists afterwards; false otherwise (errno is set).
+ */
+static bool make_directories(const char *path){
+  char buffer[4096];
+  if(snprintf(buffer, sizeof(buffer), "%s", path) >= (int)sizeof(buffer)){
+    errno = ENAMETOOLONG;
+    return false;
+  }
+  
+  for(char *p = buffer + 1; *p != '\0'; p++){
+    if(*p != '/')
+      continue;
+    *p = '\0';
+    if(mkdir(buffer, 0777) != 0 && errno != EEXIST)
+      return false;
+    *p = '/';
+  }
+  
+  if(mkdir(buffer, 0777) != 0 && errno != EEXIST)
+    return false;
+  return true;
+}
+
+/**
+ * @brief Returns the current time of the monotonic clock in milliseconds.
+ */
+static double monotonic_ms(){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1.0e6;
+}
@@ -0,0 +1,15 @@
+#ifndef __BATCH_MODE_H__
+#define __BATCH_MODE_H__
+
+#include "generatorOptions.h"
+
+/**
+ * @brief Function that runs the generator for one DSL file.
+ * 
+ * Returns 0 on success and a non-zero value on failure.
+ */
+typedef int (*batch_run_fn_t)(const char *code_file, const char *output_path, const generator_options_t *options);
+
+int batch_main(int argc, char *argv[], batch_run_fn_t run, const generator_options_t *options);
+
+#endif //__BATCH_MODE_H__
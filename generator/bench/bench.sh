@@ -0,0 +1,91 @@
+#!/bin/bash
+# Benchmark of the complete generator pipeline on synthetic DSL configurations (run with 'make bench' in ./generator)
+#
+# For every controller, module count and comment density, a configuration is generated with generateBenchDsl,
+# the generator is run BENCH_REPEAT times (with --force --json, so the regeneration cache is bypassed), and the
+# fastest run is reported with its phase timings and throughput. All JSON reports are collected in results.jsonl.
+#
+# Settings (environment variables):
+#   BENCH_CONTROLLERS  Controllers to benchmark          (default: "STM32F446RE ESP32")
+#   BENCH_SIZES        Numbers of modules                (default: "10 100 1000 10000 100000")
+#   BENCH_COMMENTS     Comment lines in front of modules (default: "0 4")
+#   BENCH_REPEAT       Runs per configuration            (default: 3)
+#   BENCH_DIR          Directory for configurations, outputs and results (default: bench/output)
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+AUTOBSP="$SCRIPT_DIR/../AutoBSP"
+GENERATE_DSL="$SCRIPT_DIR/generateBenchDsl"
+
+BENCH_CONTROLLERS="${BENCH_CONTROLLERS:-STM32F446RE ESP32}"
+BENCH_SIZES="${BENCH_SIZES:-10 100 1000 10000 100000}"
+BENCH_COMMENTS="${BENCH_COMMENTS:-0 4}"
+BENCH_REPEAT="${BENCH_REPEAT:-3}"
+BENCH_DIR="${BENCH_DIR:-$SCRIPT_DIR/output}"
+
+if ! [ -x "$AUTOBSP" ] || ! [ -x "$GENERATE_DSL" ]; then
+  echo "Error: '$AUTOBSP' or '$GENERATE_DSL' not found, build them with 'make bench'."
+  exit 1
+fi
+
+mkdir -p "$BENCH_DIR"
+RESULTS="$BENCH_DIR/results.jsonl"
+: > "$RESULTS"
+
+# Extracts a number from a JSON report: json_value <report> <key>
+json_value() {
+  echo "$1" | grep -o "\"$2\":[0-9.]*" | head -n 1 | cut -d ':' -f 2
+}
+
+printf "%-12s %8s %4s %10s %10s | %9s %9s %9s %9s %9s %9s | %12s %10s\n" \
+       "controller" "modules" "com" "input KiB" "total ms" "parse" "checks" "build" "sort" "print" "generate" "modules/s" "MiB/s"
+
+EXIT_STATUS=0
+for CONTROLLER in $BENCH_CONTROLLERS; do
+  for SIZE in $BENCH_SIZES; do
+    for COMMENTS in $BENCH_COMMENTS; do
+      NAME="${CONTROLLER}_${SIZE}_c${COMMENTS}"
+      DSL_FILE="$BENCH_DIR/$NAME.dsl"
+      OUTPUT="$BENCH_DIR/$NAME"
+      mkdir -p "$OUTPUT"
+      "$GENERATE_DSL" "$CONTROLLER" "$SIZE" "$COMMENTS" > "$DSL_FILE" || exit 1
+      INPUT_BYTES=$(wc -c < "$DSL_FILE")
+
+      # Keep the fastest of all runs
+      BEST=""
+      BEST_TOTAL=""
+      for ((RUN = 0; RUN < BENCH_REPEAT; RUN++)); do
+        REPORT=$("$AUTOBSP" --force --json "$DSL_FILE" "$OUTPUT" | grep '^{')
+        if [ -z "$REPORT" ]; then
+          echo "Error: generator failed for '$DSL_FILE', see '$OUTPUT/AutoBSP.log'."
+          EXIT_STATUS=1
+          break
+        fi
+        TOTAL=$(json_value "$REPORT" "total_ms")
+        if [ -z "$BEST_TOTAL" ] || awk "BEGIN { exit !($TOTAL < $BEST_TOTAL) }"; then
+          BEST="$REPORT"
+          BEST_TOTAL="$TOTAL"
+        fi
+      done
+      [ -z "$BEST" ] && continue
+      echo "$BEST" >> "$RESULTS"
+
+      awk -v controller="$CONTROLLER" -v modules="$(json_value "$BEST" "modules")" -v comments="$COMMENTS" \
+          -v bytes="$INPUT_BYTES" -v total="$BEST_TOTAL" \
+          -v parse="$(json_value "$BEST" "parse")" \
+          -v checks="$(awk "BEGIN { print $(json_value "$BEST" "check_required") + $(json_value "$BEST" "check_ast") }")" \
+          -v build="$(json_value "$BEST" "build_ast")" -v sort="$(json_value "$BEST" "sort")" \
+          -v print_ms="$(json_value "$BEST" "print")" -v generate="$(json_value "$BEST" "generate")" \
+          'BEGIN {
+             seconds = (total > 0) ? total / 1000.0 : 1e-9;
+             printf "%-12s %8d %4d %10.1f %10.3f | %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f | %12.0f %10.2f\n",
+                    controller, modules, comments, bytes / 1024.0, total, parse, checks, build, sort, print_ms, generate,
+                    modules / seconds, bytes / 1048576.0 / seconds
+           }'
+    done
+  done
+done
+
+echo ""
+echo "Phase times in ms (fastest of $BENCH_REPEAT runs), throughput of the complete pipeline."
+echo "JSON reports of all configurations: $RESULTS"
+exit $EXIT_STATUS
@@ -0,0 +1,163 @@
+/**
+ * @file generateBenchDsl.c
+ * @brief Writes a synthetic DSL configuration for benchmarking the generator to stdout.
+ * 
+ * Usage: generateBenchDsl <STM32F446RE|ESP32> <module_count> [<comment_lines_per_module>]
+ * 
+ * The configuration starts with a fixed set of valid enabled modules (GPIO, PWM and UART, as many as fit into
+ * module_count) followed by disabled modules of all kinds with varying parameters, so the file scales to any
+ * size while staying valid. Each module is preceded by the given number of comment lines (line and block comments).
+ * The output is deterministic, the same arguments always produce the same file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Structure describing one supported controller.
+ * 
+ * Consists of the controller name, the valid enabled modules, and the pins used for disabled modules.
+ */
+typedef struct{
+  const char        *name;
+  const char *const *enabled_modules;
+  size_t             enabled_count;
+  const char *const *pins;
+  size_t             pin_count;
+} bench_controller_t;
+
+static const char *const STM32F446RE_ENABLED[] = {
+  "OUTPUT{ name: \"LED_A\" pin: PA5 enable: true }",
+  "OUTPUT{ name: \"LED_B\" pin: PB0 type: opendrain init: on enable: true }",
+  "INPUT{ name: \"BTN_A\" pin: PC13 pull: up active: low enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_A\" pin: PC8 frequency: 2000 duty: 500 enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_B\" pin: PA8 frequency: 2000 duty: 250 enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_C\" pin: PB6 frequency: 50 duty: 75 enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_D\" pin: PA6 frequency: 10 enable: true }",
+  "UART{ name: \"DBG\" tx_pin: PC10 rx_pin: PC11 baudrate: 115200 enable: true }",
+  "UART{ name: \"GPS\" tx_pin: PA9 rx_pin: PA10 baudrate: 9600 parity: even databits: 9 enable: true }"
+};
+
+static const char *const STM32F446RE_PINS[] = {
+  "PA0", "PA1", "PA4", "PA5", "PA6", "PA7", "PA8", "PA9", "PA10", "PA11", "PA12", "PA15",
+  "PB0", "PB1", "PB2", "PB3", "PB4", "PB5", "PB6", "PB7", "PB8", "PB9", "PB10", "PB12",
+  "PC0", "PC1", "PC2", "PC3", "PC4", "PC5", "PC6", "PC7", "PC8", "PC9", "PC10", "PC11", "PC12", "PC13"
+};
+
+static const char *const ESP32_ENABLED[] = {
+  "OUTPUT{ name: \"LED_A\" pin: GPIO2 enable: true }",
+  "INPUT{ name: \"BTN_A\" pin: GPIO34 enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_A\" pin: GPIO22 frequency: 2000 duty: 500 enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_B\" pin: GPIO23 frequency: 2000 duty: 100 enable: true }",
+  "PWM_OUTPUT{ name: \"PWM_C\" pin: GPIO21 frequency: 5000 enable: true }",
+  "UART{ name: \"DBG\" tx_pin: GPIO1 rx_pin: GPIO3 enable: true }",
+  "UART{ name: \"EXT\" tx_pin: GPIO17 rx_pin: GPIO16 baudrate: 9600 enable: true }"
+};
+
+static const char *const ESP32_PINS[] = {
+  "GPIO2", "GPIO4", "GPIO5", "GPIO12", "GPIO13", "GPIO14", "GPIO15", "GPIO16", "GPIO17", "GPIO18",
+  "GPIO19", "GPIO21", "GPIO22", "GPIO23", "GPIO25", "GPIO26", "GPIO27", "GPIO32", "GPIO33"
+};
+
+#define ARRAY_LEN(array) (sizeof(array) / sizeof((array)[0]))
+
+static const bench_controller_t BENCH_CONTROLLERS[] = {
+  { "STM32F446RE", STM32F446RE_ENABLED, ARRAY_LEN(STM32F446RE_ENABLED), STM32F446RE_PINS, ARRAY_LEN(STM32F446RE_PINS) },
+  { "ESP32",       ESP32_ENABLED,       ARRAY_LEN(ESP32_ENABLED),       ESP32_PINS,       ARRAY_LEN(ESP32_PINS) }
+};
+
+static void write_comments(unsigned long module_nr, unsigned long comment_lines);
+static void write_disabled_module(const bench_controller_t *controller, unsigned long module_nr);
+
+
+int main(int argc, char *argv[]){
+  if(argc < 3 || argc > 4){
+    fprintf(stderr, "Usage: %s <STM32F446RE|ESP32> <module_count> [<comment_lines_per_module>]\n", argv[0]);
+    return 1;
+  }
+  
+  const bench_controller_t *controller = NULL;
+  for(size_t i = 0; i < ARRAY_LEN(BENCH_CONTROLLERS); i++)
+    if(strcmp(argv[1], BENCH_CONTROLLERS[i].name) == 0)
+      controller = &BENCH_CONTROLLERS[i];
+  if(controller == NULL){
+    fprintf(stderr, "Unknown controller '%s'\n", argv[1]);
+    return 1;
+  }
+  
+  char *end;
+  unsigned long module_count = strtoul(argv[2], &end, 10);
+  if(*end != '\0' || module_count == 0){
+    fprintf(stderr, "Invalid module count '%s'\n", argv[2]);
+    return 1;
+  }
+  unsigned long comment_lines = 0;
+  if(argc == 4){
+    comment_lines = strtoul(argv[3], &end, 10);
+    if(*end != '\0'){
+      fprintf(stderr, "Invalid number of comment lines '%s'\n", argv[3]);
+      return 1;
+    }
+  }
+  
+  printf("// Synthetic benchmark configuration: %s, %lu modules, %lu comment lines per module\n",
+         controller->name, module_count, comment_lines);
+  printf("AutoBSP{\n  controller: %s\n\n", controller->name);
+  
+  for(unsigned long module_nr = 0; module_nr < module_count; module_nr++){
+    write_comments(module_nr, comment_lines);
+    if(module_nr < controller->enabled_count)
+      printf("  %s\n", controller->enabled_modules[module_nr]);
+    else
+      write_disabled_module(controller, module_nr);
+  }
+  
+  printf("}\n");
+  return 0;
+}
+
+/**
+ * @brief Writes the comment lines in front of a module, alternating line and block comments.
+ * 
+ * @param module_nr Number of the module.
+ * @param comment_lines Number of comment lines.
+ */
+static void write_comments(unsigned long module_nr, unsigned long comment_lines){
+  for(unsigned long line = 0; line < comment_lines; line++){
+    if(line % 2 == 0)
+      printf("  // Module %lu: comment line %lu describing the wiring of this module\n", module_nr, line);
+    else
+      printf("  /* Module %lu: block comment %lu with { braces } and \"quotes\" */\n", module_nr, line);
+  }
+}
+
+/**
+ * @brief Writes one disabled module, the kind and parameters vary with the module number.
+ * 
+ * @param controller Controller of the configuration (provides the pins).
+ * @param module_nr Number of the module (part of its unique name).
+ */
+static void write_disabled_module(const bench_controller_t *controller, unsigned long module_nr){
+  const char *pin    = controller->pins[module_nr % controller->pin_count];
+  const char *pin_rx = controller->pins[(module_nr + 1) % controller->pin_count];
+  
+  switch(module_nr % 4){
+    case 0:
+      printf("  OUTPUT{\n    name: \"OUT_%lu\"\n    pin: %s\n    type: %s\n    init: %s\n    enable: false\n  }\n",
+             module_nr, pin, (module_nr % 8 == 0) ? "pushpull" : "opendrain", (module_nr % 3 == 0) ? "on" : "off");
+      break;
+    case 1:
+      printf("  INPUT{ name: \"IN_%lu\" pin: %s pull: %s active: %s enable: false }\n",
+             module_nr, pin, (module_nr % 3 == 0) ? "up" : "down", (module_nr % 2 == 0) ? "high" : "low");
+      break;
+    case 2:
+      printf("  PWM_OUTPUT{ name: \"PWM_%lu\" pin: %s frequency: %lu duty: %lu enable: false }\n",
+             module_nr, pin, 50 + (module_nr % 20000), module_nr % 1001);
+      break;
+    default:
+      printf("  UART{ name: \"UART_%lu\" tx_pin: %s rx_pin: %s baudrate: %s enable: false }\n",
+             module_nr, pin, pin_rx, (module_nr % 2 == 0) ? "115200" : "9600");
+      break;
+  }
+}
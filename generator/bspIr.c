@@ -0,0 +1,365 @@
+#include "bspIr.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "logging.h"
+#include "generatorOptions.h"
+
+_Static_assert(sizeof(AUTOBSP_GENERATOR_VERSION) <= sizeof(((bsp_ir_header_t*)0)->generator_version),
+               "AUTOBSP_GENERATOR_VERSION does not fit into the .bspir header");
+
+static const char* bsp_ir_validate_module(const bsp_ir_module_t *record, const char *strings, uint32_t strings_size);
+static bsp_ir_pin_t bsp_ir_pin_from_ast(pin_t pin);
+static pin_t bsp_ir_pin_to_ast(bsp_ir_pin_t pin);
+
+
+/* -------------------------------------------- */
+/*                 Serialization                */
+/* -------------------------------------------- */
+
+/**
+ * @brief Serializes the bound AST into the .bspir format (see bspIr.h).
+ * 
+ * @param dsl_node Pointer to the DSL node (after ast_bind_backend_specific_params).
+ * @param source_hash Regeneration cache key of the DSL file the AST was built from (stored for downstream tools).
+ * @param output Emitter the file content is written into (cleared first).
+ * 
+ * @note All modules are stored (also disabled ones, the AST graphs show them), in the current list order.
+ * @note Reserved bytes and padding are zero, so the same AST always gives the same bytes.
+ */
+void bsp_ir_serialize(const ast_dsl_node_t *dsl_node, uint64_t source_hash, emitter_t *output){
+  if(dsl_node == NULL)
+    log_error("bsp_ir_serialize", 0, "DSL node is NULL.");
+  if(output == NULL)
+    log_error("bsp_ir_serialize", 0, "Output emitter is NULL.");
+  
+  // Count the modules and the size of the string table first, the header holds both
+  uint64_t module_count = 0;
+  uint64_t strings_size = 0;
+  for(const ast_module_node_t *module = dsl_node->modules_root; module != NULL; module = module->next){
+    if(module->name == NULL)
+      log_error("bsp_ir_serialize", module->line_nr, "Module node without name can not be serialized.");
+    module_count++;
+    strings_size += strlen(module->name) + 1;
+  }
+  uint64_t strings_offset = sizeof(bsp_ir_header_t) + module_count * sizeof(bsp_ir_module_t);
+  if(strings_offset + strings_size > UINT32_MAX)
+    log_error("bsp_ir_serialize", 0, "AST with %llu modules is too large for the .bspir format.", (unsigned long long)module_count);
+  
+  bsp_ir_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, BSP_IR_MAGIC, sizeof(header.magic));
+  header.version        = BSP_IR_VERSION;
+  header.byte_order     = BSP_IR_BYTE_ORDER;
+  header.header_size    = sizeof(bsp_ir_header_t);
+  header.module_size    = sizeof(bsp_ir_module_t);
+  header.controller     = (uint32_t)dsl_node->controller;
+  header.module_count   = (uint32_t)module_count;
+  header.strings_offset = (uint32_t)strings_offset;
+  header.strings_size   = (uint32_t)strings_size;
+  header.source_hash    = source_hash;
+  memcpy(header.generator_version, AUTOBSP_GENERATOR_VERSION, sizeof(AUTOBSP_GENERATOR_VERSION));
+  
+  emitter_clear(output);
+  emitter_append_n(output, (const char*)&header, sizeof(header));
+  
+  // Module records (names are referenced by their offset in the string table)
+  uint32_t name_offset = 0;
+  for(const ast_module_node_t *module = dsl_node->modules_root; module != NULL; module = module->next){
+    bsp_ir_module_t record;
+    memset(&record, 0, sizeof(record));
+    record.node_id     = module->node_id;
+    record.line_nr     = module->line_nr;
+    record.name_offset = name_offset;
+    record.name_length = (uint32_t)strlen(module->name);
+    record.pin         = bsp_ir_pin_from_ast(module->pin);
+    record.kind        = (uint8_t)module->kind;
+    record.enable      = module->enable ? 1 : 0;
+    name_offset += record.name_length + 1;
+    
+    switch(module->kind){
+      case MODULE_OUTPUT:     record.data.output.type         = (uint8_t)module->data.output.type;
+                              record.data.output.pull         = (uint8_t)module->data.output.pull;
+                              record.data.output.speed        = (uint8_t)module->data.output.speed;
+                              record.data.output.init         = (uint8_t)module->data.output.init;
+                              record.data.output.active_level = (uint8_t)module->data.output.active_level;
+                              break;
+      case MODULE_INPUT:      record.data.input.pull          = (uint8_t)module->data.input.pull;
+                              record.data.input.active_level  = (uint8_t)module->data.input.active_level;
+                              break;
+      case MODULE_PWM_OUTPUT: record.data.pwm.pull            = (uint8_t)module->data.pwm.pull;
+                              record.data.pwm.speed           = (uint8_t)module->data.pwm.speed;
+                              record.data.pwm.active_level    = (uint8_t)module->data.pwm.active_level;
+                              record.data.pwm.frequency       = module->data.pwm.frequency;
+                              record.data.pwm.duty_cycle      = module->data.pwm.duty_cycle;
+                              record.data.pwm.tim_number      = module->data.pwm.tim_number;
+                              record.data.pwm.tim_channel     = module->data.pwm.tim_channel;
+                              record.data.pwm.gpio_af         = module->data.pwm.gpio_af;
+                              record.data.pwm.prescaler       = module->data.pwm.prescaler;
+                              record.data.pwm.period          = module->data.pwm.period;
+                              break;
+      case MODULE_UART:       record.data.uart.rx_pin         = bsp_ir_pin_from_ast(module->data.uart.rx_pin);
+                              record.data.uart.baudrate       = module->data.uart.baudrate;
+                              record.data.uart.databits       = module->data.uart.databits;
+                              record.data.uart.stopbits       = module->data.uart.stopbits;
+                              record.data.uart.parity         = (uint8_t)module->data.uart.parity;
+                              record.data.uart.usart_number   = module->data.uart.usart_number;
+                              record.data.uart.is_uart        = module->data.uart.is_uart ? 1 : 0;
+                              record.data.uart.gpio_af        = module->data.uart.gpio_af;
+                              record.data.uart.oversampling   = module->data.uart.oversampling;
+                              break;
+      default:
+        log_error("bsp_ir_serialize", module->line_nr, "Unknown module kind for module '%s'.", module->name);
+    }
+    emitter_append_n(output, (const char*)&record, sizeof(record));
+  }
+  
+  // String table (names with their null character)
+  for(const ast_module_node_t *module = dsl_node->modules_root; module != NULL; module = module->next)
+    emitter_append_n(output, module->name, strlen(module->name) + 1);
+}
+
+/**
+ * @brief Serializes the bound AST and writes it to BSP_IR_FILE_NAME in the output directory.
+ * 
+ * @param output_path Path to the directory the file is written to.
+ * @param dsl_node Pointer to the DSL node (after ast_bind_backend_specific_params).
+ * @param source_hash Regeneration cache key of the DSL file the AST was built from.
+ * @param output Emitter the file is serialized into (cleared first, can be reused afterwards).
+ * 
+ * @note A file that already has the serialized content is not rewritten (keeps its modification time).
+ */
+void bsp_ir_write(const char *output_path, const ast_dsl_node_t *dsl_node, uint64_t source_hash, emitter_t *output){
+  if(output_path == NULL)
+    log_error("bsp_ir_write", 0, "Output path is NULL.");
+  
+  bsp_ir_serialize(dsl_node, source_hash, output);
+  
+  char ir_path[256];
+  snprintf(ir_path, sizeof(ir_path), "%s/%s", output_path, BSP_IR_FILE_NAME);
+  emitter_write_result_t result = emitter_write_file(output, ir_path);
+  if(result == EMITTER_WRITE_FAILED)
+    log_error("bsp_ir_write", 0, "Failed to write IR file: '%s' (%s)", ir_path, strerror(errno));
+  if(result == EMITTER_WRITE_UNCHANGED)
+    log_info("bsp_ir_write", LOG_OTHER, 0, "IR file '%s' is unchanged, not rewritten", ir_path);
+}
+
+
+/* -------------------------------------------- */
+/*                    Loading                   */
+/* -------------------------------------------- */
+
+/**
+ * @brief Checks if a file content starts with the .bspir magic number (and is no DSL text).
+ * 
+ * @param data Content of the file.
+ * @param length Length of the content in bytes.
+ * @return true if the content is a .bspir file (not yet validated), false otherwise.
+ */
+bool bsp_ir_is_ir(const char *data, size_t length){
+  return data != NULL && length >= sizeof(((bsp_ir_header_t*)0)->magic) &&
+         memcmp(data, BSP_IR_MAGIC, sizeof(((bsp_ir_header_t*)0)->magic)) == 0;
+}
+
+/**
+ * @brief Validates a .bspir file, so its header, module records and names can be read in place.
+ * 
+ * @param data Content of the file (aligned like the memory of a mapping or malloc).
+ * @param length Length of the content in bytes.
+ * @return NULL if the file is valid, otherwise a description of the first problem found.
+ * 
+ * @note Checks the format (magic number, version, byte order, record sizes, bounds of all offsets, terminated names)
+ *       and the ranges of all enumeration values, not the configuration itself (it was checked before it was written).
+ */
+const char* bsp_ir_validate(const char *data, size_t length){
+  if(data == NULL || length < sizeof(bsp_ir_header_t))
+    return "File is smaller than the .bspir header";
+  if(((uintptr_t)data % _Alignof(bsp_ir_header_t)) != 0)
+    return "Content is not aligned for reading in place";
+  
+  const bsp_ir_header_t *header = (const bsp_ir_header_t*)data;
+  if(!bsp_ir_is_ir(data, length))
+    return "Magic number of the .bspir format not found";
+  if(header->byte_order != BSP_IR_BYTE_ORDER)
+    return "File was written on a machine with another byte order";
+  if(header->version != BSP_IR_VERSION)
+    return "Unsupported version of the .bspir format";
+  if(header->header_size != sizeof(bsp_ir_header_t) || header->module_size != sizeof(bsp_ir_module_t))
+    return "Unexpected header or module record size";
+  if(memchr(header->generator_version, '\0', sizeof(header->generator_version)) == NULL)
+    return "Generator version is not terminated";
+  if(header->controller > ESP32)
+    return "Unknown controller";
+  
+  // Module records and string table must lie inside the file, one after the other
+  uint64_t modules_end = (uint64_t)header->header_size + (uint64_t)header->module_count * header->module_size;
+  if(modules_end > header->strings_offset || (uint64_t)header->strings_offset + header->strings_size > length)
+    return "Module records or string table exceed the file";
+  
+  const bsp_ir_module_t *records = (const bsp_ir_module_t*)(data + header->header_size);
+  const char *strings = data + header->strings_offset;
+  for(uint32_t i = 0; i < header->module_count; i++){
+    const char *problem = bsp_ir_validate_module(&records[i], strings, header->strings_size);
+    if(problem != NULL)
+      return problem;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Builds the AST of a .bspir file, ready for printing and code generation (without parsing, checking or binding).
+ * 
+ * @param arena Arena of the run the DSL node, module nodes and names are allocated from.
+ * @param data Content of the file (e.g. memory-mapped by input_buffer_load).
+ * @param length Length of the content in bytes.
+ * @return Pointer to the DSL node with all modules in the stored order (not indexed yet, see ast_index_enabled_modules).
+ * 
+ * @note Logs an error and exits if the file is not valid (see bsp_ir_validate).
+ * @note The AST does not reference the file content, so it can be released afterwards.
+ */
+ast_dsl_node_t* bsp_ir_load(arena_t *arena, const char *data, size_t length){
+  const char *problem = bsp_ir_validate(data, length);
+  if(problem != NULL)
+    log_error("bsp_ir_load", 0, "Invalid .bspir file: %s.", problem);
+  
+  const bsp_ir_header_t *header = (const bsp_ir_header_t*)data;
+  const bsp_ir_module_t *records = (const bsp_ir_module_t*)(data + header->header_size);
+  const char *strings = data + header->strings_offset;
+  
+  ast_dsl_node_t *dsl_node = (ast_dsl_node_t*)arena_alloc(arena, sizeof(ast_dsl_node_t));
+  dsl_node->controller = (controller_t)header->controller;
+  dsl_node->modules_root = NULL;
+  dsl_node->modules_tail = NULL;
+  dsl_node->modules_indexed = false;
+  
+  // All module nodes in one array, linked in the stored order
+  ast_module_node_t *modules = NULL;
+  if(header->module_count > 0)
+    modules = (ast_module_node_t*)arena_alloc(arena, (size_t)header->module_count * sizeof(ast_module_node_t));
+  for(uint32_t i = 0; i < header->module_count; i++){
+    const bsp_ir_module_t *record = &records[i];
+    ast_module_node_t *module = &modules[i];
+    module->node_id = record->node_id;
+    module->line_nr = record->line_nr;
+    module->name    = arena_strndup(arena, strings + record->name_offset, record->name_length);
+    module->pin     = bsp_ir_pin_to_ast(record->pin);
+    module->enable  = (record->enable != 0);
+    module->kind    = (ast_module_kind_t)record->kind;
+    
+    switch(module->kind){
+      case MODULE_OUTPUT:     module->data.output.type         = (gpio_type_t)record->data.output.type;
+                              module->data.output.pull         = (gpio_pull_t)record->data.output.pull;
+                              module->data.output.speed        = (gpio_speed_t)record->data.output.speed;
+                              module->data.output.init         = (gpio_init_t)record->data.output.init;
+                              module->data.output.active_level = (level_t)record->data.output.active_level;
+                              break;
+      case MODULE_INPUT:      module->data.input.pull          = (gpio_pull_t)record->data.input.pull;
+                              module->data.input.active_level  = (level_t)record->data.input.active_level;
+                              break;
+      case MODULE_PWM_OUTPUT: module->data.pwm.pull            = (gpio_pull_t)record->data.pwm.pull;
+                              module->data.pwm.speed           = (gpio_speed_t)record->data.pwm.speed;
+                              module->data.pwm.active_level    = (level_t)record->data.pwm.active_level;
+                              module->data.pwm.frequency       = record->data.pwm.frequency;
+                              module->data.pwm.duty_cycle      = record->data.pwm.duty_cycle;
+                              module->data.pwm.tim_number      = record->data.pwm.tim_number;
+                              module->data.pwm.tim_channel     = record->data.pwm.tim_channel;
+                              module->data.pwm.gpio_af         = record->data.pwm.gpio_af;
+                              module->data.pwm.prescaler       = record->data.pwm.prescaler;
+                              module->data.pwm.period          = record->data.pwm.period;
+                              break;
+      case MODULE_UART:       module->data.uart.rx_pin         = bsp_ir_pin_to_ast(record->data.uart.rx_pin);
+                              module->data.uart.baudrate       = record->data.uart.baudrate;
+                              module->data.uart.databits       = record->data.uart.databits;
+                              module->data.uart.stopbits       = record->data.uart.stopbits;
+                              module->data.uart.parity         = (uart_parity_t)record->data.uart.parity;
+                              module->data.uart.usart_number   = record->data.uart.usart_number;
+                              module->data.uart.is_uart        = (record->data.uart.is_uart != 0);
+                              module->data.uart.gpio_af        = record->data.uart.gpio_af;
+                              module->data.uart.oversampling   = record->data.uart.oversampling;
+                              break;
+    }
+    
+    module->next = NULL;
+    if(dsl_node->modules_root == NULL)
+      dsl_node->modules_root = module;
+    else
+      dsl_node->modules_tail->next = module;
+    dsl_node->modules_tail = module;
+  }
+  
+  return dsl_node;
+}
+
+
+/* -------------------------------------------- */
+/*               Helper functions               */
+/* -------------------------------------------- */
+
+/**
+ * @brief Validates one module record of a .bspir file.
+ * 
+ * @param record Pointer to the module record.
+ * @param strings String table of the file.
+ * @param strings_size Size of the string table in bytes.
+ * @return NULL if the record is valid, otherwise a description of the problem.
+ */
+static const char* bsp_ir_validate_module(const bsp_ir_module_t *record, const char *strings, uint32_t strings_size){
+  // The name must lie inside the string table and end with (and only contain) its null character
+  if((uint64_t)record->name_offset + record->name_length >= strings_size ||
+     strings[record->name_offset + record->name_length] != '\0' ||
+     memchr(strings + record->name_offset, '\0', record->name_length) != NULL)
+    return "Module name exceeds the string table";
+  
+  if(record->pin.identifier > PXn || record->enable > 1)
+    return "Invalid pin or enable value of a module";
+  
+  switch(record->kind){
+    case MODULE_OUTPUT:
+      if(record->data.output.type > GPIO_TYPE_OPENDRAIN || record->data.output.pull > GPIO_PULL_NONE ||
+         record->data.output.speed > GPIO_SPEED_VERY_HIGH || record->data.output.init > GPIO_INIT_NONE ||
+         record->data.output.active_level > HIGH)
+        return "Invalid parameter value of an output module";
+      return NULL;
+    case MODULE_INPUT:
+      if(record->data.input.pull > GPIO_PULL_NONE || record->data.input.active_level > HIGH)
+        return "Invalid parameter value of an input module";
+      return NULL;
+    case MODULE_PWM_OUTPUT:
+      if(record->data.pwm.pull > GPIO_PULL_NONE || record->data.pwm.speed > GPIO_SPEED_VERY_HIGH ||
+         record->data.pwm.active_level > HIGH)
+        return "Invalid parameter value of a PWM module";
+      return NULL;
+    case MODULE_UART:
+      if(record->data.uart.rx_pin.identifier > PXn || record->data.uart.parity > UART_PARITY_ODD ||
+         record->data.uart.is_uart > 1 || (record->data.uart.oversampling != 16 && record->data.uart.oversampling != 8))
+        return "Invalid parameter value of a UART module";
+      return NULL;
+    default:
+      return "Unknown module kind";
+  }
+}
+
+/**
+ * @brief Converts a pin of the AST into its .bspir representation.
+ */
+static bsp_ir_pin_t bsp_ir_pin_from_ast(pin_t pin){
+  bsp_ir_pin_t ir_pin;
+  memset(&ir_pin, 0, sizeof(ir_pin));
+  ir_pin.pin_number = pin.pin_number;
+  ir_pin.identifier = (uint8_t)pin.identifier;
+  ir_pin.port       = pin.port;
+  return ir_pin;
+}
+
+/**
+ * @brief Converts a pin of a .bspir file into its AST representation.
+ */
+static pin_t bsp_ir_pin_to_ast(bsp_ir_pin_t ir_pin){
+  pin_t pin;
+  pin.identifier = (pin_identifier_t)ir_pin.identifier;
+  pin.port       = ir_pin.port;
+  pin.pin_number = ir_pin.pin_number;
+  return pin;
+}
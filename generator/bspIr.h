@@ -0,0 +1,121 @@
+#ifndef __BSP_IR_H__
+#define __BSP_IR_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "astEnums.h"
+#include "arena.h"
+#include "emitter.h"
+
+/*
+ * Layout of a .bspir file (bound AST of one configuration, written after ast_bind_backend_specific_params):
+ * 
+ *   bsp_ir_header_t                   at offset 0
+ *   bsp_ir_module_t[module_count]     at offset header_size, all modules in list order (sorted by pin)
+ *   string table                      at offset strings_offset, null-terminated module names
+ * 
+ * All values are stored in the byte order of the writing machine (see byte_order) with the sizes and alignment below,
+ * so a memory-mapped file can be read in place after bsp_ir_validate() accepted it.
+ */
+
+#define BSP_IR_FILE_NAME    "generated_bsp.bspir"
+#define BSP_IR_MAGIC        "BSPIR\0\0"  // 8 bytes with the terminator, never found at the start of a DSL file
+#define BSP_IR_VERSION      2            // Incremented on every change of the layout
+#define BSP_IR_BYTE_ORDER   0x0102       // Read as 0x0201 on a machine with the other byte order
+
+/**
+ * @brief Pin in a .bspir file (see pin_t).
+ */
+typedef struct{
+  uint32_t pin_number;
+  uint8_t  identifier;   // pin_identifier_t
+  char     port;
+  uint8_t  reserved[2];
+} bsp_ir_pin_t;
+
+/**
+ * @brief Header at the start of a .bspir file.
+ * 
+ * Consists of the magic number, the format version, the byte order and record sizes, the controller,
+ * the location of the module records and the string table, and the origin of the file.
+ */
+typedef struct{
+  char     magic[8];                 // BSP_IR_MAGIC
+  uint16_t version;                  // BSP_IR_VERSION
+  uint16_t byte_order;               // BSP_IR_BYTE_ORDER
+  uint16_t header_size;              // sizeof(bsp_ir_header_t), offset of the first module record
+  uint16_t module_size;              // sizeof(bsp_ir_module_t)
+  uint32_t controller;               // controller_t
+  uint32_t module_count;             // Number of module records
+  uint32_t strings_offset;           // Offset of the string table from the start of the file
+  uint32_t strings_size;             // Size of the string table in bytes
+  uint64_t source_hash;              // Regeneration cache key of the DSL file the AST was built from (see regenCache.c)
+  char     generator_version[16];    // AUTOBSP_GENERATOR_VERSION of the writing generator (null-terminated)
+  uint8_t  reserved[8];
+} bsp_ir_header_t;
+
+/**
+ * @brief Module record in a .bspir file (see ast_module_node_t), including the parameters selected by the generator.
+ */
+typedef struct{
+  uint32_t     node_id;
+  int32_t      line_nr;
+  uint32_t     name_offset;   // Offset of the name in the string table
+  uint32_t     name_length;   // Length of the name without the null character
+  bsp_ir_pin_t pin;           // Pin (TX pin of UART modules)
+  uint8_t      kind;          // ast_module_kind_t
+  uint8_t      enable;
+  uint8_t      reserved[2];
+  union{
+    struct{
+      uint8_t  type;          // gpio_type_t
+      uint8_t  pull;          // gpio_pull_t
+      uint8_t  speed;         // gpio_speed_t
+      uint8_t  init;          // gpio_init_t
+      uint8_t  active_level;  // level_t
+    } output;
+    struct{
+      uint8_t  pull;          // gpio_pull_t
+      uint8_t  active_level;  // level_t
+    } input;
+    struct{
+      uint8_t  pull;          // gpio_pull_t
+      uint8_t  speed;         // gpio_speed_t
+      uint8_t  active_level;  // level_t
+      uint8_t  tim_number;    // Selected by generator
+      uint8_t  tim_channel;   // Selected by generator
+      uint8_t  gpio_af;       // Selected by generator
+      uint16_t prescaler;     // Selected by generator
+      uint32_t frequency;
+      uint32_t duty_cycle;
+      uint32_t period;        // Selected by generator
+    } pwm;
+    struct{
+      bsp_ir_pin_t rx_pin;
+      uint32_t baudrate;
+      float    stopbits;
+      uint8_t  databits;
+      uint8_t  parity;        // uart_parity_t
+      uint8_t  usart_number;  // Selected by generator
+      uint8_t  is_uart;       // Selected by generator
+      uint8_t  gpio_af;       // Selected by generator
+      uint8_t  oversampling;  // Selected by generator (16 or 8)
+      uint8_t  reserved[2];
+    } uart;
+  } data;
+} bsp_ir_module_t;
+
+_Static_assert(sizeof(bsp_ir_pin_t) == 8, "bsp_ir_pin_t is part of the .bspir layout");
+_Static_assert(sizeof(bsp_ir_header_t) == 64, "bsp_ir_header_t is part of the .bspir layout");
+_Static_assert(sizeof(bsp_ir_module_t) == 52, "bsp_ir_module_t is part of the .bspir layout");
+
+bool bsp_ir_is_ir(const char *data, size_t length);
+const char* bsp_ir_validate(const char *data, size_t length);
+
+void bsp_ir_serialize(const ast_dsl_node_t *dsl_node, uint64_t source_hash, emitter_t *output);
+void bsp_ir_write(const char *output_path, const ast_dsl_node_t *dsl_node, uint64_t source_hash, emitter_t *output);
+ast_dsl_node_t* bsp_ir_load(arena_t *arena, const char *data, size_t length);
+
+#endif //__BSP_IR_H__
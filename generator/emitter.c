@@ -0,0 +1,355 @@
+#include "emitter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "logging.h"
+
+#define EMITTER_INITIAL_CAPACITY (16 * 1024)
+#define EMITTER_COMPARE_CHUNK    (16 * 1024)  // Bytes read at once when comparing with an existing file
+#define EMITTER_TEMP_ATTEMPTS    100          // Number of temporary file names tried before giving up
+#define EMITTER_TEMP_PATH_SIZE   4200         // Resolved target path (PATH_MAX) and the temporary suffix
+
+static void emitter_reserve(emitter_t *emitter, size_t additional);
+static bool file_has_content(const char *file_path, const char *data, size_t length);
+static bool write_all(int fd, const char *data, size_t length);
+static emitter_write_result_t write_file_replace(const char *file_path, const char *data, size_t length);
+static emitter_write_result_t write_file_in_place(const char *file_path, const char *data, size_t length);
+
+
+/* -------------------------------------------- */
+/*          Initialization and release          */
+/* -------------------------------------------- */
+
+/**
+ * @brief Initializes an empty emitter.
+ * 
+ * @param emitter Pointer to the emitter.
+ * 
+ * @note No memory is allocated until the first text is appended.
+ */
+void emitter_init(emitter_t *emitter){
+  if(emitter == NULL)
+    log_error("emitter_init", 0, "Emitter is NULL.");
+  
+  emitter->data         = NULL;
+  emitter->length       = 0;
+  emitter->capacity     = 0;
+  emitter->total_length = 0;
+}
+
+/**
+ * @brief Removes the text of the emitter but keeps its memory for reuse.
+ * 
+ * @param emitter Pointer to the emitter.
+ */
+void emitter_clear(emitter_t *emitter){
+  if(emitter == NULL)
+    log_error("emitter_clear", 0, "Emitter is NULL.");
+  
+  emitter->length = 0;
+  if(emitter->data != NULL)
+    emitter->data[0] = '\0';
+}
+
+/**
+ * @brief Frees the memory of the emitter.
+ * 
+ * @param emitter Pointer to the emitter.
+ * 
+ * @note The emitter is empty afterwards and can be used again.
+ */
+void emitter_free(emitter_t *emitter){
+  if(emitter == NULL)
+    return;
+  
+  free(emitter->data);
+  emitter->data         = NULL;
+  emitter->length       = 0;
+  emitter->capacity     = 0;
+  emitter->total_length = 0;
+}
+
+
+/* -------------------------------------------- */
+/*                Append functions              */
+/* -------------------------------------------- */
+
+/**
+ * @brief Appends a string to the emitter.
+ * 
+ * @param emitter Pointer to the emitter.
+ * @param text Null-terminated string to append.
+ */
+void emitter_append(emitter_t *emitter, const char *text){
+  if(text == NULL)
+    log_error("emitter_append", 0, "Text is NULL.");
+  
+  emitter_append_n(emitter, text, strlen(text));
+}
+
+/**
+ * @brief Appends the first length characters of a string to the emitter.
+ * 
+ * @param emitter Pointer to the emitter.
+ * @param text String to append (does not need to be null-terminated).
+ * @param length Number of characters to append.
+ */
+void emitter_append_n(emitter_t *emitter, const char *text, size_t length){
+  if(emitter == NULL)
+    log_error("emitter_append_n", 0, "Emitter is NULL.");
+  if(text == NULL)
+    log_error("emitter_append_n", 0, "Text is NULL.");
+  
+  emitter_reserve(emitter, length);
+  memcpy(emitter->data + emitter->length, text, length);
+  emitter->length += length;
+  emitter->total_length += length;
+  emitter->data[emitter->length] = '\0';
+}
+
+/**
+ * @brief Appends formatted text to the emitter (same format as printf).
+ * 
+ * @param emitter Pointer to the emitter.
+ * @param format Format string.
+ * @param ... Additional arguments for the format string.
+ */
+void emitter_printf(emitter_t *emitter, const char *format, ...){
+  va_list args;
+  va_start(args, format);
+  emitter_vprintf(emitter, format, args);
+  va_end(args);
+}
+
+/**
+ * @brief Appends formatted text to the emitter (same format as vprintf).
+ * 
+ * @param emitter Pointer to the emitter.
+ * @param format Format string.
+ * @param args va_list of additional arguments for the format string (not consumed, can be used again by the caller after va_end).
+ */
+void emitter_vprintf(emitter_t *emitter, const char *format, va_list args){
+  if(emitter == NULL)
+    log_error("emitter_vprintf", 0, "Emitter is NULL.");
+  if(format == NULL)
+    log_error("emitter_vprintf", 0, "Format string is NULL.");
+  
+  // Try to format into the free space first, grow and format again only if it was too small
+  va_list args_copy;
+  va_copy(args_copy, args);
+  size_t available = emitter->capacity - emitter->length;
+  int needed = vsnprintf(emitter->data == NULL ? NULL : emitter->data + emitter->length, available, format, args_copy);
+  va_end(args_copy);
+  
+  if(needed < 0)
+    log_error("emitter_vprintf", 0, "Could not format text '%s'.", format);
+  
+  if((size_t)needed >= available){
+    emitter_reserve(emitter, (size_t)needed);
+    va_copy(args_copy, args);
+    vsnprintf(emitter->data + emitter->length, (size_t)needed + 1, format, args_copy);
+    va_end(args_copy);
+  }
+  emitter->length += (size_t)needed;
+  emitter->total_length += (size_t)needed;
+}
+
+
+/* -------------------------------------------- */
+/*                    Output                    */
+/* -------------------------------------------- */
+
+/**
+ * @brief Writes the text of the emitter into a file, but only if the file does not have the same content already.
+ * 
+ * The text is written with one write into a temporary file in the same directory, which is then renamed to the
+ * file path. So the file is replaced atomically and an unchanged file keeps its modification time
+ * (no needless rebuilds of projects including the generated files).
+ * 
+ * The replaced file keeps its permissions (e.g. the executable bit of a script). If the file path is a symbolic link,
+ * the file it points to is replaced and the link is kept; a link to a missing file is written through in place.
+ * 
+ * @param emitter Pointer to the emitter.
+ * @param file_path Path of the file (is created or replaced).
+ * @return EMITTER_WRITE_UNCHANGED if the file already had the content, EMITTER_WRITE_WRITTEN if it was written,
+ *         EMITTER_WRITE_FAILED if it could not be written (errno is set).
+ */
+emitter_write_result_t emitter_write_file(const emitter_t *emitter, const char *file_path){
+  if(emitter == NULL)
+    log_error("emitter_write_file", 0, "Emitter is NULL.");
+  if(file_path == NULL)
+    log_error("emitter_write_file", 0, "File path is NULL.");
+  
+  const char *data = (emitter->data == NULL) ? "" : emitter->data;
+  if(file_has_content(file_path, data, emitter->length))
+    return EMITTER_WRITE_UNCHANGED;
+  
+  // Replace the file a symbolic link points to, not the link itself
+  struct stat link_stat;
+  if(lstat(file_path, &link_stat) == 0 && S_ISLNK(link_stat.st_mode)){
+    char *resolved_path = realpath(file_path, NULL);
+    if(resolved_path == NULL)
+      return write_file_in_place(file_path, data, emitter->length);
+    emitter_write_result_t result = write_file_replace(resolved_path, data, emitter->length);
+    free(resolved_path);
+    return result;
+  }
+  return write_file_replace(file_path, data, emitter->length);
+}
+
+/**
+ * @brief Replaces a file atomically by a temporary file with the given content (see emitter_write_file).
+ * 
+ * @param file_path Path of the file (no symbolic link, is created or replaced).
+ * @param data Content of the file.
+ * @param length Length of the content.
+ * @return EMITTER_WRITE_WRITTEN if the file was written, EMITTER_WRITE_FAILED otherwise (errno is set).
+ * 
+ * @note The temporary file gets the permissions of the replaced file, or 0666 reduced by the umask for new files.
+ */
+static emitter_write_result_t write_file_replace(const char *file_path, const char *data, size_t length){
+  struct stat target_stat;
+  bool target_exists = (stat(file_path, &target_stat) == 0);
+  
+  // Create a new temporary file next to the target (rename is only atomic within one file system)
+  char temp_path[EMITTER_TEMP_PATH_SIZE];
+  int fd = -1;
+  for(unsigned int attempt = 0; attempt < EMITTER_TEMP_ATTEMPTS && fd < 0; attempt++){
+    int path_length = snprintf(temp_path, sizeof(temp_path), "%s.tmp%ld_%u", file_path, (long)getpid(), attempt);
+    if(path_length < 0 || (size_t)path_length >= sizeof(temp_path)){
+      errno = ENAMETOOLONG;
+      return EMITTER_WRITE_FAILED;
+    }
+    fd = open(temp_path, O_WRONLY | O_CREAT | O_EXCL, 0666); // Permissions like fopen (reduced by umask)
+    if(fd < 0 && errno != EEXIST)
+      return EMITTER_WRITE_FAILED;
+  }
+  if(fd < 0)
+    return EMITTER_WRITE_FAILED;
+  
+  bool written = true;
+  if(target_exists && fchmod(fd, target_stat.st_mode & 07777) != 0)
+    written = false;
+  if(written)
+    written = write_all(fd, data, length);
+  if(close(fd) != 0)
+    written = false;
+  
+  if(!written || rename(temp_path, file_path) != 0){
+    int error = errno;
+    unlink(temp_path);
+    errno = error;
+    return EMITTER_WRITE_FAILED;
+  }
+  return EMITTER_WRITE_WRITTEN;
+}
+
+/**
+ * @brief Overwrites a file in place (not atomically) with the given content.
+ * 
+ * @param file_path Path of the file (is created or truncated, symbolic links are followed).
+ * @param data Content of the file.
+ * @param length Length of the content.
+ * @return EMITTER_WRITE_WRITTEN if the file was written, EMITTER_WRITE_FAILED otherwise (errno is set).
+ */
+static emitter_write_result_t write_file_in_place(const char *file_path, const char *data, size_t length){
+  int fd = open(file_path, O_WRONLY | O_CREAT | O_TRUNC, 0666); // Permissions like fopen (reduced by umask)
+  if(fd < 0)
+    return EMITTER_WRITE_FAILED;
+  
+  bool written = write_all(fd, data, length);
+  if(close(fd) != 0)
+    written = false;
+  return written ? EMITTER_WRITE_WRITTEN : EMITTER_WRITE_FAILED;
+}
+
+/**
+ * @brief Checks if a file exists and has exactly the given content.
+ * 
+ * @param file_path Path of the file.
+ * @param data Expected content.
+ * @param length Length of the expected content.
+ * @return true if the file has the content; false if it differs or cannot be read.
+ * 
+ * @note Compares the size first and reads the file only if the size matches.
+ */
+static bool file_has_content(const char *file_path, const char *data, size_t length){
+  struct stat file_stat;
+  if(stat(file_path, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || (size_t)file_stat.st_size != length)
+    return false;
+  
+  FILE *file = fopen(file_path, "rb");
+  if(file == NULL)
+    return false;
+  
+  char chunk[EMITTER_COMPARE_CHUNK];
+  size_t compared = 0;
+  bool same = true;
+  while(same && compared < length){
+    size_t chunk_length = length - compared;
+    if(chunk_length > sizeof(chunk))
+      chunk_length = sizeof(chunk);
+    
+    if(fread(chunk, 1, chunk_length, file) != chunk_length || memcmp(chunk, data + compared, chunk_length) != 0)
+      same = false;
+    compared += chunk_length;
+  }
+  
+  // The file must not have grown since stat
+  if(same && fgetc(file) != EOF)
+    same = false;
+  
+  fclose(file);
+  return same;
+}
+
+/**
+ * @brief Writes all bytes into a file descriptor (continues after partial writes and interrupts).
+ * 
+ * @return true if all bytes were written; false otherwise.
+ */
+static bool write_all(int fd, const char *data, size_t length){
+  while(length > 0){
+    ssize_t written = write(fd, data, length);
+    if(written < 0){
+      if(errno == EINTR)
+        continue;
+      return false;
+    }
+    data   += written;
+    length -= (size_t)written;
+  }
+  return true;
+}
+
+/**
+ * @brief Makes sure the emitter has space for additional characters (plus the null terminator).
+ * 
+ * @param emitter Pointer to the emitter.
+ * @param additional Number of characters that will be appended.
+ * 
+ * @note Grows the capacity at least by factor two, so appending is amortized constant time.
+ */
+static void emitter_reserve(emitter_t *emitter, size_t additional){
+  size_t required = emitter->length + additional + 1;
+  if(required <= emitter->capacity)
+    return;
+  
+  size_t capacity = (emitter->capacity == 0) ? EMITTER_INITIAL_CAPACITY : emitter->capacity;
+  while(capacity < required)
+    capacity *= 2;
+  
+  char *data = (char*)realloc(emitter->data, capacity);
+  if(data == NULL)
+    log_error("emitter_reserve", 0, "Could not allocate %zu bytes for emitter.", capacity);
+  
+  emitter->data     = data;
+  emitter->capacity = capacity;
+}
@@ -0,0 +1,46 @@
+#ifndef __EMITTER_H__
+#define __EMITTER_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+/**
+ * @brief Growable in-memory text buffer the code generators write into.
+ * 
+ * Consists of the (always null-terminated) text, its length, the allocated capacity,
+ * and the number of characters appended since initialization (for statistics).
+ * 
+ * @note The buffer can be reused for several files (emitter_clear keeps the memory) and
+ *       is written to disk with one write (emitter_write_file, only if the content changed) or used directly in memory.
+ */
+typedef struct{
+  char   *data;
+  size_t  length;
+  size_t  capacity;
+  size_t  total_length;  // All characters appended since emitter_init (not reset by emitter_clear)
+} emitter_t;
+
+/**
+ * @brief Result of writing an emitter into a file.
+ * 
+ * Values: EMITTER_WRITE_FAILED, EMITTER_WRITE_UNCHANGED (file already had the same content), EMITTER_WRITE_WRITTEN
+ */
+typedef enum{
+  EMITTER_WRITE_FAILED,
+  EMITTER_WRITE_UNCHANGED,
+  EMITTER_WRITE_WRITTEN
+} emitter_write_result_t;
+
+void emitter_init(emitter_t *emitter);
+void emitter_clear(emitter_t *emitter);
+void emitter_free(emitter_t *emitter);
+
+void emitter_append(emitter_t *emitter, const char *text);
+void emitter_append_n(emitter_t *emitter, const char *text, size_t length);
+void emitter_printf(emitter_t *emitter, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void emitter_vprintf(emitter_t *emitter, const char *format, va_list args) __attribute__((format(printf, 2, 0)));
+
+emitter_write_result_t emitter_write_file(const emitter_t *emitter, const char *file_path);
+
+#endif //__EMITTER_H__
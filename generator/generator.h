@@ -0,0 +1,11 @@
+#ifndef __GENERATOR_H__
+#define __GENERATOR_H__
+
+#include "generatorOptions.h"
+#include "parserContext.h"
+
+// Complete generator runs from a DSL file to the output directory (implemented in parserDefinition.y)
+int generate_bsp(const char *code_file, const char *output_path, const generator_options_t *options);
+int generate_bsp_in_context(const char *code_file, const char *output_path, const generator_options_t *options, parser_context_t **reused_ctx);
+
+#endif //__GENERATOR_H__
@@ -0,0 +1,39 @@
+#ifndef __GENERATOR_OPTIONS_H__
+#define __GENERATOR_OPTIONS_H__
+
+#include <stdbool.h>
+
+// Artifacts of a run, selected with --emit= (bitwise OR)
+#define EMIT_HEADER     1  // generated_bsp.h
+#define EMIT_SOURCE     2  // generated_bsp.c
+#define EMIT_DOT        4  // ast_graph_complete.gv and ast_graph_enabled_only.gv
+#define EMIT_SCRIPTS    8  // createPNGfromDOT.sh and removePNGandDOT.sh
+#define EMIT_LOG       16  // AutoBSP.log
+#define EMIT_IR        32  // generated_bsp.bspir (bound AST, see bspIr.h)
+
+#define EMIT_ALL       (EMIT_HEADER | EMIT_SOURCE | EMIT_DOT | EMIT_SCRIPTS | EMIT_LOG | EMIT_IR)
+#define EMIT_DEFAULT   (EMIT_HEADER | EMIT_SOURCE | EMIT_DOT | EMIT_SCRIPTS | EMIT_LOG)
+
+// Version of the generator, part of the regeneration cache key (change it whenever the generated output changes)
+#define AUTOBSP_GENERATOR_VERSION "1.1.0"
+
+/**
+ * @brief Structure holding the command line options that apply to every generator run.
+ * 
+ * Consists of the flags selecting the report printed after each run (memory statistics, phase timings, JSON),
+ * the flag for bypassing the regeneration cache, the log categories active at runtime, the artifacts written,
+ * and whether the input is read instead of memory-mapped.
+ * 
+ * @note Shared read-only by all runs (e.g. all worker threads of the batch mode).
+ */
+typedef struct{
+  bool         print_stats;    // Print allocation count and peak RSS after each run (--stats)
+  bool         print_timings;  // Print the wall time of each phase and the counters after each run (--timings)
+  bool         print_json;     // Print statistics, timings and counters as one JSON object per run instead (--json)
+  bool         force;          // Regenerate even if the output directory is up to date with the input (--force)
+  unsigned int log_categories; // Log categories written to AutoBSP.log (--log=, see logging.h)
+  unsigned int emit;           // Artifacts written by each run (--emit=, see EMIT_* above)
+  bool         read_input;     // Read the DSL file instead of mapping it (watch mode: the file may be rewritten during a run)
+} generator_options_t;
+
+#endif //__GENERATOR_OPTIONS_H__
@@ -0,0 +1,190 @@
+#include "inputBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INPUT_BUFFER_READ_CAPACITY (16 * 1024) // Initial buffer size if the size of the input is unknown (e.g. a pipe)
+
+static bool map_file(input_buffer_t *buffer, int fd, size_t length);
+static bool read_file(input_buffer_t *buffer, int fd, size_t expected_length);
+
+
+/* -------------------------------------------- */
+/*               Load and release               */
+/* -------------------------------------------- */
+
+/**
+ * @brief Loads the complete content of a file into one buffer the scanner can work on in place.
+ * 
+ * The file is memory-mapped if allowed and the padding fits into its last page (the kernel fills the rest of the page
+ * with zeros), otherwise it is read with as few reads as possible into an allocated buffer.
+ * 
+ * @param buffer Pointer to the input buffer to fill.
+ * @param file_path Path of the file.
+ * @param allow_map false to always read the file, e.g. if it can be truncated while the buffer is used
+ *                  (accessing a mapped page behind the new end of the file raises SIGBUS).
+ * @return true if the file was loaded, false if it could not be opened or read (errno is set).
+ * 
+ * @note Does not log, because logging is not initialized before the input is loaded.
+ */
+bool input_buffer_load(input_buffer_t *buffer, const char *file_path, bool allow_map){
+  if(buffer == NULL || file_path == NULL){
+    errno = EINVAL;
+    return false;
+  }
+  buffer->data        = NULL;
+  buffer->length      = 0;
+  buffer->mapped_size = 0;
+  
+  int fd = open(file_path, O_RDONLY);
+  if(fd < 0)
+    return false;
+  
+  struct stat file_stat;
+  bool regular = (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode));
+  size_t length = regular ? (size_t)file_stat.st_size : 0;
+  
+  bool loaded = (allow_map && regular && map_file(buffer, fd, length)) || read_file(buffer, fd, length);
+  
+  int error = errno;
+  close(fd);
+  errno = error;
+  return loaded;
+}
+
+/**
+ * @brief Copies a DSL text from memory into a buffer the scanner can work on in place.
+ * 
+ * @param buffer Pointer to the input buffer to fill.
+ * @param text Content of the DSL file (does not need to be null-terminated).
+ * @param length Length of the content in bytes.
+ * @return true if the text was copied, false if memory could not be allocated (errno is set).
+ */
+bool input_buffer_copy(input_buffer_t *buffer, const char *text, size_t length){
+  if(buffer == NULL || (text == NULL && length > 0)){
+    errno = EINVAL;
+    return false;
+  }
+  buffer->length      = 0;
+  buffer->mapped_size = 0;
+  
+  buffer->data = (char*)malloc(length + INPUT_BUFFER_PADDING);
+  if(buffer->data == NULL)
+    return false;
+  
+  if(length > 0)
+    memcpy(buffer->data, text, length);
+  memset(buffer->data + length, 0, INPUT_BUFFER_PADDING);
+  buffer->length = length;
+  return true;
+}
+
+/**
+ * @brief Releases the buffer of a loaded file (unmaps or frees it).
+ * 
+ * @param buffer Pointer to the input buffer.
+ * 
+ * @note The buffer is empty afterwards, slices of it (e.g. names found by the scanner) must not be used anymore.
+ */
+void input_buffer_release(input_buffer_t *buffer){
+  if(buffer == NULL || buffer->data == NULL)
+    return;
+  
+  if(buffer->mapped_size > 0)
+    munmap(buffer->data, buffer->mapped_size);
+  else
+    free(buffer->data);
+  
+  buffer->data        = NULL;
+  buffer->length      = 0;
+  buffer->mapped_size = 0;
+}
+
+
+/* -------------------------------------------- */
+/*                Helper functions              */
+/* -------------------------------------------- */
+
+/**
+ * @brief Maps a regular file including its padding, if the padding fits into the last page of the file.
+ * 
+ * @param buffer Pointer to the input buffer to fill.
+ * @param fd Opened file.
+ * @param length Size of the file.
+ * @return true if the file was mapped, false if it has to be read instead.
+ * 
+ * @note Accessing bytes behind the last page of a file is not allowed, so empty files and files ending
+ *       less than INPUT_BUFFER_PADDING bytes before a page boundary are never mapped.
+ */
+static bool map_file(input_buffer_t *buffer, int fd, size_t length){
+  long page_size = sysconf(_SC_PAGESIZE);
+  if(length == 0 || page_size <= 0)
+    return false;
+  
+  size_t used_in_last_page = length % (size_t)page_size;
+  if(used_in_last_page == 0 || used_in_last_page > (size_t)page_size - INPUT_BUFFER_PADDING)
+    return false;
+  
+  // Private and writable: the scanner temporarily terminates tokens in place, the file itself is never changed
+  void *data = mmap(NULL, length + INPUT_BUFFER_PADDING, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if(data == MAP_FAILED)
+    return false;
+  
+  buffer->data        = (char*)data;
+  buffer->length      = length;
+  buffer->mapped_size = length + INPUT_BUFFER_PADDING;
+  return true;
+}
+
+/**
+ * @brief Reads a file until its end into an allocated buffer followed by the padding.
+ * 
+ * @param buffer Pointer to the input buffer to fill.
+ * @param fd Opened file (read from its current position).
+ * @param expected_length Expected size of the content (0 if unknown), the buffer grows if the content is longer.
+ * @return true if the file was read, false on a read or allocation error (errno is set).
+ */
+static bool read_file(input_buffer_t *buffer, int fd, size_t expected_length){
+  size_t capacity = (expected_length > 0 ? expected_length : INPUT_BUFFER_READ_CAPACITY) + INPUT_BUFFER_PADDING + 1;
+  char *data = (char*)malloc(capacity);
+  if(data == NULL)
+    return false;
+  
+  size_t length = 0;
+  for(;;){
+    // Keep space for the padding and one more byte, so the end of the file is detected by a read returning 0
+    if(capacity - length <= INPUT_BUFFER_PADDING){
+      char *grown = (char*)realloc(data, capacity * 2);
+      if(grown == NULL){
+        free(data);
+        return false;
+      }
+      data = grown;
+      capacity *= 2;
+    }
+    
+    ssize_t count = read(fd, data + length, capacity - length - INPUT_BUFFER_PADDING);
+    if(count < 0 && errno == EINTR)
+      continue;
+    if(count < 0){
+      int error = errno;
+      free(data);
+      errno = error;
+      return false;
+    }
+    if(count == 0)
+      break;
+    length += (size_t)count;
+  }
+  memset(data + length, 0, INPUT_BUFFER_PADDING);
+  
+  buffer->data        = data;
+  buffer->length      = length;
+  buffer->mapped_size = 0;
+  return true;
+}
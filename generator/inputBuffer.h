@@ -0,0 +1,27 @@
+#ifndef __INPUT_BUFFER_H__
+#define __INPUT_BUFFER_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define INPUT_BUFFER_PADDING 2 // Null characters after the content, required by the flex scanner (yy_scan_buffer)
+
+/**
+ * @brief Complete content of a DSL file (or a DSL text from memory) in one buffer, scanned in place by the flex scanner.
+ * 
+ * Consists of the content (followed by INPUT_BUFFER_PADDING null characters), its length,
+ * and the size of the mapping if the file is memory-mapped (0 if it was read into allocated memory).
+ * 
+ * @note The scanner temporarily writes into the buffer, so a mapping is private (changes are never written back to the file).
+ */
+typedef struct{
+  char   *data;
+  size_t  length;       // Length of the content without the padding
+  size_t  mapped_size;  // Size of the mapping, 0 = data was allocated with malloc
+} input_buffer_t;
+
+bool input_buffer_load(input_buffer_t *buffer, const char *file_path, bool allow_map);
+bool input_buffer_copy(input_buffer_t *buffer, const char *text, size_t length);
+void input_buffer_release(input_buffer_t *buffer);
+
+#endif //__INPUT_BUFFER_H__
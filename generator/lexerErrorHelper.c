@@ -6,59 +6,85 @@
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <pthread.h>
 
 #include "logging.h"
 
+#define KEYWORD_MAX_LENGTH 16 // Upper limit for the length of a keyword (size of the rows of the distance calculation)
+
+/**
+ * @brief Structure representing a keyword of the lexer with its length (computed at compile time).
+ */
+typedef struct{
+  const char   *text;
+  unsigned int  length;
+} lexer_keyword_t;
+
+#define KEYWORD(text) { text, sizeof(text) - 1 }
+
+static unsigned int levenshtein_distance_bounded(const char *word, size_t word_length, const lexer_keyword_t *keyword, unsigned int bound);
+static void build_keyword_index();
+
 // TODO: keep this list in sync with the keywords defined in the lexer (lexerDefinition.l)
 /**
  * @brief list of all keywords recognized by the lexer
  * @note used for finding closest matching keyword
  * @note must be kept in sync with the keywords defined in the lexer
  */
-static const char *lexer_keywords[] = {
-  "AutoBSP",
-  "controller",
-  "OUTPUT",
-  "INPUT",
-  "PWM_OUTPUT",
-  "UART",
-  "name",
-  "pin",
-  "type",
-  "pull",
-  "speed",
-  "init",
-  "active",
-  "enable",
-  "frequency",
-  "duty",
-  "tx_pin",
-  "rx_pin",
-  "baudrate",
-  "databits",
-  "stopbits",
-  "parity",
-  "true",
-  "false",
-  "high",
-  "low",
-  "STM32F446RE",
-  "ESP32",
-  "pushpull",
-  "opendrain",
-  "up",
-  "down",
-  "none",
-  "medium",
-  "very_high",
-  "on",
-  "off",
-  "even",
-  "odd"
+static const lexer_keyword_t lexer_keywords[] = {
+  KEYWORD("AutoBSP"),
+  KEYWORD("controller"),
+  KEYWORD("OUTPUT"),
+  KEYWORD("INPUT"),
+  KEYWORD("PWM_OUTPUT"),
+  KEYWORD("UART"),
+  KEYWORD("name"),
+  KEYWORD("pin"),
+  KEYWORD("type"),
+  KEYWORD("pull"),
+  KEYWORD("speed"),
+  KEYWORD("init"),
+  KEYWORD("active"),
+  KEYWORD("enable"),
+  KEYWORD("frequency"),
+  KEYWORD("duty"),
+  KEYWORD("tx_pin"),
+  KEYWORD("rx_pin"),
+  KEYWORD("baudrate"),
+  KEYWORD("databits"),
+  KEYWORD("stopbits"),
+  KEYWORD("parity"),
+  KEYWORD("true"),
+  KEYWORD("false"),
+  KEYWORD("high"),
+  KEYWORD("low"),
+  KEYWORD("STM32F446RE"),
+  KEYWORD("ESP32"),
+  KEYWORD("pushpull"),
+  KEYWORD("opendrain"),
+  KEYWORD("up"),
+  KEYWORD("down"),
+  KEYWORD("none"),
+  KEYWORD("medium"),
+  KEYWORD("very_high"),
+  KEYWORD("on"),
+  KEYWORD("off"),
+  KEYWORD("even"),
+  KEYWORD("odd")
 };
 
 // number of keywords in the lexer_keywords array
-static const int lexer_keywords_count = sizeof(lexer_keywords) / sizeof(lexer_keywords[0]);
+#define LEXER_KEYWORDS_COUNT ((int)(sizeof(lexer_keywords) / sizeof(lexer_keywords[0])))
+static const int lexer_keywords_count = LEXER_KEYWORDS_COUNT;
+
+/**
+ * @brief index of the keywords bucketed by length (built once, shared by all threads)
+ * @note the keywords of length l are keyword_by_length[keyword_length_start[l]] to keyword_by_length[keyword_length_start[l + 1] - 1]
+ */
+static int keyword_by_length[LEXER_KEYWORDS_COUNT];
+static int keyword_length_start[KEYWORD_MAX_LENGTH + 2];
+static pthread_once_t keyword_index_once = PTHREAD_ONCE_INIT;
+static const lexer_keyword_t *keyword_index_too_long = NULL; // keyword longer than KEYWORD_MAX_LENGTH (reported after pthread_once)
 
 /**
  * @brief returns the minimum of three integer values
@@ -76,47 +102,88 @@ int min_3_values(int a, int b, int c){
 }
 
 /**
- * @brief calulates the case insensitive levenshtein distance between two strings (s1 and s2)
+ * @brief calulates the case insensitive levenshtein distance between a word and a keyword, bounded by a maximum distance
  * 
- * @param s1 first string
- * @param s2 second string
- * @return unsigned int levenshtein distance
+ * @param word word to compare (can be arbitrarily long)
+ * @param word_length length of the word
+ * @param keyword keyword to compare against (at most KEYWORD_MAX_LENGTH characters)
+ * @param bound maximum distance of interest
+ * @return unsigned int levenshtein distance, or bound + 1 if the distance is larger than bound
  * 
  * @note source: https://en.wikibooks.org/wiki/Algorithm_Implementation/Strings/Levenshtein_distance#C
  * 
  * The levenshtein distance is a measure of the difference between two strings.
  * It is defined as the minimum number of single-character edits (insertions, deletions or substitutions)
- * required to change one string (s1) into the other (s2).
+ * required to change one string (word) into the other (keyword).
  * It has the following properties:
  * - Non-negative, i.e., distance(s1, s2) >= 0
  * - Identity, i.e., distance(s1, s2) == 0 if and only if s1 == s2
  * - Symmetric, i.e., distance(s1, s2) == distance(s2, s1)
+ * 
+ * Only two rows of the distance matrix are kept (fixed size, no allocation), and the calculation stops as soon as
+ * every value of a row is larger than bound, because the distance can not get smaller in later rows.
  */
-unsigned int levenshtein_distance(const char *s1, const char *s2){
-  unsigned int len1, len2;
-  len1 = strlen(s1);
-  len2 = strlen(s2);
+static unsigned int levenshtein_distance_bounded(const char *word, size_t word_length, const lexer_keyword_t *keyword, unsigned int bound){
+  // the distance is at least the difference of the lengths
+  size_t length_difference = (word_length > keyword->length) ? word_length - keyword->length : keyword->length - word_length;
+  if(length_difference > bound)
+    return bound + 1;
   
-  unsigned int matrix[len2 + 1][len1 + 1];
+  unsigned int previous_row[KEYWORD_MAX_LENGTH + 1];
+  unsigned int current_row[KEYWORD_MAX_LENGTH + 1];
   unsigned int i, j;
-  for(i = 0; i <= len2; i++) matrix[i][0] = i;
-  for(j = 0; j <= len1; j++) matrix[0][j] = j;
+  for(j = 0; j <= keyword->length; j++) previous_row[j] = j;
   
-  for(i = 1; i <= len2; i++){
-    for(j = 1; j <= len1; j++){
+  for(i = 1; i <= word_length; i++){
+    current_row[0] = i;
+    unsigned int row_min = current_row[0];
+    char c1 = (char)tolower((unsigned char)word[i - 1]);
+    for(j = 1; j <= keyword->length; j++){
       // check if characters are the same
-      char c1 = (char)tolower(s1[j - 1]);
-      char c2 = (char)tolower(s2[i - 1]);
+      char c2 = (char)tolower((unsigned char)keyword->text[j - 1]);
       unsigned int cost = (c1 == c2) ? 0 : 1;
       // calculate next matrix cell value
-      matrix[i][j] = min_3_values(
-        matrix[i - 1][j] + 1,
-        matrix[i][j - 1] + 1,
-        matrix[i - 1][j - 1] + cost
+      current_row[j] = min_3_values(
+        previous_row[j] + 1,
+        current_row[j - 1] + 1,
+        previous_row[j - 1] + cost
       );
+      if(current_row[j] < row_min)
+        row_min = current_row[j];
     }
+    
+    // early exit: all values of the row are above the bound
+    if(row_min > bound)
+      return bound + 1;
+    memcpy(previous_row, current_row, (keyword->length + 1) * sizeof(previous_row[0]));
   }
-  return matrix[len2][len1];
+  return (previous_row[keyword->length] > bound) ? bound + 1 : previous_row[keyword->length];
+}
+
+/**
+ * @brief builds the index of the keywords bucketed by length (counting sort by length)
+ * 
+ * @note called once with pthread_once and must return normally (no log_error, which would leave the once control
+ *       in progress), so a keyword longer than KEYWORD_MAX_LENGTH is only recorded and reported by print_closest_keywords
+ */
+static void build_keyword_index(){
+  int count_per_length[KEYWORD_MAX_LENGTH + 1] = { 0 };
+  for(int i = 0; i < lexer_keywords_count; i++){
+    if(lexer_keywords[i].length > KEYWORD_MAX_LENGTH){
+      keyword_index_too_long = &lexer_keywords[i];
+      return;
+    }
+    count_per_length[lexer_keywords[i].length]++;
+  }
+  
+  keyword_length_start[0] = 0;
+  for(int length = 0; length <= KEYWORD_MAX_LENGTH; length++)
+    keyword_length_start[length + 1] = keyword_length_start[length] + count_per_length[length];
+  
+  int next[KEYWORD_MAX_LENGTH + 1];
+  memcpy(next, keyword_length_start, sizeof(next));
+  for(int i = 0; i < lexer_keywords_count; i++)
+    keyword_by_length[next[lexer_keywords[i].length]++] = i;
 }
 
 /**
@@ -128,19 +195,36 @@ unsigned int levenshtein_distance(const char *s1, const char *s2){
  * @note uses the levenshtein distance to find the closest match
  */
 void print_closest_keywords(const char* word){
-  unsigned int keyword_distances[lexer_keywords_count];
+  pthread_once(&keyword_index_once, build_keyword_index);
+  if(keyword_index_too_long != NULL)
+    log_error("print_closest_keywords", 0, "Keyword '%s' is longer than %d characters.", keyword_index_too_long->text, KEYWORD_MAX_LENGTH);
+  
+  size_t word_length = strlen(word);
+  unsigned int keyword_distances[LEXER_KEYWORDS_COUNT];
+  for(int i = 0; i < lexer_keywords_count; i++)
+    keyword_distances[i] = UINT_MAX; // not compared
+  
+  // only keywords within the dynamic threshold (floor(strlen(word) / 2)) are of interest, the bound shrinks to the best distance found
+  // (capping it at KEYWORD_MAX_LENGTH does not change the result: longer words differ in length from every keyword by more than that)
   unsigned int cur_best_distance = UINT_MAX;
+  unsigned int bound = (word_length / 2 < KEYWORD_MAX_LENGTH) ? (unsigned int)(word_length / 2) : KEYWORD_MAX_LENGTH;
   
-  // iterate through all keywords and calculate their distance to the input word
-  for(int i = 0; i < lexer_keywords_count; i++){
-    keyword_distances[i] = levenshtein_distance(word, lexer_keywords[i]);
-    if(keyword_distances[i] < cur_best_distance){
-      cur_best_distance = keyword_distances[i];
+  // only the buckets of keywords whose length differs by at most the bound can contain a match
+  size_t min_length = (word_length > bound) ? word_length - bound : 0;
+  size_t max_length = (word_length + bound < KEYWORD_MAX_LENGTH) ? word_length + bound : KEYWORD_MAX_LENGTH;
+  for(size_t length = min_length; length <= max_length; length++){
+    for(int k = keyword_length_start[length]; k < keyword_length_start[length + 1]; k++){
+      int i = keyword_by_length[k];
+      keyword_distances[i] = levenshtein_distance_bounded(word, word_length, &lexer_keywords[i], bound);
+      if(keyword_distances[i] < cur_best_distance){
+        cur_best_distance = keyword_distances[i];
+        bound = cur_best_distance; // ties with the best distance are still needed
+      }
     }
   }
   
   // only suggest keywords if the distance is below dynamic threshold (floor(strlen(word) / 2))
-  unsigned int distance_threshold = (strlen(word) / 2);
+  size_t distance_threshold = word_length / 2;
   if(cur_best_distance <= distance_threshold){
     // build suggestion into buffer safely before printing
     char suggest_buf[512];
@@ -192,7 +276,7 @@ void print_closest_keywords(const char* word){
         // append keyword surrounded by single quotes
         remaining_buf = sizeof(suggest_buf) - buf_pos;
         if(remaining_buf > 0){
-          written = snprintf(suggest_buf + buf_pos, remaining_buf, "'%s'", lexer_keywords[i]);
+          written = snprintf(suggest_buf + buf_pos, remaining_buf, "'%s'", lexer_keywords[i].text);
           if(written < 0)
             log_error("print_closest_keywords", 0, "Error while using snprintf to build suggestion string.");
           
@@ -225,8 +309,8 @@ void print_closest_keywords(const char* word){
         buf_pos += (size_t)written;
     }
     
-    // print suggestion to stderr
-    fprintf(stderr, "%s\n", suggest_buf);
+    // print suggestion to stderr (or the diagnostics buffer)
+    log_diagnostic(stderr, "%s", suggest_buf);
     // write suggestion to log file
     log_write("%s", suggest_buf);
   }
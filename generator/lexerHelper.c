@@ -9,28 +9,21 @@
 /** 
  * @brief Extracts the name from a raw name string by removing surrounding quotes.
  * 
- * @param raw_name Raw name string with surrounding quotes.
- * @return char* Extracted name string without quotes. The caller is responsible for freeing the allocated memory.
+ * @param raw_name Raw name string with surrounding quotes (the token text in the input buffer).
+ * @param raw_length Length of the raw name string including the quotes.
+ * @return name_slice_t Slice of the raw name without quotes, pointing into the same buffer (nothing is copied).
  * 
  * @note Logs an error and exits if the raw_name is NULL or too short to extract a name.
 */
-char* extract_name(const char* raw_name){
+name_slice_t extract_name(const char* raw_name, size_t raw_length){
   if(raw_name == NULL)
     log_error("extract_name", 0, "Raw name is NULL.");
   
-  size_t len = strlen(raw_name);
-  if(len < 2)
-    log_error("extract_name", 0, "Raw name '%s' is too short to extract name.", raw_name);
-  
-  // Allocate memory for the new string (excluding quotes)
-  char* name = (char*)calloc(1, len - 1); // len - 2 for quotes + 1 for null terminator
-  if(name == NULL)
-    log_error("extract_name", 0, "Memory allocation failed for name extraction.");
-  
-  // Copy characters excluding the first and last quote
-  strncpy(name, raw_name + 1, len - 2);
-  name[len - 2] = '\0'; // Null-terminate the new string
+  if(raw_length < 2)
+    log_error("extract_name", 0, "Raw name '%.*s' is too short to extract name.", (int)raw_length, raw_name);
   
+  // Slice excluding the first and last quote
+  name_slice_t name = { .text = raw_name + 1, .length = raw_length - 2 };
   return name;
 }
 
@@ -1,7 +1,21 @@
 #ifndef __LEXER_HELPER_H__
 #define __LEXER_HELPER_H__
 
-char* extract_name(const char* raw_name);
+#include <stddef.h>
+
+/**
+ * @brief Name found by the scanner, a slice of the input buffer (not null-terminated).
+ * 
+ * Consists of the first character of the name and its length.
+ * 
+ * @note Only valid as long as the input buffer is loaded, copied (interned) into the arena when the AST keeps it.
+ */
+typedef struct{
+  const char *text;
+  size_t      length;
+} name_slice_t;
+
+name_slice_t extract_name(const char* raw_name, size_t raw_length);
 
 char get_port(const char* pin_text);
 unsigned int get_pin_number_PXn(const char* pin_text);
@@ -5,23 +5,57 @@
 #include <string.h>
 #include <stdarg.h> // allows variable number of arguments in function call
 
-// Active logging categories (bitwise OR of the above)
-//#define ACTIVE_LOGS (LOG_LEXER_CONDITION | LOG_LEXER_TOKEN | LOG_LEXER_CONVERSION | LOG_PARSER_FOUND | LOG_OTHER)
-#define ACTIVE_LOGS (LOG_LEXER_CONVERSION | LOG_OTHER)
+// Active logging categories (bitwise OR of the categories in logging.h), shared by all threads
+unsigned int log_active_logs = LOG_DEFAULT_LOGS;
 
-// Logging file pointer: static = only accessible from logging.c
-static FILE *log_file = NULL;
+/**
+ * @brief Structure mapping a name of the --log= option to log categories.
+ */
+typedef struct{
+  const char   *name;
+  unsigned int  categories;
+} log_category_name_t;
+
+static const log_category_name_t log_category_names[] = {
+  { "lexer_condition",  LOG_LEXER_CONDITION },
+  { "lexer_token",      LOG_LEXER_TOKEN },
+  { "lexer_conversion", LOG_LEXER_CONVERSION },
+  { "lexer",            LOG_LEXER_CONDITION | LOG_LEXER_TOKEN | LOG_LEXER_CONVERSION },
+  { "parser",           LOG_PARSER_FOUND },
+  { "other",            LOG_OTHER },
+  { "all",              LOG_ALL_CATEGORIES },
+  { "none",             0 },
+  { "default",          LOG_DEFAULT_LOGS }
+};
+
+// Logging file pointer: static = only accessible from logging.c, _Thread_local = each thread logs into its own file
+static _Thread_local FILE *log_file = NULL;
+
+// Set if the run writes no log file (see init_logging), messages are dropped and errors only go to stderr
+static _Thread_local bool log_file_disabled = false;
+
+// Buffer the messages for the user are appended to instead of printing them (NULL = print them), set per thread
+static _Thread_local emitter_t *log_diagnostics = NULL;
+
+// Jump target used instead of exit() after an error (NULL = exit the program), set per thread
+static _Thread_local jmp_buf *log_error_jump = NULL;
 
 /**
  * @brief Initializes the logging system by opening the specified log file.
  * 
- * @param output_path Path to the directory where the log file "AutoBSP.log" will be created.
+ * @param output_path Path to the directory where the log file "AutoBSP.log" will be created, or NULL to write no log file.
  * 
- * @note If the log file cannot be opened, an error message is printed to stderr and the program exits. 
+ * @note If the log file cannot be opened, an error message is printed to stderr and the run is aborted (see log_abort). 
+ * @note Without a log file, informational messages are dropped and errors are only printed to stderr.
  */
 void init_logging(const char *output_path){
   if(log_file != NULL)
     fclose(log_file); // Close any previously opened log file
+  log_file = NULL;
+  
+  log_file_disabled = (output_path == NULL);
+  if(log_file_disabled)
+    return;
   
   char file_log[256];
   snprintf(file_log, sizeof(file_log), "%s/AutoBSP.log", output_path);
@@ -29,7 +63,7 @@ void init_logging(const char *output_path){
   log_file = fopen(file_log, "w");
   if(log_file == NULL){
     fprintf(stderr, "\nERROR 'init_logging': Could not open log file '%s'\n", file_log);
-    exit(1);
+    log_abort();
   }
 }
 
@@ -43,6 +77,92 @@ void close_logging(){
     fclose(log_file);
     log_file = NULL;
   }
+  log_file_disabled = false;
+}
+
+/**
+ * @brief Sets the jump target that is used instead of exiting the program after an error.
+ * 
+ * @param error_jump Pointer to a jump buffer initialized with setjmp(), or NULL to exit the program on errors.
+ * 
+ * @note The jump target is stored per thread, so each worker thread can abort only its own run.
+ */
+void log_set_error_jump(jmp_buf *error_jump){
+  log_error_jump = error_jump;
+}
+
+/**
+ * @brief Sets the buffer the messages for the user (errors, suggestions, syntax errors) are collected in.
+ * 
+ * @param diagnostics Emitter the messages are appended to instead of printing them to stderr or stdout, or NULL to print them.
+ * 
+ * @note The buffer is stored per thread (used by the library API, see autobsp.h).
+ */
+void log_set_diagnostics(emitter_t *diagnostics){
+  log_diagnostics = diagnostics;
+}
+
+/**
+ * @brief Aborts the current run after an error has been reported.
+ * 
+ * Closes the log file and either jumps back to the target set with log_set_error_jump() or exits the program.
+ */
+void log_abort(){
+  close_logging();
+  
+  if(log_error_jump != NULL)
+    longjmp(*log_error_jump, 1);
+  exit(1);
+}
+
+/**
+ * @brief Sets the log categories that are active at runtime.
+ * 
+ * @param log_categories Bitwise OR of the log categories (see logging.h).
+ * 
+ * @note Must be called before any run starts, the categories are shared by all threads.
+ * @note Categories that are not compiled in (LOG_COMPILED_LOGS) stay disabled.
+ */
+void log_set_active_logs(unsigned int log_categories){
+  log_active_logs = log_categories;
+}
+
+/**
+ * @brief Parses a comma separated list of log category names (e.g. "lexer,parser").
+ * 
+ * @param category_list List of names: lexer_condition, lexer_token, lexer_conversion, lexer, parser, other, all, none, default.
+ * @param log_categories Pointer to store the bitwise OR of all listed categories in.
+ * @return true if all names are known, false otherwise (log_categories is not changed then).
+ * 
+ * @note Does not log, because it is used before the log file is opened.
+ */
+bool log_parse_categories(const char *category_list, unsigned int *log_categories){
+  if(category_list == NULL || log_categories == NULL)
+    return false;
+  
+  unsigned int categories = 0;
+  const char *name = category_list;
+  for(;;){
+    size_t length = strcspn(name, ",");
+    
+    bool found = false;
+    for(size_t i = 0; i < sizeof(log_category_names) / sizeof(log_category_names[0]); i++){
+      if(strlen(log_category_names[i].name) == length && strncmp(log_category_names[i].name, name, length) == 0){
+        categories |= log_category_names[i].categories;
+        found = true;
+        break;
+      }
+    }
+    if(!found)
+      return false;
+    
+    if(name[length] == '\0')
+      break;
+    name += length + 1;
+  }
+  
+  *log_categories = categories;
+  return true;
 }
 
 /**
@@ -58,25 +178,39 @@ void close_logging(){
  * @note If the line_nr is less than or equal to 0, it is omitted from the error message.
  */
 static void log_error_v_internal(const char *function_name, int line_nr, const char *message, va_list args){
-  if(log_file == NULL){
+  if(log_file == NULL && !log_file_disabled){
     fprintf(stderr, "\nERROR 'log_error': Logging file not initialized.\n");
     exit(1);
   }
   
   va_list args_copy;
   
-  // Log to stderr
+  // Log to stderr (or the diagnostics buffer)
   va_copy(args_copy, args);
-  fprintf(stderr, "\nERROR");
-  if(strcmp(function_name, "") != 0)
-    fprintf(stderr, " '%s'", function_name);
-  if(line_nr > 0)
-    fprintf(stderr, " Line %3d", line_nr);
-  fprintf(stderr, ": ");
-  vfprintf(stderr, message, args_copy);
-  fprintf(stderr, "\n");
+  if(log_diagnostics != NULL){
+    emitter_append(log_diagnostics, "\nERROR");
+    if(strcmp(function_name, "") != 0)
+      emitter_printf(log_diagnostics, " '%s'", function_name);
+    if(line_nr > 0)
+      emitter_printf(log_diagnostics, " Line %3d", line_nr);
+    emitter_append(log_diagnostics, ": ");
+    emitter_vprintf(log_diagnostics, message, args_copy);
+    emitter_append(log_diagnostics, "\n");
+  } else{
+    fprintf(stderr, "\nERROR");
+    if(strcmp(function_name, "") != 0)
+      fprintf(stderr, " '%s'", function_name);
+    if(line_nr > 0)
+      fprintf(stderr, " Line %3d", line_nr);
+    fprintf(stderr, ": ");
+    vfprintf(stderr, message, args_copy);
+    fprintf(stderr, "\n");
+  }
   va_end(args_copy);
-
+  
+  if(log_file_disabled)
+    return;
+  
   // Log to log_file
   va_copy(args_copy, args);
   fprintf(log_file, "\nERROR");
@@ -92,7 +226,7 @@ static void log_error_v_internal(const char *function_name, int line_nr, const c
 }
 
 /**
- * @brief Logs an error message to the log file and exits the program.
+ * @brief Logs an error message to the log file and aborts the run (exits the program if no jump target is set).
  * 
  * @param function_name Name of the function where the error occurred.
  * @param line_nr Line number where the error occurred.
@@ -110,12 +244,8 @@ void log_error(const char *function_name, int line_nr, const char *message, ...)
   log_error_v_internal(function_name, line_nr, message, args);
   va_end(args);
   
-  // Close the log file before exiting
-  if(log_file != NULL){
-    fclose(log_file);
-    log_file = NULL;
-  }
-  exit(1);
+  // Close the log file and exit (or jump back to the caller of the run)
+  log_abort();
 }
 
 /**
@@ -138,7 +268,7 @@ void log_error_no_exit(const char *function_name, int line_nr, const char *messa
 }
 
 /**
- * @brief Logs an informational message to the log file if the specified log category is active.
+ * @brief Logs an informational message to the log file (called by the log_info macro if the log category is enabled).
  * 
  * @param function_name Name of the function where the log is generated.
  * @param log_category Category of the log message.
@@ -148,14 +278,17 @@ void log_error_no_exit(const char *function_name, int line_nr, const char *messa
  * 
  * @note If the log file is not initialized, an error message is printed to stderr and the program exits.
  * @note If the log category is not recognized, an error is logged using log_error.
+ * @note Use the log_info macro instead, which checks first if the category is compiled in and active.
  */
-void log_info(const char *function_name, int log_category, int line_nr, const char *message, ...){
+void log_info_message(const char *function_name, int log_category, int line_nr, const char *message, ...){
+  if(log_file_disabled)
+    return;
   if(log_file == NULL){
     fprintf(stderr, "\nERROR 'log_info': Logging file not initialized.\n");
     exit(1);
   }
-
-  if((log_category) & (ACTIVE_LOGS)){
+  
+  if(log_enabled(log_category)){
     const char *category_str =  (log_category == LOG_LEXER_CONDITION)  ? "LEX_CONDI" :
                                 (log_category == LOG_LEXER_TOKEN)      ? "LEX_TOKEN" :
                                 (log_category == LOG_LEXER_CONVERSION) ? "LEX_CONVE" :
@@ -188,6 +321,8 @@ void log_info(const char *function_name, int log_category, int line_nr, const ch
  * @note If the log file is not initialized, an error message is printed to stderr and the program exits.
  */
 void log_write(const char *message, ...){
+  if(log_file_disabled)
+    return;
   if(log_file == NULL){
     fprintf(stderr, "\nERROR 'log_info': Logging file not initialized.\n");
     exit(1);
@@ -200,3 +335,25 @@ void log_write(const char *message, ...){
   fflush(log_file);
   va_end(args);
 }
+
+/**
+ * @brief Prints a message for the user (one line) to a stream, or appends it to the diagnostics buffer if one is set.
+ * 
+ * @param stream Stream the message is printed to without diagnostics buffer (stdout or stderr).
+ * @param message Format string for the message.
+ * @param ... Additional arguments for the format string.
+ * 
+ * @note Not written to the log file, see log_set_diagnostics.
+ */
+void log_diagnostic(FILE *stream, const char *message, ...){
+  va_list args;
+  va_start(args, message);
+  if(log_diagnostics != NULL){
+    emitter_vprintf(log_diagnostics, message, args);
+    emitter_append(log_diagnostics, "\n");
+  } else{
+    vfprintf(stream, message, args);
+    fprintf(stream, "\n");
+  }
+  va_end(args);
+}
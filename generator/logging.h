@@ -1,6 +1,12 @@
 #ifndef __LOGGING_H__
 #define __LOGGING_H__
 
+#include <stdio.h>
+#include <setjmp.h>
+#include <stdbool.h>
+
+#include "emitter.h"
+
 // Logging categories
 #define LOG_LEXER_CONDITION   1  // shows if lexer starts or leaves a comment
 #define LOG_LEXER_TOKEN       2  // shows the token the lexer has found
@@ -8,16 +14,54 @@
 #define LOG_PARSER_FOUND      8 // shows when the parser has found a specific rule
 #define LOG_OTHER            16  // shows all other information
 
-// Active logs are specified in the logging.c file
+#define LOG_ALL_CATEGORIES   (LOG_LEXER_CONDITION | LOG_LEXER_TOKEN | LOG_LEXER_CONVERSION | LOG_PARSER_FOUND | LOG_OTHER)
+
+// Categories compiled into the program, calls of all other categories compile to nothing (e.g. -DLOG_COMPILED_LOGS=LOG_OTHER)
+#ifndef LOG_COMPILED_LOGS
+#define LOG_COMPILED_LOGS    LOG_ALL_CATEGORIES
+#endif
+
+// Categories active if nothing else is selected at runtime (see log_set_active_logs and the --log= option)
+#define LOG_DEFAULT_LOGS     (LOG_LEXER_CONVERSION | LOG_OTHER)
+
+// Active categories at runtime, only changed before any run starts (read directly by the log_info macro)
+extern unsigned int log_active_logs;
+
+/**
+ * @brief Checks if a log category is compiled in and active.
+ * 
+ * @note With a constant category, the check is removed at compile time for categories that are not compiled in.
+ */
+#define log_enabled(log_category) ((((log_category) & (LOG_COMPILED_LOGS)) != 0) && (((log_category) & log_active_logs) != 0))
+
+/**
+ * @brief Logs an informational message if the category is enabled (see log_info_message).
+ * 
+ * @note Implemented as macro, so the arguments are not evaluated and no function is called for disabled categories
+ *       (no cost in the lexer and parser hot paths).
+ */
+#define log_info(function_name, log_category, line_nr, ...)                      \
+  do{                                                                            \
+    if(log_enabled(log_category))                                                \
+      log_info_message((function_name), (log_category), (line_nr), __VA_ARGS__); \
+  } while(0)
 
 void init_logging(const char *output_path);
 void close_logging();
 
+void log_set_error_jump(jmp_buf *error_jump);
+void log_set_diagnostics(emitter_t *diagnostics);
+void log_abort();
+
 void log_error(const char *function_name, int line_nr, const char *message, ...);
 void log_error_no_exit(const char *function_name, int line_nr, const char *message, ...);
 
-void log_info(const char *function_name, int log_category, int line_nr, const char *message, ...);
+void log_set_active_logs(unsigned int log_categories);
+bool log_parse_categories(const char *category_list, unsigned int *log_categories);
+
+void log_info_message(const char *function_name, int log_category, int line_nr, const char *message, ...) __attribute__((format(printf, 4, 5)));
 
 void log_write(const char *message, ...);
+void log_diagnostic(FILE *stream, const char *message, ...) __attribute__((format(printf, 2, 3)));
 
 #endif //__LOGGING_H__
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "logging.h"
+#include "generator.h"
+#include "generatorOptions.h"
+#include "batchMode.h"
+#include "watchMode.h"
+
+static bool parse_emit_artifacts(const char *artifact_list, unsigned int *emit);
+static bool parse_generator_options(int *argc, char *argv[], generator_options_t *options);
+
+
+/* -------------------------------------------- */
+/*                Command line                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Parses a comma separated list of artifact names for --emit= (e.g. "header,source").
+ * 
+ * @param artifact_list List of names: header, source, code (header and source), dot, scripts, log, ir, all, none.
+ * @param emit Pointer to store the bitwise OR of all listed artifacts in (see EMIT_* in generatorOptions.h).
+ * @return true if all names are known, false otherwise (emit is not changed then).
+ */
+static bool parse_emit_artifacts(const char *artifact_list, unsigned int *emit){
+  static const struct{ const char *name; unsigned int emit; } emit_names[] = {
+    { "header",  EMIT_HEADER },
+    { "source",  EMIT_SOURCE },
+    { "code",    EMIT_HEADER | EMIT_SOURCE },
+    { "dot",     EMIT_DOT },
+    { "scripts", EMIT_SCRIPTS },
+    { "log",     EMIT_LOG },
+    { "ir",      EMIT_IR },
+    { "all",     EMIT_ALL },
+    { "none",    0 }
+  };
+  
+  unsigned int selected = 0;
+  const char *name = artifact_list;
+  for(;;){
+    size_t length = strcspn(name, ",");
+    
+    bool found = false;
+    for(size_t i = 0; i < sizeof(emit_names) / sizeof(emit_names[0]); i++){
+      if(strlen(emit_names[i].name) == length && strncmp(emit_names[i].name, name, length) == 0){
+        selected |= emit_names[i].emit;
+        found = true;
+        break;
+      }
+    }
+    if(!found)
+      return false;
+    
+    if(name[length] == '\0')
+      break;
+    name += length + 1;
+  }
+  
+  *emit = selected;
+  return true;
+}
+
+/**
+ * @brief Removes the generator options (e.g. "--stats", "--timings", "--force", "--log=<categories>", "--emit=<artifacts>") from the arguments and stores them in the options.
+ * 
+ * @param argc Pointer to the number of arguments, reduced by the number of removed options.
+ * @param argv Arguments, the remaining arguments are moved to the front (keeping their order).
+ * @param options Options to fill (unchanged for options not given).
+ * @return true on success, false if an option has an invalid value (an error is printed to stderr).
+ * 
+ * @note The options can be placed anywhere on the command line, also in batch mode.
+ */
+static bool parse_generator_options(int *argc, char *argv[], generator_options_t *options){
+  int kept = 1; // Keep program name
+  for(int i = 1; i < *argc; i++){
+    if(strcmp(argv[i], "--stats") == 0)
+      options->print_stats = true;
+    else if(strcmp(argv[i], "--timings") == 0)
+      options->print_timings = true;
+    else if(strcmp(argv[i], "--json") == 0)
+      options->print_json = true;
+    else if(strcmp(argv[i], "--force") == 0)
+      options->force = true;
+    else if(strncmp(argv[i], "--log=", 6) == 0){
+      if(!log_parse_categories(argv[i] + 6, &options->log_categories)){
+        fprintf(stderr, "\nERROR 'main': Invalid log categories '%s'.\n"
+                        "              Use a comma separated list of: lexer_condition, lexer_token, lexer_conversion, lexer, parser, other, all, none, default\n", argv[i] + 6);
+        return false;
+      }
+    }
+    else if(strncmp(argv[i], "--emit=", 7) == 0){
+      if(!parse_emit_artifacts(argv[i] + 7, &options->emit)){
+        fprintf(stderr, "\nERROR 'main': Invalid artifacts '%s'.\n"
+                        "              Use a comma separated list of: header, source, code, dot, scripts, log, ir, all, none\n", argv[i] + 7);
+        return false;
+      }
+    }
+    else
+      argv[kept++] = argv[i];
+  }
+  argv[kept] = NULL;
+  *argc = kept;
+  return true;
+}
+
+int main(int argc, char *argv[]){
+  generator_options_t options = { .print_stats = false, .print_timings = false, .print_json = false, .force = false, .log_categories = LOG_DEFAULT_LOGS, .emit = EMIT_DEFAULT, .read_input = false };
+  if(!parse_generator_options(&argc, argv, &options))
+    return 1;
+  log_set_active_logs(options.log_categories);
+  
+  // Batch mode: ./AutoBSP --batch [--jobs <n>] (--manifest <file> | <codefile>[:<output_path>] ...)
+  if(argc >= 2 && strcmp(argv[1], "--batch") == 0)
+    return batch_main(argc - 2, argv + 2, generate_bsp, &options);
+  
+  // Watch mode: ./AutoBSP --watch <codefile> [<output_path>] (regenerates on every change of the codefile)
+  bool watch = (argc >= 2 && strcmp(argv[1], "--watch") == 0);
+  if(watch){
+    argc--;
+    argv++;
+  }
+  
+  // Check for correct number of arguments (./AutoBSP <codefile> [<output_path>])
+  if(argc < 2 || argc > 3){
+    fprintf(stderr, "\nERROR 'main': Incorrect number of arguments.\n              Usage: %s [--stats] [--timings] [--json] [--force] [--log=<categories>] [--emit=<artifacts>] <codefile_name> [<output_path>]\n", argv[0]);
+    fprintf(stderr, "                     %s [--stats] [--timings] [--json] [--force] [--log=<categories>] [--emit=<artifacts>] --batch [--jobs <n>] (--manifest <manifest_file> | <codefile_name>[:<output_path>] ...)\n", argv[0]);
+    fprintf(stderr, "                     %s [--stats] [--timings] [--json] [--force] [--log=<categories>] [--emit=<artifacts>] --watch <codefile_name> [<output_path>]\n", argv[0]);
+    return 1;
+  }
+  
+  // Get the program file path
+  char *code_file = argv[1];
+  
+  // Determine path for all output files
+  char *output_path;
+  if(argc == 3) // Use provided output path
+    output_path = argv[2];
+  else // Default to "output" directory
+    output_path = "output";
+  
+  if(watch)
+    return watch_main(code_file, output_path, generate_bsp_in_context, &options);
+  return generate_bsp(code_file, output_path, &options);
+}
@@ -0,0 +1,232 @@
+#include "parserContext.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "logging.h"
+#include "astCheck.h"
+#include "astHelper.h"
+
+/* Functions of the reentrant scanner generated by flex (yyscan_t is a void pointer) */
+int yylex_init_extra(parser_context_t *extra, void **scanner);
+int yylex_destroy(void *scanner);
+struct yy_buffer_state* yy_scan_buffer(char *base, size_t size, void *scanner);
+
+
+/* -------------------------------------------- */
+/*          Constructor and destructor          */
+/* -------------------------------------------- */
+
+/**
+ * @brief Creates a new parser context with its own scanner working directly on the loaded input.
+ * 
+ * @param code_file Name of the DSL file (only used for messages).
+ * @param input Loaded content of the DSL file, scanned in place (no copy).
+ * @param stats Timings and counters of the run (the scanner counts the tokens in it).
+ * @return Pointer to the newly created parser context.
+ * 
+ * @note The scanner gets the context as extra data (yyextra).
+ * @note The input must stay loaded until the context is freed, the names found by the scanner are slices of it.
+ */
+parser_context_t* parser_new_context(const char *code_file, input_buffer_t *input, run_stats_t *stats){
+  if(input == NULL || input->data == NULL)
+    log_error("parser_new_context", 0, "Input of '%s' is not loaded.", code_file);
+  if(stats == NULL)
+    log_error("parser_new_context", 0, "Run statistics of '%s' are NULL.", code_file);
+  
+  parser_context_t *ctx = (parser_context_t*)calloc(1, sizeof(parser_context_t));
+  if(ctx == NULL)
+    log_error("parser_new_context", 0, "Could not allocate memory for new parser context.");
+  
+  // Explicitly initialize fields
+  ctx->code_file              = code_file;
+  ctx->dsl_builder            = NULL;
+  ctx->current_module_builder = NULL;
+  ctx->node_counter           = 0;
+  arena_init(&ctx->arena, 0);
+  emitter_init(&ctx->header_emitter);
+  emitter_init(&ctx->source_emitter);
+  emitter_init(&ctx->print_emitter);
+  ctx->stats                  = stats;
+  
+  if(yylex_init_extra(ctx, &ctx->scanner) != 0)
+    log_error("parser_new_context", 0, "Could not initialize scanner for '%s'.", code_file);
+  if(yy_scan_buffer(input->data, input->length + INPUT_BUFFER_PADDING, ctx->scanner) == NULL)
+    log_error("parser_new_context", 0, "Could not set the input buffer of the scanner for '%s'.", code_file);
+  
+  return ctx;
+}
+
+/**
+ * @brief Prepares a parser context of a finished (or aborted) run for the next run, keeping its memory.
+ * 
+ * @param ctx Pointer to the parser context to reuse.
+ * @param code_file Name of the DSL file (only used for messages).
+ * @param input Loaded content of the DSL file, scanned in place (no copy).
+ * @param stats Timings and counters of the new run.
+ * 
+ * @note The first arena block and the emitter buffers are kept, so a run of a similar file allocates (almost) nothing.
+ * @note The scanner is created anew (its state is undefined after an aborted run).
+ * @note The allocation and emitted byte counters are cleared, so the report covers only the new run.
+ */
+void parser_reset_context(parser_context_t *ctx, const char *code_file, input_buffer_t *input, run_stats_t *stats){
+  if(ctx == NULL)
+    log_error("parser_reset_context", 0, "Parser context is NULL.");
+  if(input == NULL || input->data == NULL)
+    log_error("parser_reset_context", 0, "Input of '%s' is not loaded.", code_file);
+  if(stats == NULL)
+    log_error("parser_reset_context", 0, "Run statistics of '%s' are NULL.", code_file);
+  
+  if(ctx->scanner != NULL)
+    yylex_destroy(ctx->scanner);
+  ctx->scanner = NULL;
+  
+  ctx->code_file              = code_file;
+  ctx->dsl_builder            = NULL;
+  ctx->current_module_builder = NULL;
+  ctx->node_counter           = 0;
+  arena_reset(&ctx->arena);
+  ctx->arena.allocation_count    = 0;
+  ctx->arena.bytes_allocated     = 0;
+  ctx->arena.peak_bytes_reserved = ctx->arena.bytes_reserved;
+  emitter_clear(&ctx->header_emitter);
+  emitter_clear(&ctx->source_emitter);
+  emitter_clear(&ctx->print_emitter);
+  ctx->header_emitter.total_length = 0;
+  ctx->source_emitter.total_length = 0;
+  ctx->print_emitter.total_length  = 0;
+  ctx->stats                  = stats;
+  
+  if(yylex_init_extra(ctx, &ctx->scanner) != 0)
+    log_error("parser_reset_context", 0, "Could not initialize scanner for '%s'.", code_file);
+  if(yy_scan_buffer(input->data, input->length + INPUT_BUFFER_PADDING, ctx->scanner) == NULL)
+    log_error("parser_reset_context", 0, "Could not set the input buffer of the scanner for '%s'.", code_file);
+}
+
+/**
+ * @brief Frees the parser context, its scanner, its arena, and its emitters.
+ * 
+ * @param ctx Pointer to the parser context to free.
+ * 
+ * @note Releases all builders, AST nodes and names of the run at once, so no pointer to them may be used afterwards.
+ * @note The input buffer is not released.
+ */
+void parser_free_context(parser_context_t* ctx){
+  if(ctx == NULL)
+    return;
+  
+  if(ctx->scanner != NULL)
+    yylex_destroy(ctx->scanner);
+  arena_free(&ctx->arena);
+  emitter_free(&ctx->header_emitter);
+  emitter_free(&ctx->source_emitter);
+  emitter_free(&ctx->print_emitter);
+  free(ctx);
+}
+
+
+/* -------------------------------------------- */
+/*                  Statistics                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Prints the report of the run selected by the options to stdout: memory statistics (--stats),
+ *        phase timings and counters (--timings), or everything as one JSON object (--json).
+ * 
+ * @param ctx Pointer to the parser context of the run (with its statistics).
+ * @param dsl_node Pointer to the bound AST of the run (PWM timing in the JSON object, see ast_pwm_timing).
+ * @param options Options of the run selecting the report.
+ * 
+ * @note The peak RSS is measured for the whole process, so in batch mode it covers all runs finished so far.
+ * @note The report is printed with one call, so reports of parallel runs are not interleaved.
+ */
+void parser_print_report(const parser_context_t* ctx, const ast_dsl_node_t *dsl_node, const generator_options_t *options){
+  if(ctx == NULL || dsl_node == NULL || options == NULL)
+    return;
+  if(!options->print_stats && !options->print_timings && !options->print_json)
+    return;
+  
+  const run_stats_t *stats = ctx->stats;
+  size_t bytes_emitted = ctx->header_emitter.total_length + ctx->source_emitter.total_length + ctx->print_emitter.total_length;
+  
+  struct rusage usage;
+  long peak_rss_kb = (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : -1; // Linux reports kilobytes
+  
+  emitter_t report;
+  emitter_init(&report);
+  
+  if(options->print_json){
+    emitter_append(&report, "{\"file\":");
+    run_stats_append_json_string(&report, ctx->code_file);
+    emitter_printf(&report, ",\"total_ms\":%.3f,\"phases_ms\":{", run_stats_total_ms(stats));
+    for(int i = 0; i < RUN_PHASE_COUNT; i++)
+      emitter_printf(&report, "%s\"%s\":%.3f", (i == 0) ? "" : ",", run_phase_to_string((run_phase_t)i), stats->phase_ms[i]);
+    emitter_printf(&report, "},\"counters\":{\"tokens_lexed\":%zu,\"modules\":%zu,\"enabled_modules\":%zu,\"bytes_emitted\":%zu,"
+                            "\"arena_allocations\":%zu,\"arena_bytes_allocated\":%zu,\"arena_bytes_reserved\":%zu,\"arena_blocks\":%zu},"
+                            "\"pwm\":[",
+                   stats->tokens_lexed, stats->modules, stats->enabled_modules, bytes_emitted,
+                   ctx->arena.allocation_count, ctx->arena.bytes_allocated, ctx->arena.peak_bytes_reserved, ctx->arena.block_count);
+    
+    // Achieved signal of each PWM module (if the controller provides it)
+    ast_module_span_t pwm_modules = get_enabled_modules(dsl_node, MODULE_PWM_OUTPUT);
+    bool first_pwm = true;
+    for(uint32_t i = 0; i < pwm_modules.count; i++){
+      ast_pwm_timing_t timing;
+      if(!ast_pwm_timing(dsl_node, pwm_modules.items[i], &timing))
+        continue;
+      emitter_append(&report, first_pwm ? "{\"module\":" : ",{\"module\":");
+      run_stats_append_json_string(&report, pwm_modules.items[i]->name);
+      emitter_printf(&report, ",\"frequency_hz\":%u,\"achieved_hz\":%.6f,\"error_ppm\":%.3f,\"duty_steps\":%u,\"resolution_bits\":%.2f}",
+                     pwm_modules.items[i]->data.pwm.frequency, timing.achieved_frequency, timing.error_ppm,
+                     timing.duty_steps, timing.resolution_bits);
+      first_pwm = false;
+    }
+    emitter_printf(&report, "],\"peak_rss_kb\":%ld}\n", peak_rss_kb);
+  } else{
+    if(options->print_timings){
+      emitter_printf(&report, "Timings '%s': total %.3f ms (", ctx->code_file, run_stats_total_ms(stats));
+      for(int i = 0; i < RUN_PHASE_COUNT; i++)
+        emitter_printf(&report, "%s%s %.3f", (i == 0) ? "" : ", ", run_phase_to_string((run_phase_t)i), stats->phase_ms[i]);
+      emitter_printf(&report, "), %zu tokens, %zu modules (%zu enabled), %zu bytes emitted\n",
+                     stats->tokens_lexed, stats->modules, stats->enabled_modules, bytes_emitted);
+    }
+    if(options->print_stats){
+      emitter_printf(&report, "Stats '%s': %zu arena allocations, %zu bytes allocated, %zu bytes reserved in %zu blocks, peak RSS %ld kB\n",
+                     ctx->code_file, ctx->arena.allocation_count, ctx->arena.bytes_allocated,
+                     ctx->arena.peak_bytes_reserved, ctx->arena.block_count, peak_rss_kb);
+    }
+  }
+  
+  fputs(report.data, stdout);
+  emitter_free(&report);
+}
+
+/**
+ * @brief Prints that a run was skipped because its output directory is up to date (see regen_cache_is_up_to_date).
+ * 
+ * @param code_file Path of the DSL file of the run.
+ * @param output_path Path of the output directory of the run.
+ * @param options Options of the run: with --json, the notice is one JSON object, like the reports of generated runs.
+ * 
+ * @note The notice is printed with one call, so notices of parallel runs are not interleaved.
+ */
+void parser_print_up_to_date(const char *code_file, const char *output_path, const generator_options_t *options){
+  if(code_file == NULL || output_path == NULL || options == NULL)
+    return;
+  
+  emitter_t notice;
+  emitter_init(&notice);
+  if(options->print_json){
+    emitter_append(&notice, "{\"file\":");
+    run_stats_append_json_string(&notice, code_file);
+    emitter_append(&notice, ",\"output\":");
+    run_stats_append_json_string(&notice, output_path);
+    emitter_append(&notice, ",\"cached\":true}\n");
+  } else{
+    emitter_printf(&notice, "Output '%s' is up to date with '%s', nothing generated (use --force to regenerate)\n", output_path, code_file);
+  }
+  
+  fputs(notice.data, stdout);
+  emitter_free(&notice);
+}
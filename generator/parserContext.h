@@ -0,0 +1,41 @@
+#ifndef __PARSER_CONTEXT_H__
+#define __PARSER_CONTEXT_H__
+
+#include "astEnums.h"
+#include "arena.h"
+#include "emitter.h"
+#include "inputBuffer.h"
+#include "runStats.h"
+#include "generatorOptions.h"
+
+/**
+ * @brief Structure holding the complete state of one parser run.
+ * 
+ * Consists of the parsed file name, the reentrant flex scanner (which also tracks the line number),
+ * the DSL builder filled by the parser, the module builder currently being filled, the counter for node IDs,
+ * the arena all builders, AST nodes and names of the run are allocated from, the emitters the code is generated into,
+ * and the timings and counters of the run.
+ * 
+ * @note Each DSL file gets its own context, so several files can be parsed at the same time (e.g. on different threads).
+ */
+typedef struct{
+  const char *code_file;                        // Name of the parsed DSL file (used in error messages)
+  void *scanner;                                // Reentrant flex scanner (yyscan_t), owns the line number
+  ast_dsl_builder_t *dsl_builder;               // DSL builder filled by the parser
+  ast_module_builder_t *current_module_builder; // Module builder of the module definition currently parsed
+  unsigned int node_counter;                    // Node ID of the next created module node
+  arena_t arena;                                // Owns builders, AST nodes and names, released at once with the context
+  emitter_t header_emitter;                     // Buffer for the generated header file
+  emitter_t source_emitter;                     // Buffer for the generated source file
+  emitter_t print_emitter;                      // Buffer for the printed AST graphs and helper scripts
+  run_stats_t *stats;                           // Timings and counters of the run (owned by the caller, counts the tokens)
+} parser_context_t;
+
+parser_context_t* parser_new_context(const char *code_file, input_buffer_t *input, run_stats_t *stats);
+void parser_reset_context(parser_context_t *ctx, const char *code_file, input_buffer_t *input, run_stats_t *stats);
+void parser_free_context(parser_context_t* ctx);
+
+void parser_print_report(const parser_context_t* ctx, const ast_dsl_node_t *dsl_node, const generator_options_t *options);
+void parser_print_up_to_date(const char *code_file, const char *output_path, const generator_options_t *options);
+
+#endif //__PARSER_CONTEXT_H__
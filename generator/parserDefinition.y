@@ -1,6 +1,8 @@
 %{
   #include <stdio.h>
   #include <stdint.h>
+  #include <string.h>
+  #include <setjmp.h>
   
   #include "logging.h"
   #include "astEnums.h"
@@ -9,24 +11,28 @@
   #include "astCheck.h"
   #include "astPrint.h"
   #include "astGenerate.h"
-  
-  int yylex();
-  extern FILE *yyin;
-  extern int yylineno;
+  #include "bspIr.h"
+  #include "generator.h"
+  #include "generatorOptions.h"
+  #include "regenCache.h"
   
   int yydebug = 0;
-  void yyerror(const char *msg);
-  
-  ast_dsl_builder_t *dsl_builder = NULL;
-  ast_module_builder_t *current_module_builder = NULL;
 %}
 
 %define parse.error verbose
 
+  /* Pure (reentrant) parser: all state of one run lives in the parser context and the scanner */
+%define api.pure full
+%parse-param {parser_context_t *ctx} {void *scanner}
+%lex-param   {void *scanner}
+
   /* -------------------------------------------- */
   /*               Type definitions               */
   /* -------------------------------------------- */
 %code requires{
+  #include "parserContext.h"
+  #include "lexerHelper.h"
+  
   typedef enum{
     GPIO_HELPER_PULL_UP,
     GPIO_HELPER_PULL_DOWN
@@ -99,7 +105,8 @@
   /* -------------------------------------------- */
 %union{
   controller_t          u_controller;         // For val_controller
-  char*                 u_str;                // For val_name
+  name_slice_t          u_name;               // For val_name (slice of the input buffer)
+  char*                 u_str;                // For parser use (name interned into the arena)
   pin_t                 u_pin;                // For val_pin
   bool                  u_bool;               // For val_bool
   level_t               u_level;              // For val_level
@@ -116,6 +123,14 @@
   float                 u_float;              // For val_float
 }
 
+%code{
+  /* Functions of the reentrant scanner generated by flex (yyscan_t is a void pointer) */
+  int yylex(YYSTYPE *yylval_param, void *scanner);
+  int yyget_lineno(void *scanner);
+  
+  void yyerror(parser_context_t *ctx, void *scanner, const char *msg);
+}
+
 %start START
 
   /* -------------------------------------------- */
@@ -152,7 +167,7 @@
 %token <u_helper_uart_parity> val_uart_parity
   
   /* -------- Rules for dynamic patterns -------- */
-%token <u_str> val_name 
+%token <u_name> val_name 
 %token <u_pin> val_pin
 %token <u_nr>  val_nr
 
@@ -183,9 +198,9 @@
   /*                Grammar rules                 */
   /* -------------------------------------------- */
 
-START:  kw_autobsp  { if(dsl_builder != NULL)
+START:  kw_autobsp  { if(ctx->dsl_builder != NULL)
                         log_error("START", 0, "DSL builder has already been set.");
-                      dsl_builder = ast_new_dsl_builder();
+                      ctx->dsl_builder = ast_new_dsl_builder(&ctx->arena);
                     }
         '{' FILE_CONTENTS '}'
       | /* empty */
@@ -195,295 +210,285 @@ FILE_CONTENTS: GLOBAL_PARAMS MODULE_DEFS
 GLOBAL_PARAMS: GLOBAL_PARAMS GLOBAL_PARAM END
               | GLOBAL_PARAM END
 
-GLOBAL_PARAM: CONTROLLER_PARAM  { if(dsl_builder == NULL)
-                                    log_error("GLOBAL_PARAM", yylineno, "DSL builder is NULL when setting controller.");
-                                  ast_dsl_builder_set_controller(yylineno, dsl_builder, $1);
+GLOBAL_PARAM: CONTROLLER_PARAM  { if(ctx->dsl_builder == NULL)
+                                    log_error("GLOBAL_PARAM", yyget_lineno(scanner), "DSL builder is NULL when setting controller.");
+                                  ast_dsl_builder_set_controller(yyget_lineno(scanner), ctx->dsl_builder, $1);
                                 }
 
 CONTROLLER_PARAM: kw_controller ':' val_controller  { $$ = $3;
-                                                      log_info("CONTROLLER_PARAM", LOG_PARSER_FOUND, yylineno, "Found controller parameter with value '%s'", controller_to_string($3));
+                                                      log_info("CONTROLLER_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found controller parameter with value '%s'", controller_to_string($3));
                                                     }
 
 MODULE_DEFS:  MODULE_DEFS MODULE_DEF
             | MODULE_DEF
 
 MODULE_DEF: kw_input  { /* Start new input module builder */
-                        log_info("MODULE_DEF", LOG_PARSER_FOUND, yylineno, "Found input module definition.");
-                        if(current_module_builder != NULL)
-                          log_error("MODULE_DEF", yylineno, "Previous module builder not finalized before starting new input module.");
-                        current_module_builder = ast_new_module_builder(yylineno);
-                        ast_module_builder_set_kind(yylineno, current_module_builder, MODULE_INPUT);
+                        log_info("MODULE_DEF", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found input module definition.");
+                        if(ctx->current_module_builder != NULL)
+                          log_error("MODULE_DEF", yyget_lineno(scanner), "Previous module builder not finalized before starting new input module.");
+                        ctx->current_module_builder = ast_new_module_builder(&ctx->arena, yyget_lineno(scanner), ctx->node_counter++);
+                        ast_module_builder_set_kind(yyget_lineno(scanner), ctx->current_module_builder, MODULE_INPUT);
                       }
             '{' INPUT_PARAMS '}'  { /* Append the current module builder to the DSL builder */
-                                    ast_dsl_builder_append_module_builder(yylineno, dsl_builder, current_module_builder);
-                                    current_module_builder = NULL;
+                                    ast_dsl_builder_append_module_builder(yyget_lineno(scanner), ctx->dsl_builder, ctx->current_module_builder);
+                                    ctx->current_module_builder = NULL;
                                   }
           | kw_output { /* Start new output module builder */
-                        log_info("MODULE_DEF", LOG_PARSER_FOUND, yylineno, "Found output module definition.");
-                        if(current_module_builder != NULL)
-                          log_error("MODULE_DEF", yylineno, "Previous module builder not finalized before starting new output module.");
-                        current_module_builder = ast_new_module_builder(yylineno);
-                        ast_module_builder_set_kind(yylineno, current_module_builder, MODULE_OUTPUT);
+                        log_info("MODULE_DEF", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found output module definition.");
+                        if(ctx->current_module_builder != NULL)
+                          log_error("MODULE_DEF", yyget_lineno(scanner), "Previous module builder not finalized before starting new output module.");
+                        ctx->current_module_builder = ast_new_module_builder(&ctx->arena, yyget_lineno(scanner), ctx->node_counter++);
+                        ast_module_builder_set_kind(yyget_lineno(scanner), ctx->current_module_builder, MODULE_OUTPUT);
                       }
               '{' OUTPUT_PARAMS '}' { /* Append the current module builder to the DSL builder */
-                                      ast_dsl_builder_append_module_builder(yylineno, dsl_builder, current_module_builder);
-                                      current_module_builder = NULL;
+                                      ast_dsl_builder_append_module_builder(yyget_lineno(scanner), ctx->dsl_builder, ctx->current_module_builder);
+                                      ctx->current_module_builder = NULL;
                                     }
           | kw_pwm_output { /* Start new PWM output module builder */
-                            log_info("MODULE_DEF", LOG_PARSER_FOUND, yylineno, "Found PWM output module definition.");
-                            if(current_module_builder != NULL)
-                              log_error("MODULE_DEF", yylineno, "Previous module builder not finalized before starting new PWM output module.");
-                            current_module_builder = ast_new_module_builder(yylineno);
-                            ast_module_builder_set_kind(yylineno, current_module_builder, MODULE_PWM_OUTPUT);
+                            log_info("MODULE_DEF", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found PWM output module definition.");
+                            if(ctx->current_module_builder != NULL)
+                              log_error("MODULE_DEF", yyget_lineno(scanner), "Previous module builder not finalized before starting new PWM output module.");
+                            ctx->current_module_builder = ast_new_module_builder(&ctx->arena, yyget_lineno(scanner), ctx->node_counter++);
+                            ast_module_builder_set_kind(yyget_lineno(scanner), ctx->current_module_builder, MODULE_PWM_OUTPUT);
                           }
               '{' PWM_PARAMS '}'  { /* Append the current module builder to the DSL builder */
-                                    ast_dsl_builder_append_module_builder(yylineno, dsl_builder, current_module_builder);
-                                    current_module_builder = NULL;
+                                    ast_dsl_builder_append_module_builder(yyget_lineno(scanner), ctx->dsl_builder, ctx->current_module_builder);
+                                    ctx->current_module_builder = NULL;
                                   }
           | kw_uart { /* Start new UART module builder */
-                      log_info("MODULE_DEF", LOG_PARSER_FOUND, yylineno, "Found UART module definition.");
-                      if(current_module_builder != NULL)
-                        log_error("MODULE_DEF", yylineno, "Previous module builder not finalized before starting new UART module.");
-                      current_module_builder = ast_new_module_builder(yylineno);
-                      ast_module_builder_set_kind(yylineno, current_module_builder, MODULE_UART);
+                      log_info("MODULE_DEF", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART module definition.");
+                      if(ctx->current_module_builder != NULL)
+                        log_error("MODULE_DEF", yyget_lineno(scanner), "Previous module builder not finalized before starting new UART module.");
+                      ctx->current_module_builder = ast_new_module_builder(&ctx->arena, yyget_lineno(scanner), ctx->node_counter++);
+                      ast_module_builder_set_kind(yyget_lineno(scanner), ctx->current_module_builder, MODULE_UART);
                     }
               '{' UART_PARAMS '}' { /* Append the current module builder to the DSL builder */
-                                    ast_dsl_builder_append_module_builder(yylineno, dsl_builder, current_module_builder);
-                                    current_module_builder = NULL;
+                                    ast_dsl_builder_append_module_builder(yyget_lineno(scanner), ctx->dsl_builder, ctx->current_module_builder);
+                                    ctx->current_module_builder = NULL;
                                   }
 
 
 INPUT_PARAMS: INPUT_PARAMS INPUT_PARAM END
             | INPUT_PARAM END
 
-INPUT_PARAM:  NAME_PARAM        { if(!current_module_builder)
-                                    log_error("INPUT_PARAM", yylineno, "No current module builder to set name.");
-                                  ast_module_builder_set_name(yylineno, current_module_builder, $1);
-                                  if($1)
-                                    free($1); // Free the in the lexer allocated string
-                                  else
-                                    log_error("INPUT_PARAM", yylineno, "INPUT_PARAM: Name parameter is NULL.");
+INPUT_PARAM:  NAME_PARAM        { if(!ctx->current_module_builder)
+                                    log_error("INPUT_PARAM", yyget_lineno(scanner), "No current module builder to set name.");
+                                  ast_module_builder_set_name(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-            | PIN_PARAM         { if(!current_module_builder)
-                                    log_error("INPUT_PARAM", yylineno, "No current module builder to set pin.");
-                                  ast_module_builder_set_pin(yylineno, current_module_builder, $1);
+            | PIN_PARAM         { if(!ctx->current_module_builder)
+                                    log_error("INPUT_PARAM", yyget_lineno(scanner), "No current module builder to set pin.");
+                                  ast_module_builder_set_pin(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-            | ENABLE_PARAM      { if(!current_module_builder)
-                                    log_error("INPUT_PARAM", yylineno, "No current module builder to set enable.");
-                                  ast_module_builder_set_enable(yylineno, current_module_builder, $1);
+            | ENABLE_PARAM      { if(!ctx->current_module_builder)
+                                    log_error("INPUT_PARAM", yyget_lineno(scanner), "No current module builder to set enable.");
+                                  ast_module_builder_set_enable(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-            | GPIO_PULL_PARAM   { if(!current_module_builder)
-                                    log_error("INPUT_PARAM", yylineno, "No current module builder to set GPIO pull.");
-                                  ast_module_builder_set_input_pull(yylineno, current_module_builder, $1);
+            | GPIO_PULL_PARAM   { if(!ctx->current_module_builder)
+                                    log_error("INPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO pull.");
+                                  ast_module_builder_set_input_pull(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-            | GPIO_ACTIVE_PARAM { if(!current_module_builder)
-                                    log_error("INPUT_PARAM", yylineno, "No current module builder to set GPIO active level.");
-                                  ast_module_builder_set_input_active_level(yylineno, current_module_builder, $1);
+            | GPIO_ACTIVE_PARAM { if(!ctx->current_module_builder)
+                                    log_error("INPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO active level.");
+                                  ast_module_builder_set_input_active_level(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
 
 OUTPUT_PARAMS:  OUTPUT_PARAMS OUTPUT_PARAM END
               | OUTPUT_PARAM END
 
-OUTPUT_PARAM: NAME_PARAM          { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set name.");
-                                    ast_module_builder_set_name(yylineno, current_module_builder, $1);
-                                    if($1)
-                                      free($1); // Free the in the lexer allocated string
-                                    else
-                                      log_error("OUTPUT_PARAM", yylineno, "OUTPUT_PARAM: Name parameter is NULL.");
+OUTPUT_PARAM: NAME_PARAM          { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set name.");
+                                    ast_module_builder_set_name(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | PIN_PARAM           { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set pin.");
-                                    ast_module_builder_set_pin(yylineno, current_module_builder, $1);
+            | PIN_PARAM           { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set pin.");
+                                    ast_module_builder_set_pin(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | ENABLE_PARAM        { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set enable.");
-                                    ast_module_builder_set_enable(yylineno, current_module_builder, $1);
+            | ENABLE_PARAM        { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set enable.");
+                                    ast_module_builder_set_enable(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | GPIO_TYPE_PARAM     { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set GPIO type.");
-                                    ast_module_builder_set_output_type(yylineno, current_module_builder, $1);
+            | GPIO_TYPE_PARAM     { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO type.");
+                                    ast_module_builder_set_output_type(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | GPIO_PULL_PARAM     { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set GPIO pull.");
-                                    ast_module_builder_set_output_pull(yylineno, current_module_builder, $1);
+            | GPIO_PULL_PARAM     { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO pull.");
+                                    ast_module_builder_set_output_pull(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | GPIO_SPEED_PARAM    { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set GPIO speed.");
-                                    ast_module_builder_set_output_speed(yylineno, current_module_builder, $1);
+            | GPIO_SPEED_PARAM    { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO speed.");
+                                    ast_module_builder_set_output_speed(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | GPIO_INIT_PARAM     { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set GPIO init.");
-                                    ast_module_builder_set_output_init(yylineno, current_module_builder, $1);
+            | GPIO_INIT_PARAM     { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO init.");
+                                    ast_module_builder_set_output_init(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | GPIO_ACTIVE_PARAM   { if(!current_module_builder)
-                                      log_error("OUTPUT_PARAM", yylineno, "No current module builder to set GPIO active level.");
-                                    ast_module_builder_set_output_active_level(yylineno, current_module_builder, $1);
+            | GPIO_ACTIVE_PARAM   { if(!ctx->current_module_builder)
+                                      log_error("OUTPUT_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO active level.");
+                                    ast_module_builder_set_output_active_level(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
 
 PWM_PARAMS: PWM_PARAMS PWM_PARAM END
           | PWM_PARAM END
 
-PWM_PARAM:  NAME_PARAM          { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set name.");
-                                  ast_module_builder_set_name(yylineno, current_module_builder, $1);
-                                  if($1)
-                                    free($1); // Free the in the lexer allocated string
-                                  else
-                                    log_error("PWM_PARAM", yylineno, "PWM_PARAM: Name parameter is NULL.");
+PWM_PARAM:  NAME_PARAM          { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set name.");
+                                  ast_module_builder_set_name(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | PIN_PARAM           { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set pin.");
-                                  ast_module_builder_set_pin(yylineno, current_module_builder, $1);
+          | PIN_PARAM           { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set pin.");
+                                  ast_module_builder_set_pin(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | ENABLE_PARAM        { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set enable.");
-                                  ast_module_builder_set_enable(yylineno, current_module_builder, $1);
+          | ENABLE_PARAM        { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set enable.");
+                                  ast_module_builder_set_enable(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | GPIO_PULL_PARAM     { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set GPIO pull.");
-                                  ast_module_builder_set_pwm_pull(yylineno, current_module_builder, $1);
+          | GPIO_PULL_PARAM     { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO pull.");
+                                  ast_module_builder_set_pwm_pull(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | GPIO_SPEED_PARAM    { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set GPIO speed.");
-                                  ast_module_builder_set_pwm_speed(yylineno, current_module_builder, $1);
+          | GPIO_SPEED_PARAM    { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO speed.");
+                                  ast_module_builder_set_pwm_speed(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | GPIO_ACTIVE_PARAM   { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set GPIO active level.");
-                                  ast_module_builder_set_pwm_active_level(yylineno, current_module_builder, $1);
+          | GPIO_ACTIVE_PARAM   { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set GPIO active level.");
+                                  ast_module_builder_set_pwm_active_level(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | PWM_FREQUENCY_PARAM { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set PWM frequency.");
-                                  ast_module_builder_set_pwm_frequency(yylineno, current_module_builder, $1);
+          | PWM_FREQUENCY_PARAM { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set PWM frequency.");
+                                  ast_module_builder_set_pwm_frequency(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
-          | PWM_DUTY_PARAM      { if(!current_module_builder)
-                                    log_error("PWM_PARAM", yylineno, "No current module builder to set PWM duty cycle.");
-                                  ast_module_builder_set_pwm_duty(yylineno, current_module_builder, $1);
+          | PWM_DUTY_PARAM      { if(!ctx->current_module_builder)
+                                    log_error("PWM_PARAM", yyget_lineno(scanner), "No current module builder to set PWM duty cycle.");
+                                  ast_module_builder_set_pwm_duty(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                 }
 
 UART_PARAMS: UART_PARAMS UART_PARAM END
             | UART_PARAM END
 
-UART_PARAM:  NAME_PARAM           { if(!current_module_builder)
-                                      log_error("UART_PARAM", yylineno, "No current module builder to set name.");
-                                    ast_module_builder_set_name(yylineno, current_module_builder, $1);
-                                    if($1)
-                                      free($1); // Free the in the lexer allocated string
-                                    else
-                                      log_error("UART_PARAM", yylineno, "UART_PARAM: Name parameter is NULL.");
+UART_PARAM:  NAME_PARAM           { if(!ctx->current_module_builder)
+                                      log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set name.");
+                                    ast_module_builder_set_name(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | ENABLE_PARAM        { if(!current_module_builder)
-                                      log_error("UART_PARAM", yylineno, "No current module builder to set enable.");
-                                    ast_module_builder_set_enable(yylineno, current_module_builder, $1);
+            | ENABLE_PARAM        { if(!ctx->current_module_builder)
+                                      log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set enable.");
+                                    ast_module_builder_set_enable(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | UART_PIN_TX_PARAM   { if(!current_module_builder)
-                                      log_error("UART_PARAM", yylineno, "No current module builder to set TX pin.");
-                                    ast_module_builder_set_uart_tx_pin(yylineno, current_module_builder, $1);
+            | UART_PIN_TX_PARAM   { if(!ctx->current_module_builder)
+                                      log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set TX pin.");
+                                    ast_module_builder_set_uart_tx_pin(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | UART_PIN_RX_PARAM   { if(!current_module_builder)
-                                      log_error("UART_PARAM", yylineno, "No current module builder to set RX pin.");
-                                    ast_module_builder_set_uart_rx_pin(yylineno, current_module_builder, $1);
+            | UART_PIN_RX_PARAM   { if(!ctx->current_module_builder)
+                                      log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set RX pin.");
+                                    ast_module_builder_set_uart_rx_pin(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | UART_BAUDRATE_PARAM { if(!current_module_builder)
-                                    log_error("UART_PARAM", yylineno, "No current module builder to set baudrate.");
-                                    ast_module_builder_set_uart_baudrate(yylineno, current_module_builder, $1);
+            | UART_BAUDRATE_PARAM { if(!ctx->current_module_builder)
+                                    log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set baudrate.");
+                                    ast_module_builder_set_uart_baudrate(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | UART_DATABITS_PARAM { if(!current_module_builder)
-                                    log_error("UART_PARAM", yylineno, "No current module builder to set databits.");
-                                    ast_module_builder_set_uart_databits(yylineno, current_module_builder, $1);
+            | UART_DATABITS_PARAM { if(!ctx->current_module_builder)
+                                    log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set databits.");
+                                    ast_module_builder_set_uart_databits(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | UART_STOPBITS_PARAM { if(!current_module_builder)
-                                    log_error("UART_PARAM", yylineno, "No current module builder to set stopbits.");
-                                    ast_module_builder_set_uart_stopbits(yylineno, current_module_builder, $1);
+            | UART_STOPBITS_PARAM { if(!ctx->current_module_builder)
+                                    log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set stopbits.");
+                                    ast_module_builder_set_uart_stopbits(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
-            | UART_PARITY_PARAM   { if(!current_module_builder)
-                                    log_error("UART_PARAM", yylineno, "No current module builder to set parity.");
-                                    ast_module_builder_set_uart_parity(yylineno, current_module_builder, $1);
+            | UART_PARITY_PARAM   { if(!ctx->current_module_builder)
+                                    log_error("UART_PARAM", yyget_lineno(scanner), "No current module builder to set parity.");
+                                    ast_module_builder_set_uart_parity(yyget_lineno(scanner), ctx->current_module_builder, $1);
                                   }
 
-NAME_PARAM: kw_name ':' val_name                    { $$ = $3;
-                                                      log_info("NAME_PARAM", LOG_PARSER_FOUND, yylineno, "Found name parameter with value '%s'", $3);
+NAME_PARAM: kw_name ':' val_name                    { $$ = arena_strndup(&ctx->arena, $3.text, $3.length); // Kept by the AST
+                                                      log_info("NAME_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found name parameter with value '%s'", $$);
                                                     }
 
 PIN_PARAM: kw_pin ':' val_pin                       { $$ = $3;
-                                                      char *pin_str = pin_to_string($3);
-                                                      log_info("PIN_PARAM", LOG_PARSER_FOUND, yylineno, "Found pin parameter with value '%s'", pin_str);
-                                                      free(pin_str);
+                                                      if(log_enabled(LOG_PARSER_FOUND)){ // Convert the pin to text only if it is logged
+                                                        char *pin_str = pin_to_string($3);
+                                                        log_info("PIN_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found pin parameter with value '%s'", pin_str);
+                                                        free(pin_str);
+                                                      }
                                                     }
 
 ENABLE_PARAM: kw_enable ':' val_bool                { $$ = $3;
-                                                      log_info("ENABLE_PARAM", LOG_PARSER_FOUND, yylineno, "Found enable parameter with value '%s'", bool_to_string($3));
+                                                      log_info("ENABLE_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found enable parameter with value '%s'", bool_to_string($3));
                                                     }
 
 GPIO_TYPE_PARAM: kw_gpio_type ':' val_gpio_type     { $$ = $3;
-                                                      log_info("GPIO_TYPE_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO type parameter with value '%s'", gpio_type_to_string($3));
+                                                      log_info("GPIO_TYPE_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO type parameter with value '%s'", gpio_type_to_string($3));
                                                     }
 
 GPIO_PULL_PARAM:  kw_gpio_pull ':' val_gpio_pull    { $$ = helper_to_gpio_pull($3);
-                                                      log_info("GPIO_PULL_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO pull parameter with value '%s'", gpio_pull_to_string($$));
+                                                      log_info("GPIO_PULL_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO pull parameter with value '%s'", gpio_pull_to_string($$));
                                                     }
                 | kw_gpio_pull ':' val_none         { $$ = GPIO_PULL_NONE;
-                                                      log_info("GPIO_PULL_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO pull parameter with value '%s'", gpio_pull_to_string($$));
+                                                      log_info("GPIO_PULL_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO pull parameter with value '%s'", gpio_pull_to_string($$));
                                                     }
 
 GPIO_SPEED_PARAM: kw_gpio_speed ':' val_gpio_speed  { $$ = helper_to_gpio_speed($3);
-                                                      log_info("GPIO_SPEED_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO speed parameter with value '%s'", gpio_speed_to_string($$));
+                                                      log_info("GPIO_SPEED_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO speed parameter with value '%s'", gpio_speed_to_string($$));
                                                     }
                 | kw_gpio_speed ':' val_level       { $$ = level_to_gpio_speed($3);
-                                                      log_info("GPIO_SPEED_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO speed parameter with value '%s'", gpio_speed_to_string($$));
+                                                      log_info("GPIO_SPEED_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO speed parameter with value '%s'", gpio_speed_to_string($$));
                                                     }
 
 GPIO_INIT_PARAM:  kw_gpio_init ':' val_gpio_init    { $$ = helper_to_gpio_init($3);
-                                                      log_info("GPIO_INIT_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO init parameter with value '%s'", gpio_init_to_string($$));
+                                                      log_info("GPIO_INIT_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO init parameter with value '%s'", gpio_init_to_string($$));
                                                     }
                 | kw_gpio_init ':' val_none         { $$ = GPIO_INIT_NONE;
-                                                      log_info("GPIO_INIT_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO init parameter with value '%s'", gpio_init_to_string($$));
+                                                      log_info("GPIO_INIT_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO init parameter with value '%s'", gpio_init_to_string($$));
                                                     }
 
 GPIO_ACTIVE_PARAM: kw_gpio_active ':' val_level     { $$ = $3;
-                                                      log_info("GPIO_ACTIVE_PARAM", LOG_PARSER_FOUND, yylineno, "Found GPIO active level parameter with value '%s'", level_to_string($$));
+                                                      log_info("GPIO_ACTIVE_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found GPIO active level parameter with value '%s'", level_to_string($$));
                                                     }
 
 PWM_FREQUENCY_PARAM: kw_pwm_frequency ':' val_nr    { $$ = $3;
-                                                      log_info("PWM_FREQUENCY_PARAM", LOG_PARSER_FOUND, yylineno, "Found PWM frequency parameter with value '%d'", $3);
+                                                      log_info("PWM_FREQUENCY_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found PWM frequency parameter with value '%d'", $3);
                                                     }
 
 PWM_DUTY_PARAM: kw_pwm_duty ':' val_nr              { $$ = $3;
-                                                      log_info("PWM_DUTY_PARAM", LOG_PARSER_FOUND, yylineno, "Found PWM duty cycle parameter with value '%d'", $3);
+                                                      log_info("PWM_DUTY_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found PWM duty cycle parameter with value '%d'", $3);
                                                     }
 
 UART_PIN_TX_PARAM: kw_tx_pin ':' val_pin            { $$ = $3;
-                                                      char *pin_str = pin_to_string($3);
-                                                      log_info("UART_PIN_TX_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART TX pin parameter with value '%s'", pin_str);
-                                                      free(pin_str);
+                                                      if(log_enabled(LOG_PARSER_FOUND)){ // Convert the pin to text only if it is logged
+                                                        char *pin_str = pin_to_string($3);
+                                                        log_info("UART_PIN_TX_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART TX pin parameter with value '%s'", pin_str);
+                                                        free(pin_str);
+                                                      }
                                                     }
 
 UART_PIN_RX_PARAM: kw_rx_pin ':' val_pin            { $$ = $3;
-                                                      char *pin_str = pin_to_string($3);
-                                                      log_info("UART_PIN_RX_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART RX pin parameter with value '%s'", pin_str);
-                                                      free(pin_str);
+                                                      if(log_enabled(LOG_PARSER_FOUND)){ // Convert the pin to text only if it is logged
+                                                        char *pin_str = pin_to_string($3);
+                                                        log_info("UART_PIN_RX_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART RX pin parameter with value '%s'", pin_str);
+                                                        free(pin_str);
+                                                      }
                                                     }
 
 UART_BAUDRATE_PARAM: kw_baudrate ':' val_nr         { $$ = $3;
-                                                      log_info("UART_BAUDRATE_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART baudrate parameter with value '%d'", $3);
+                                                      log_info("UART_BAUDRATE_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART baudrate parameter with value '%d'", $3);
                                                     }
 
 UART_DATABITS_PARAM: kw_databits ':' val_nr         { $$ = $3;
-                                                      log_info("UART_DATABITS_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART databits parameter with value '%d'", $3);
+                                                      log_info("UART_DATABITS_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART databits parameter with value '%d'", $3);
                                                     }
 
 UART_STOPBITS_PARAM:  kw_stopbits ':' val_nr                { $$ = (float)$3;
-                                                              log_info("UART_STOPBITS_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART stopbits parameter with value '%d' converted in float '%f'", $3, $$);
+                                                              log_info("UART_STOPBITS_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART stopbits parameter with value '%d' converted in float '%f'", $3, $$);
                                                             }
                     | kw_stopbits ':' val_uart_stopbit_1_5  { $$ = 1.5;
-                                                              log_info("UART_STOPBITS_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART stopbits parameter with value '1.5'");
+                                                              log_info("UART_STOPBITS_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART stopbits parameter with value '1.5'");
                                                             }
 
 UART_PARITY_PARAM:  kw_parity ':' val_uart_parity   { $$ = helper_to_uart_parity($3);
-                                                      log_info("UART_PARITY_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART parity parameter with value '%s'", uart_parity_to_string($$));
+                                                      log_info("UART_PARITY_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART parity parameter with value '%s'", uart_parity_to_string($$));
                                                     }
                   | kw_parity ':' val_none          { $$ = UART_PARITY_NONE;
-                                                      log_info("UART_PARITY_PARAM", LOG_PARSER_FOUND, yylineno, "Found UART parity parameter with value '%s'", uart_parity_to_string($$));
+                                                      log_info("UART_PARITY_PARAM", LOG_PARSER_FOUND, yyget_lineno(scanner), "Found UART parity parameter with value '%s'", uart_parity_to_string($$));
                                                     }
 
 END: ';'
@@ -495,79 +500,185 @@ END: ';'
   /*                  C functions                 */
   /* -------------------------------------------- */
 
-void yyerror(const char *msg){
-  printf("Error in line %d: %s\n", yylineno, msg);
+void yyerror(parser_context_t *ctx, void *scanner, const char *msg){
+  log_diagnostic(stdout, "Error in '%s' line %d: %s", ctx->code_file, yyget_lineno(scanner), msg);
 }
 
-int main(int argc, char *argv[]){
-  // Check for correct number of arguments (./AutoBSP <codefile> [<output_path>])
-  if(argc < 2 || argc > 3){
-    fprintf(stderr, "\nERROR 'main': Incorrect number of arguments.\n              Usage: %s <codefile_name> [<output_path>]\n", argv[0]);
-    return 1;
-  }
+/**
+ * @brief Runs the complete generator for one DSL file, optionally reusing the parser context of an earlier run.
+ * 
+ * @param code_file Path of the DSL file.
+ * @param output_path Path of the directory for all output files (must exist).
+ * @param options Options of the run (e.g. printing statistics or timings).
+ * @param reused_ctx Pointer to a parser context kept between runs (created if it points to NULL, reset and reused otherwise,
+ *                   freed by the caller with parser_free_context), or NULL to create and free a context only for this run.
+ * @return 0 on success (also if the output was already up to date), 1 if the file could not be opened or an error was reported.
+ * 
+ * @note If the output directory holds the complete output of the same input and generator version (see regenCache.c),
+ *       the run ends after hashing the input, unless options->force is set.
+ * @note Only the artifacts selected in options->emit are generated and written (the checks are always performed).
+ * @note A .bspir file (see bspIr.h) is loaded instead of parsed: the bound AST is taken as stored,
+ *       so parsing, checking, sorting and binding are skipped.
+ * @note Errors do not exit the program but end only this run, so it can be used from several threads at the same time.
+ * @note All builders, AST nodes and names are allocated from the arena of the context and released with it at once
+ *       (or with the reset before the next run that reuses the context, which keeps the memory).
+ */
+int generate_bsp_in_context(const char *code_file, const char *output_path, const generator_options_t *options, parser_context_t **reused_ctx){
+  // Measure the wall time of each phase
+  run_stats_t stats;
+  run_stats_init(&stats);
+  run_stats_begin_phase(&stats, RUN_PHASE_LOAD_INPUT);
   
-  // Get the program file path
-  char *code_file = argv[1];
-  FILE *input = fopen(code_file, "r");
-  if(!input){
-    fprintf(stderr, "\nERROR 'main': Error opening code file '%s'\n", code_file);
+  // Load the complete DSL file at once (memory-mapped if possible), the scanner works directly on this buffer
+  input_buffer_t input;
+  if(!input_buffer_load(&input, code_file, !options->read_input)){
+    fprintf(stderr, "\nERROR 'generate_bsp': Error opening code file '%s'\n", code_file);
     return 1;
   }
-  yyin = input;
-  
-  // Determine path for all output files
-  char *output_path;
-  if(argc == 3) // Use provided output path
-    output_path = argv[2];
-  else // Default to "output" directory
-    output_path = "output";
-  
-  // Initialize logging
-  init_logging(output_path);
   
-  // Parse the input code
-  log_info("START", LOG_OTHER, 0, "Start parsing the DSL code in '%s'", code_file);
-  int ret_parse = yyparse();
-  log_info("END", LOG_OTHER, 0, "Finished parsing the DSL code");
+  // Skip the run if the output directory is up to date with the input (nothing is parsed or written then)
+  uint64_t input_hash = regen_cache_hash_input(input.data, input.length);
+  if(!options->force && regen_cache_is_up_to_date(output_path, input_hash, options->emit)){
+    parser_print_up_to_date(code_file, output_path, options);
+    input_buffer_release(&input);
+    return 0;
+  }
   
-  if(ret_parse != 0)
-    log_error("main", 0, "Parsing failed with error code %d", ret_parse);
+  // Every reported error jumps back here instead of exiting the program (ctx is volatile, it is set after setjmp)
+  parser_context_t *volatile ctx = NULL;
+  jmp_buf error_jump;
+  if(setjmp(error_jump) != 0){
+    log_set_error_jump(NULL);
+    if(ctx != NULL && reused_ctx == NULL)
+      parser_free_context(ctx);
+    input_buffer_release(&input);
+    return 1;
+  }
+  log_set_error_jump(&error_jump);
   
-  if(dsl_builder == NULL)
-    log_error("main", 0, "Failed to generate DSL builder from parsed code.");
+  // Initialize logging (without a log file if it is not selected) and remove the cache file before any artifact changes
+  init_logging((options->emit & EMIT_LOG) ? output_path : NULL);
+  regen_cache_invalidate(output_path);
   
-  // Check for required parameters in the DSL builder
-  log_info("main", LOG_OTHER, 0, "Performing DSL builder checks for required parameters");
-  ast_check_required_params(dsl_builder);
+  // Create the context of this run (owns the scanner, the arena with builders and AST, and the node counter) or reuse the given one
+  if(reused_ctx != NULL && *reused_ctx != NULL){
+    ctx = *reused_ctx;
+    parser_reset_context(ctx, code_file, &input, &stats);
+  } else{
+    ctx = parser_new_context(code_file, &input, &stats);
+    if(reused_ctx != NULL)
+      *reused_ctx = ctx;
+  }
   
-  // Build the AST from the DSL builder (and also frees the builders)
-  log_info("main", LOG_OTHER, 0, "Building the AST from the DSL builder");
-  ast_dsl_node_t* ast_root = ast_convert_dsl_builder_to_dsl_node(dsl_builder);
+  ast_dsl_node_t* ast_root;
+  uint64_t source_hash = input_hash;
+  if(bsp_ir_is_ir(input.data, input.length)){
+    // Load the bound AST of a .bspir file (checked and bound by the run that wrote it)
+    log_info("generate_bsp", LOG_OTHER, 0, "Loading the bound AST from the IR file '%s'", code_file);
+    run_stats_begin_phase(&stats, RUN_PHASE_BUILD_AST);
+    ast_root = bsp_ir_load(&ctx->arena, input.data, input.length);
+    source_hash = ((const bsp_ir_header_t*)input.data)->source_hash; // Keep the origin if the IR is written again
+    
+    log_info("generate_bsp", LOG_OTHER, 0, "Indexing the enabled modules for code generation");
+    run_stats_begin_phase(&stats, RUN_PHASE_INDEX);
+    ast_index_enabled_modules(&ctx->arena, ast_root);
+  } else{
+    // Parse the input code
+    log_info("START", LOG_OTHER, 0, "Start parsing the DSL code in '%s'", code_file);
+    run_stats_begin_phase(&stats, RUN_PHASE_PARSE);
+    int ret_parse = yyparse(ctx, ctx->scanner);
+    log_info("END", LOG_OTHER, 0, "Finished parsing the DSL code");
+    
+    if(ret_parse != 0)
+      log_error("generate_bsp", 0, "Parsing failed with error code %d", ret_parse);
+    
+    if(ctx->dsl_builder == NULL)
+      log_error("generate_bsp", 0, "Failed to generate DSL builder from parsed code.");
+    
+    // Check for required parameters in the DSL builder
+    log_info("generate_bsp", LOG_OTHER, 0, "Performing DSL builder checks for required parameters");
+    run_stats_begin_phase(&stats, RUN_PHASE_CHECK_REQUIRED);
+    ast_check_required_params(ctx->dsl_builder);
+    
+    // Build the AST from the DSL builder (the builders are released with the arena)
+    log_info("generate_bsp", LOG_OTHER, 0, "Building the AST from the DSL builder");
+    run_stats_begin_phase(&stats, RUN_PHASE_BUILD_AST);
+    ast_root = ast_convert_dsl_builder_to_dsl_node(&ctx->arena, ctx->dsl_builder);
+    ctx->dsl_builder = NULL;
+    
+    // Check the AST datastructure
+    log_info("generate_bsp", LOG_OTHER, 0, "Performing AST checks for the datastructure");
+    run_stats_begin_phase(&stats, RUN_PHASE_CHECK_AST);
+    ast_check_all_enabled_modules(ast_root);
+    
+    // Sort modules by pin number for better readability
+    log_info("generate_bsp", LOG_OTHER, 0, "Sorting modules by pin number for better readability");
+    run_stats_begin_phase(&stats, RUN_PHASE_SORT);
+    ast_sort_modules_by_pin(ast_root);
+    
+    // Index the enabled modules per kind for the code generators (order is final now)
+    log_info("generate_bsp", LOG_OTHER, 0, "Indexing the enabled modules for code generation");
+    run_stats_begin_phase(&stats, RUN_PHASE_INDEX);
+    ast_index_enabled_modules(&ctx->arena, ast_root);
+    
+    // Bind backend specific parameters
+    log_info("generate_bsp", LOG_OTHER, 0, "Binding backend specific parameters to the AST");
+    run_stats_begin_phase(&stats, RUN_PHASE_BIND);
+    ast_bind_backend_specific_params(ast_root);
+  }
+  for(ast_module_node_t *module = ast_root->modules_root; module != NULL; module = module->next)
+    stats.modules++;
+  stats.enabled_modules = ast_root->enabled_modules.count;
   
-  // Check the AST datastructure
-  log_info("main", LOG_OTHER, 0, "Performing AST checks for the datastructure");
-  ast_check_all_enabled_modules(ast_root);
+  // Serialize the bound AST (only if selected with --emit=ir)
+  if(options->emit & EMIT_IR){
+    log_info("generate_bsp", LOG_OTHER, 0, "Writing the bound AST to the IR file");
+    run_stats_begin_phase(&stats, RUN_PHASE_PRINT);
+    bsp_ir_write(output_path, ast_root, source_hash, &ctx->print_emitter);
+  }
   
-  // Sort modules by pin number for better readability
-  log_info("main", LOG_OTHER, 0, "Sorting modules by pin number for better readability");
-  ast_sort_modules_by_pin(ast_root);
+  // Print the generated AST (only the DOT files and scripts selected with --emit=)
+  if(options->emit & (EMIT_DOT | EMIT_SCRIPTS)){
+    log_info("generate_bsp", LOG_OTHER, 0, "Printing the generated AST to DOT and PNG files");
+    run_stats_begin_phase(&stats, RUN_PHASE_PRINT);
+    ast_print(output_path, ast_root, &ctx->print_emitter, options->emit);
+  }
   
-  // Bind backend specific parameters
-  log_info("main", LOG_OTHER, 0, "Binding backend specific parameters to the AST");
-  ast_bind_backend_specific_params(ast_root);
+  // Generate code from the AST (only the files selected with --emit=)
+  if(options->emit & (EMIT_HEADER | EMIT_SOURCE)){
+    log_info("generate_bsp", LOG_OTHER, 0, "Generating code from the AST");
+    run_stats_begin_phase(&stats, RUN_PHASE_GENERATE);
+    ast_generate_code(output_path, ast_root, &ctx->header_emitter, &ctx->source_emitter, options->emit);
+  }
+  run_stats_end_phase(&stats);
   
-  // Print the generated AST
-  log_info("main", LOG_OTHER, 0, "Printing the generated AST to DOT and PNG files");
-  ast_print(output_path, ast_root);
+  // Record the input hash, so the next run with the same input and selection can be skipped
+  if(!regen_cache_store(output_path, input_hash, options->emit, &ctx->print_emitter))
+    log_info("generate_bsp", LOG_OTHER, 0, "Could not write the regeneration cache '%s/%s'", output_path, REGEN_CACHE_FILE_NAME);
   
-  // Generate code from the AST
-  log_info("main", LOG_OTHER, 0, "Generating code from the AST");
-  ast_generate_code(output_path, ast_root);
+  // Print the statistics, timings and counters selected by the options
+  parser_print_report(ctx, ast_root, options);
   
-  // Clean up
-  ast_free_dsl_node(ast_root);
+  // Clean up (releases the whole AST with the arena of the context, a reused context is only reset by the next run)
+  log_set_error_jump(NULL);
+  if(reused_ctx == NULL)
+    parser_free_context(ctx);
   close_logging();
-  fclose(input);
+  input_buffer_release(&input);
   
   return 0;
 }
+
+/**
+ * @brief Runs the complete generator (parse, check, bind, print, generate) for one DSL file.
+ * 
+ * @param code_file Path of the DSL file.
+ * @param output_path Path of the directory for all output files (must exist).
+ * @param options Options of the run (e.g. printing statistics or timings).
+ * @return 0 on success (also if the output was already up to date), 1 if the file could not be opened or an error was reported.
+ * 
+ * @note Creates its own parser context and frees it at the end (see generate_bsp_in_context).
+ */
+int generate_bsp(const char *code_file, const char *output_path, const generator_options_t *options){
+  return generate_bsp_in_context(code_file, output_path, options, NULL);
+}
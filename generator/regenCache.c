@@ -0,0 +1,225 @@
+#include "regenCache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "generatorOptions.h"
+#include "astCheckSTM32F446RE.h"
+
+#define REGEN_CACHE_FNV_OFFSET  0xcbf29ce484222325ULL // FNV-1a 64 bit offset basis
+#define REGEN_CACHE_FNV_PRIME   0x00000100000001b3ULL // FNV-1a 64 bit prime
+
+/**
+ * @brief Structure describing a file written by a run (ast_print and ast_generate_code) and the --emit= selection it belongs to.
+ */
+typedef struct{
+  const char   *name;
+  unsigned int  emit;
+} regen_cache_artifact_t;
+
+// Settings chosen at compile time that change the generated code (part of the cache key next to the generator version)
+static const uint32_t regen_cache_build_settings[] = {
+  STM32F446RE_UART_MAX_ERROR_PPM
+};
+
+// Files written by a complete run, all selected ones must be present for a cache hit
+static const regen_cache_artifact_t regen_cache_artifacts[] = {
+  { "removePNGandDOT.sh",        EMIT_SCRIPTS },
+  { "ast_graph_complete.gv",     EMIT_DOT },
+  { "ast_graph_enabled_only.gv", EMIT_DOT },
+  { "createPNGfromDOT.sh",       EMIT_SCRIPTS },
+  { "generated_bsp.h",           EMIT_HEADER },
+  { "generated_bsp.c",           EMIT_SOURCE },
+  { "generated_bsp.bspir",       EMIT_IR }
+};
+#define REGEN_CACHE_ARTIFACT_COUNT (sizeof(regen_cache_artifacts) / sizeof(regen_cache_artifacts[0]))
+
+static uint64_t fnv1a_update(uint64_t hash, const unsigned char *data, size_t length);
+static bool artifact_size(const char *output_path, const char *artifact, long long *size);
+static int find_artifact(const char *artifact);
+
+
+/* -------------------------------------------- */
+/*                Input hashing                 */
+/* -------------------------------------------- */
+
+/**
+ * @brief Computes the cache key of a DSL file: a hash over the generator version, the compile time settings of the
+ *        generator (regen_cache_build_settings) and the complete file content.
+ * 
+ * @param content Content of the DSL file.
+ * @param length Length of the content in bytes.
+ * @return The hash of the generator version, the settings and the content.
+ * 
+ * @note The controller is declared inside the DSL file, so it is part of the hashed content.
+ */
+uint64_t regen_cache_hash_input(const char *content, size_t length){
+  // Hash the version including its terminating null character (separates it from the content)
+  uint64_t hash = fnv1a_update(REGEN_CACHE_FNV_OFFSET, (const unsigned char*)AUTOBSP_GENERATOR_VERSION, sizeof(AUTOBSP_GENERATOR_VERSION));
+  hash = fnv1a_update(hash, (const unsigned char*)regen_cache_build_settings, sizeof(regen_cache_build_settings));
+  return fnv1a_update(hash, (const unsigned char*)content, length);
+}
+
+/**
+ * @brief Adds data to a FNV-1a 64 bit hash.
+ * 
+ * @param hash Current hash value.
+ * @param data Data to add.
+ * @param length Number of bytes to add.
+ * @return The updated hash value.
+ */
+static uint64_t fnv1a_update(uint64_t hash, const unsigned char *data, size_t length){
+  for(size_t i = 0; i < length; i++){
+    hash ^= data[i];
+    hash *= REGEN_CACHE_FNV_PRIME;
+  }
+  return hash;
+}
+
+
+/* -------------------------------------------- */
+/*                  Cache file                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Checks if the output directory holds the complete output of a run with the same cache key.
+ * 
+ * The cache file must have the current generator version and the input hash, and every artifact listed
+ * in it must still exist with the recorded size. All selected artifacts have to be listed, so a run that
+ * selects more artifacts than the run that wrote the cache file is not skipped.
+ * 
+ * @param output_path Path of the output directory.
+ * @param input_hash Hash of the DSL file (see regen_cache_hash_input).
+ * @param emit Artifacts selected for the run (see EMIT_* in generatorOptions.h).
+ * @return true if the run can be skipped, false otherwise (also if there is no or an invalid cache file).
+ * 
+ * @note Only reads the cache file and stats the artifacts, does not log (logging is not initialized yet).
+ */
+bool regen_cache_is_up_to_date(const char *output_path, uint64_t input_hash, unsigned int emit){
+  char cache_path[256];
+  snprintf(cache_path, sizeof(cache_path), "%s/%s", output_path, REGEN_CACHE_FILE_NAME);
+  
+  FILE *cache = fopen(cache_path, "r");
+  if(cache == NULL)
+    return false;
+  
+  bool version_matches = false;
+  bool hash_matches = false;
+  bool artifacts_valid = true;
+  bool artifact_seen[REGEN_CACHE_ARTIFACT_COUNT] = { false };
+  
+  char line[512];
+  while(fgets(line, sizeof(line), cache) != NULL && artifacts_valid){
+    char name[256];
+    uint64_t hash;
+    long long size;
+    long long actual_size;
+    
+    if(line[0] == '#')
+      continue;
+    else if(strncmp(line, "version ", 8) == 0)
+      version_matches = (strcmp(line + 8, AUTOBSP_GENERATOR_VERSION "\n") == 0);
+    else if(sscanf(line, "input_hash %" SCNx64, &hash) == 1)
+      hash_matches = (hash == input_hash);
+    else if(sscanf(line, "artifact %255s %lld", name, &size) == 2){
+      int index = find_artifact(name);
+      if(index < 0 || !artifact_size(output_path, name, &actual_size) || actual_size != size)
+        artifacts_valid = false;
+      else
+        artifact_seen[index] = true;
+    }
+    else
+      artifacts_valid = false; // Unknown line, written by another version
+  }
+  fclose(cache);
+  
+  for(size_t i = 0; i < REGEN_CACHE_ARTIFACT_COUNT; i++)
+    if((regen_cache_artifacts[i].emit & emit) && !artifact_seen[i])
+      artifacts_valid = false;
+  
+  return version_matches && hash_matches && artifacts_valid;
+}
+
+/**
+ * @brief Removes the cache file from the output directory.
+ * 
+ * @param output_path Path of the output directory.
+ * 
+ * @note Called before a run changes any artifact, so a failed run never leaves a cache file that matches partial output.
+ */
+void regen_cache_invalidate(const char *output_path){
+  char cache_path[256];
+  snprintf(cache_path, sizeof(cache_path), "%s/%s", output_path, REGEN_CACHE_FILE_NAME);
+  unlink(cache_path);
+}
+
+/**
+ * @brief Writes the cache file for a successful run, listing the generator version, the input hash and the size of every artifact written.
+ * 
+ * @param output_path Path of the output directory (must contain all selected artifacts).
+ * @param input_hash Hash of the DSL file (see regen_cache_hash_input).
+ * @param emit Artifacts selected for the run (see EMIT_* in generatorOptions.h), only these are listed.
+ * @param output Emitter used as buffer for the cache file (cleared before use).
+ * @return true if the cache file was written, false if an artifact is missing or the file could not be written.
+ */
+bool regen_cache_store(const char *output_path, uint64_t input_hash, unsigned int emit, emitter_t *output){
+  emitter_clear(output);
+  emitter_append(output, "# AutoBSP regeneration cache (delete or run with --force to regenerate)\n");
+  emitter_printf(output, "version %s\n", AUTOBSP_GENERATOR_VERSION);
+  emitter_printf(output, "input_hash %016" PRIx64 "\n", input_hash);
+  
+  for(size_t i = 0; i < REGEN_CACHE_ARTIFACT_COUNT; i++){
+    if(!(regen_cache_artifacts[i].emit & emit))
+      continue; // Not written by this run (a file left by an earlier run may be outdated)
+    long long size;
+    if(!artifact_size(output_path, regen_cache_artifacts[i].name, &size))
+      return false;
+    emitter_printf(output, "artifact %s %lld\n", regen_cache_artifacts[i].name, size);
+  }
+  
+  char cache_path[256];
+  snprintf(cache_path, sizeof(cache_path), "%s/%s", output_path, REGEN_CACHE_FILE_NAME);
+  return emitter_write_file(output, cache_path) != EMITTER_WRITE_FAILED;
+}
+
+
+/* -------------------------------------------- */
+/*                   Artifacts                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Gets the size of an artifact in the output directory.
+ * 
+ * @param output_path Path of the output directory.
+ * @param artifact File name of the artifact.
+ * @param size Pointer to store the size in bytes in.
+ * @return true if the artifact exists as a regular file, false otherwise.
+ */
+static bool artifact_size(const char *output_path, const char *artifact, long long *size){
+  char artifact_path[512];
+  snprintf(artifact_path, sizeof(artifact_path), "%s/%s", output_path, artifact);
+  
+  struct stat file_stat;
+  if(stat(artifact_path, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+    return false;
+  
+  *size = (long long)file_stat.st_size;
+  return true;
+}
+
+/**
+ * @brief Finds an artifact in the list of artifacts of a run.
+ * 
+ * @param artifact File name of the artifact.
+ * @return Index in regen_cache_artifacts, or -1 if it is not an artifact.
+ */
+static int find_artifact(const char *artifact){
+  for(size_t i = 0; i < REGEN_CACHE_ARTIFACT_COUNT; i++)
+    if(strcmp(regen_cache_artifacts[i].name, artifact) == 0)
+      return (int)i;
+  return -1;
+}
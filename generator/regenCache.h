@@ -0,0 +1,17 @@
+#ifndef __REGEN_CACHE_H__
+#define __REGEN_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "emitter.h"
+
+#define REGEN_CACHE_FILE_NAME "AutoBSP.cache" // Cache file in the output directory
+
+uint64_t regen_cache_hash_input(const char *content, size_t length);
+bool regen_cache_is_up_to_date(const char *output_path, uint64_t input_hash, unsigned int emit);
+void regen_cache_invalidate(const char *output_path);
+bool regen_cache_store(const char *output_path, uint64_t input_hash, unsigned int emit, emitter_t *output);
+
+#endif //__REGEN_CACHE_H__
@@ -0,0 +1,135 @@
+#include "runStats.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#include "logging.h"
+
+static const char *const run_phase_names[RUN_PHASE_COUNT] = {
+  "load_input",
+  "parse",
+  "check_required",
+  "build_ast",
+  "check_ast",
+  "sort",
+  "index",
+  "bind",
+  "print",
+  "generate"
+};
+
+
+/* -------------------------------------------- */
+/*                Phase timing                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Initializes the statistics of a run (all times and counters zero, no phase measured).
+ * 
+ * @param stats Pointer to the statistics.
+ */
+void run_stats_init(run_stats_t *stats){
+  if(stats == NULL)
+    log_error("run_stats_init", 0, "Run statistics are NULL.");
+  
+  for(int i = 0; i < RUN_PHASE_COUNT; i++)
+    stats->phase_ms[i] = 0.0;
+  stats->phase_start_ms  = 0.0;
+  stats->current_phase   = RUN_PHASE_COUNT;
+  stats->tokens_lexed    = 0;
+  stats->modules         = 0;
+  stats->enabled_modules = 0;
+}
+
+/**
+ * @brief Starts measuring a phase, the phase measured before is ended.
+ * 
+ * @param stats Pointer to the statistics.
+ * @param phase Phase to measure.
+ * 
+ * @note The time is added to the phase, so a phase can be measured in several parts.
+ */
+void run_stats_begin_phase(run_stats_t *stats, run_phase_t phase){
+  if(stats == NULL)
+    log_error("run_stats_begin_phase", 0, "Run statistics are NULL.");
+  if(phase >= RUN_PHASE_COUNT)
+    log_error("run_stats_begin_phase", 0, "Invalid run phase '%d'.", phase);
+  
+  double now = run_stats_now_ms();
+  if(stats->current_phase < RUN_PHASE_COUNT)
+    stats->phase_ms[stats->current_phase] += now - stats->phase_start_ms;
+  
+  stats->current_phase  = phase;
+  stats->phase_start_ms = now;
+}
+
+/**
+ * @brief Ends measuring the current phase (does nothing if no phase is measured).
+ * 
+ * @param stats Pointer to the statistics.
+ */
+void run_stats_end_phase(run_stats_t *stats){
+  if(stats == NULL)
+    log_error("run_stats_end_phase", 0, "Run statistics are NULL.");
+  
+  if(stats->current_phase < RUN_PHASE_COUNT)
+    stats->phase_ms[stats->current_phase] += run_stats_now_ms() - stats->phase_start_ms;
+  stats->current_phase = RUN_PHASE_COUNT;
+}
+
+/**
+ * @brief Returns the current time of the monotonic clock in milliseconds.
+ */
+double run_stats_now_ms(){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1.0e6;
+}
+
+/**
+ * @brief Returns the sum of the wall times of all phases in milliseconds.
+ * 
+ * @param stats Pointer to the statistics.
+ */
+double run_stats_total_ms(const run_stats_t *stats){
+  double total = 0.0;
+  for(int i = 0; i < RUN_PHASE_COUNT; i++)
+    total += stats->phase_ms[i];
+  return total;
+}
+
+/**
+ * @brief Returns the name of a phase as used in the reports (e.g. "parse").
+ * 
+ * @param phase Phase of a run.
+ * @return Name of the phase, "unknown" for invalid values.
+ */
+const char* run_phase_to_string(run_phase_t phase){
+  if(phase >= RUN_PHASE_COUNT)
+    return "unknown";
+  return run_phase_names[phase];
+}
+
+
+/* -------------------------------------------- */
+/*                 JSON output                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Appends a string as JSON string literal (with quotes, escaped) to an emitter.
+ * 
+ * @param output Emitter to append to.
+ * @param text Null-terminated string (e.g. a file path).
+ */
+void run_stats_append_json_string(emitter_t *output, const char *text){
+  emitter_append(output, "\"");
+  for(const unsigned char *c = (const unsigned char*)text; *c != '\0'; c++){
+    if(*c == '"' || *c == '\\')
+      emitter_printf(output, "\\%c", *c);
+    else if(*c < 0x20)
+      emitter_printf(output, "\\u%04x", *c);
+    else
+      emitter_append_n(output, (const char*)c, 1);
+  }
+  emitter_append(output, "\"");
+}
@@ -0,0 +1,52 @@
+#ifndef __RUN_STATS_H__
+#define __RUN_STATS_H__
+
+#include <stddef.h>
+
+#include "emitter.h"
+
+/**
+ * @brief Phases of one generator run, in execution order.
+ */
+typedef enum{
+  RUN_PHASE_LOAD_INPUT,      // Loading and hashing the DSL file, checking the regeneration cache
+  RUN_PHASE_PARSE,           // yyparse (includes lexing)
+  RUN_PHASE_CHECK_REQUIRED,  // ast_check_required_params
+  RUN_PHASE_BUILD_AST,       // ast_convert_dsl_builder_to_dsl_node (or bsp_ir_load for a .bspir file)
+  RUN_PHASE_CHECK_AST,       // ast_check_all_enabled_modules
+  RUN_PHASE_SORT,            // ast_sort_modules_by_pin
+  RUN_PHASE_INDEX,           // ast_index_enabled_modules
+  RUN_PHASE_BIND,            // ast_bind_backend_specific_params
+  RUN_PHASE_PRINT,           // ast_print and bsp_ir_write
+  RUN_PHASE_GENERATE,        // ast_generate_code
+  RUN_PHASE_COUNT
+} run_phase_t;
+
+/**
+ * @brief Structure holding the wall time of each phase and the counters of one generator run.
+ * 
+ * Consists of the duration of each phase, the start of the phase currently measured, and counters
+ * filled by the scanner (tokens) and the generator (modules).
+ * 
+ * @note The allocation and emitted byte counters are taken from the arena and the emitters of the run when reporting.
+ */
+typedef struct{
+  double       phase_ms[RUN_PHASE_COUNT];  // Wall time of each phase (monotonic clock)
+  double       phase_start_ms;             // Start of the phase currently measured
+  run_phase_t  current_phase;              // Phase currently measured (RUN_PHASE_COUNT = none)
+  size_t       tokens_lexed;               // Tokens returned by the scanner
+  size_t       modules;                    // Module nodes in the AST
+  size_t       enabled_modules;            // Enabled module nodes in the AST
+} run_stats_t;
+
+void run_stats_init(run_stats_t *stats);
+void run_stats_begin_phase(run_stats_t *stats, run_phase_t phase);
+void run_stats_end_phase(run_stats_t *stats);
+
+double run_stats_now_ms();
+double run_stats_total_ms(const run_stats_t *stats);
+const char* run_phase_to_string(run_phase_t phase);
+
+void run_stats_append_json_string(emitter_t *output, const char *text);
+
+#endif //__RUN_STATS_H__
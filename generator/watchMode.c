@@ -0,0 +1,216 @@
+#include "watchMode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+
+#include "runStats.h"
+
+#define WATCH_SETTLE_MS          50  // Quiet time after the last change before regenerating (editors save in several steps)
+#define WATCH_EVENT_BUFFER_SIZE  (64 * (sizeof(struct inotify_event) + NAME_MAX + 1))
+
+// Set by SIGINT and SIGTERM, ends the watch loop after the current run
+static volatile sig_atomic_t watch_stop_requested = 0;
+
+static void watch_handle_signal(int signal_number);
+static bool watch_split_path(const char *code_file, char *directory, size_t directory_size, const char **file_name);
+static int watch_wait_for_change(int inotify_fd, const char *file_name);
+static void watch_run(const char *code_file, const char *output_path, watch_run_fn_t run, const generator_options_t *options,
+                      parser_context_t **reused_ctx);
+
+
+/* -------------------------------------------- */
+/*                  Watch mode                  */
+/* -------------------------------------------- */
+
+/**
+ * @brief Runs the generator for a DSL file and then again every time the file changes, until SIGINT or SIGTERM.
+ * 
+ * @param code_file Path of the DSL file.
+ * @param output_path Path of the directory for all output files (must exist).
+ * @param run Function running the generator for the DSL file.
+ * @param options Options passed to every run.
+ * @return 0 if the watch was stopped by a signal, 1 if the file could not be watched.
+ * 
+ * @note The directory of the file is watched (inotify), so the file is also found again after an editor replaced it
+ *       (write to a temporary file and rename). Changes within WATCH_SETTLE_MS are combined into one run.
+ * @note All runs share one parser context, so the arena block and the emitter buffers are allocated only once.
+ * @note A change that leaves the content the same ends the run after hashing the input (regeneration cache),
+ *       and generated files with unchanged content are not rewritten.
+ */
+int watch_main(const char *code_file, const char *output_path, watch_run_fn_t run, const generator_options_t *options){
+  char directory[PATH_MAX];
+  const char *file_name;
+  if(!watch_split_path(code_file, directory, sizeof(directory), &file_name)){
+    fprintf(stderr, "\nERROR 'watch_main': Invalid code file path '%s'.\n", code_file);
+    return 1;
+  }
+  
+  int inotify_fd = inotify_init1(IN_CLOEXEC);
+  if(inotify_fd < 0){
+    fprintf(stderr, "\nERROR 'watch_main': Could not initialize inotify: %s\n", strerror(errno));
+    return 1;
+  }
+  if(inotify_add_watch(inotify_fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0){
+    fprintf(stderr, "\nERROR 'watch_main': Could not watch directory '%s': %s\n", directory, strerror(errno));
+    close(inotify_fd);
+    return 1;
+  }
+  
+  // Stop on Ctrl+C or kill (without SA_RESTART, so a waiting poll returns)
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = watch_handle_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  
+  printf("Watching '%s' (output '%s'), press Ctrl+C to stop\n", code_file, output_path);
+  fflush(stdout);
+  
+  // Read the file in every run instead of mapping it: an editor or a shell redirect may truncate and rewrite the file
+  // in place during a run, and accessing a mapped page behind the new end of the file would raise SIGBUS
+  generator_options_t watch_options = *options;
+  watch_options.read_input = true;
+  options = &watch_options;
+  
+  parser_context_t *ctx = NULL;
+  watch_run(code_file, output_path, run, options, &ctx);
+  
+  int result = 0;
+  while(!watch_stop_requested){
+    int change = watch_wait_for_change(inotify_fd, file_name);
+    if(change < 0){
+      fprintf(stderr, "\nERROR 'watch_main': Watching directory '%s' failed: %s\n", directory,
+              (errno != 0) ? strerror(errno) : "directory was removed");
+      result = 1;
+      break;
+    }
+    if(change > 0)
+      watch_run(code_file, output_path, run, options, &ctx);
+  }
+  
+  parser_free_context(ctx);
+  close(inotify_fd);
+  printf("Stopped watching '%s'\n", code_file);
+  return result;
+}
+
+/**
+ * @brief Runs the generator once and prints the time, the result and the duration of the run.
+ * 
+ * @param code_file Path of the DSL file.
+ * @param output_path Path of the directory for all output files.
+ * @param run Function running the generator for the DSL file.
+ * @param options Options passed to the run.
+ * @param reused_ctx Parser context shared by all runs.
+ */
+static void watch_run(const char *code_file, const char *output_path, watch_run_fn_t run, const generator_options_t *options,
+                      parser_context_t **reused_ctx){
+  double start_ms = run_stats_now_ms();
+  int result = run(code_file, output_path, options, reused_ctx);
+  double duration_ms = run_stats_now_ms() - start_ms;
+  
+  char time_text[16] = "--:--:--";
+  time_t now = time(NULL);
+  struct tm local_time;
+  if(localtime_r(&now, &local_time) != NULL)
+    strftime(time_text, sizeof(time_text), "%H:%M:%S", &local_time);
+  
+  printf("[%s] %s  %s -> %s (%.2f ms)\n", time_text, (result == 0) ? "OK  " : "FAIL", code_file, output_path, duration_ms);
+  fflush(stdout);
+}
+
+/**
+ * @brief Waits until the watched file changed and no further change followed for WATCH_SETTLE_MS.
+ * 
+ * @param inotify_fd Inotify instance watching the directory of the file.
+ * @param file_name Name of the file inside the watched directory.
+ * @return 1 if the file changed, 0 if a stop was requested, -1 on errors (errno is 0 if the directory was removed).
+ * 
+ * @note Events of other files in the directory are ignored, an event queue overflow counts as change.
+ */
+static int watch_wait_for_change(int inotify_fd, const char *file_name){
+  char buffer[WATCH_EVENT_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool changed = false;
+  
+  while(!watch_stop_requested){
+    struct pollfd poll_fd = { .fd = inotify_fd, .events = POLLIN, .revents = 0 };
+    int ready = poll(&poll_fd, 1, changed ? WATCH_SETTLE_MS : -1);
+    if(ready < 0){
+      if(errno == EINTR)
+        continue;
+      return -1;
+    }
+    if(ready == 0)
+      return 1; // Changed and settled
+    
+    ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+    if(length < 0){
+      if(errno == EINTR)
+        continue;
+      return -1;
+    }
+    
+    for(char *position = buffer; position < buffer + length; ){
+      const struct inotify_event *event = (const struct inotify_event*)position;
+      if(event->mask & IN_IGNORED){
+        errno = 0;
+        return -1;
+      }
+      if((event->mask & IN_Q_OVERFLOW) || (event->len > 0 && strcmp(event->name, file_name) == 0))
+        changed = true;
+      position += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  return 0;
+}
+
+
+/* -------------------------------------------- */
+/*               Helper functions               */
+/* -------------------------------------------- */
+
+/**
+ * @brief Signal handler for SIGINT and SIGTERM, requests the end of the watch loop.
+ */
+static void watch_handle_signal(int signal_number){
+  (void)signal_number;
+  watch_stop_requested = 1;
+}
+
+/**
+ * @brief Splits the path of the DSL file into its directory and its file name.
+ * 
+ * @param code_file Path of the DSL file.
+ * @param directory Buffer to store the directory in ("." if the path has no directory).
+ * @param directory_size Size of the buffer.
+ * @param file_name Pointer to store the file name in (points into code_file).
+ * @return true on success, false if the path ends with '/' or the directory does not fit into the buffer.
+ */
+static bool watch_split_path(const char *code_file, char *directory, size_t directory_size, const char **file_name){
+  const char *slash = strrchr(code_file, '/');
+  if(slash == NULL){
+    *file_name = code_file;
+    return snprintf(directory, directory_size, ".") < (int)directory_size;
+  }
+  
+  *file_name = slash + 1;
+  if(**file_name == '\0')
+    return false;
+  
+  size_t length = (slash == code_file) ? 1 : (size_t)(slash - code_file); // Keep "/" for files in the root directory
+  if(length >= directory_size)
+    return false;
+  memcpy(directory, code_file, length);
+  directory[length] = '\0';
+  return true;
+}
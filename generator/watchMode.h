@@ -0,0 +1,16 @@
+#ifndef __WATCH_MODE_H__
+#define __WATCH_MODE_H__
+
+#include "generatorOptions.h"
+#include "parserContext.h"
+
+/**
+ * @brief Function that runs the generator for one DSL file, reusing the parser context kept between runs.
+ * 
+ * Returns 0 on success and a non-zero value on failure.
+ */
+typedef int (*watch_run_fn_t)(const char *code_file, const char *output_path, const generator_options_t *options, parser_context_t **reused_ctx);
+
+int watch_main(const char *code_file, const char *output_path, watch_run_fn_t run, const generator_options_t *options);
+
+#endif //__WATCH_MODE_H__